@@ -0,0 +1,298 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Audio/GameplayAudioSubsystem.h"
+#include "Sound/SoundBase.h"
+#include "Sound/SoundConcurrency.h"
+#include "Components/AudioComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Play Requests"), STAT_AudioPlayRequests, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Deduplicated"), STAT_AudioDeduplicated, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Throttled"), STAT_AudioThrottled, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Fire Loops Started"), STAT_AudioFireLoopsStarted, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Voices Weapon Fire"), STAT_AudioVoicesWeaponFire, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Voices Impact"), STAT_AudioVoicesImpact, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Voices Explosion"), STAT_AudioVoicesExplosion, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Voices Pickup"), STAT_AudioVoicesPickup, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Voices Equip"), STAT_AudioVoicesEquip, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<float> CVarAudioDeduplicateRadius(
+	TEXT("Arcorox.Audio.DeduplicateRadius"),
+	50.f,
+	TEXT("The same sound requested more than once in a frame within this distance is played once, 0 disables deduplication."),
+	ECVF_Default);
+
+namespace
+{
+	/* Voice cap, resolution rule and deduplication of a category, the retrigger intervals are config properties of the subsystem */
+	struct FGameplaySoundCategorySettings
+	{
+		int32 MaxVoices;
+		EMaxConcurrentResolutionRule::Type ResolutionRule;
+		/* Play identical sounds from one owner or place once per frame, off for weapon fire since several rounds can fire in one frame */
+		bool bDeduplicate;
+	};
+
+	const FGameplaySoundCategorySettings CategorySettings[] =
+	{
+		/* WeaponFire */ { 8, EMaxConcurrentResolutionRule::StopOldest, false },
+		/* Impact */ { 12, EMaxConcurrentResolutionRule::StopFarthestThenOldest, true },
+		/* Explosion */ { 4, EMaxConcurrentResolutionRule::StopOldest, true },
+		/* Pickup */ { 2, EMaxConcurrentResolutionRule::StopOldest, true },
+		/* Equip */ { 2, EMaxConcurrentResolutionRule::StopOldest, true },
+	};
+	static_assert(UE_ARRAY_COUNT(CategorySettings) == static_cast<int32>(EGameplaySoundCategory::MAX), "Every gameplay sound category needs settings");
+
+	void SetVoiceStat(EGameplaySoundCategory Category, int32 NumVoices)
+	{
+		switch (Category)
+		{
+		case EGameplaySoundCategory::WeaponFire:
+			SET_DWORD_STAT(STAT_AudioVoicesWeaponFire, NumVoices);
+			break;
+		case EGameplaySoundCategory::Impact:
+			SET_DWORD_STAT(STAT_AudioVoicesImpact, NumVoices);
+			break;
+		case EGameplaySoundCategory::Explosion:
+			SET_DWORD_STAT(STAT_AudioVoicesExplosion, NumVoices);
+			break;
+		case EGameplaySoundCategory::Pickup:
+			SET_DWORD_STAT(STAT_AudioVoicesPickup, NumVoices);
+			break;
+		case EGameplaySoundCategory::Equip:
+			SET_DWORD_STAT(STAT_AudioVoicesEquip, NumVoices);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void UGameplayAudioSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	//Runtime concurrency objects so the caps live in code next to the rest of the category settings
+	CategoryConcurrency.SetNum(static_cast<int32>(EGameplaySoundCategory::MAX));
+	for (int32 Index = 0; Index < CategoryConcurrency.Num(); Index++)
+	{
+		USoundConcurrency* Concurrency = NewObject<USoundConcurrency>(this);
+		Concurrency->Concurrency.MaxCount = CategorySettings[Index].MaxVoices;
+		Concurrency->Concurrency.ResolutionRule = CategorySettings[Index].ResolutionRule;
+		Concurrency->Concurrency.bLimitToOwner = false;
+		CategoryConcurrency[Index] = Concurrency;
+	}
+}
+
+void UGameplayAudioSubsystem::Deinitialize()
+{
+	for (UAudioComponent* Component : FireLoopComponents)
+	{
+		if (IsValid(Component)) Component->DestroyComponent();
+	}
+	FireLoopComponents.Empty();
+	FireLoops.Empty();
+	for (int32 Index = 0; Index < static_cast<int32>(EGameplaySoundCategory::MAX); Index++)
+	{
+		VoiceEndTimes[Index].Empty();
+		FrameSounds[Index].Empty();
+		LastPlayTimes[Index].Empty();
+		SetVoiceStat(static_cast<EGameplaySoundCategory>(Index), 0);
+	}
+
+	Super::Deinitialize();
+}
+
+void UGameplayAudioSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	for (int32 LoopIndex = FireLoops.Num() - 1; LoopIndex >= 0; LoopIndex--)
+	{
+		FFireLoop& Loop = FireLoops[LoopIndex];
+		UAudioComponent* Component = Loop.Component.Get();
+		if (!Loop.Owner.IsValid() || !IsValid(Component))
+		{
+			if (IsValid(Component)) Component->DestroyComponent();
+			FireLoopComponents.RemoveSingleSwap(Component, false);
+			FireLoops.RemoveAtSwap(LoopIndex, 1, false);
+			continue;
+		}
+		if (Loop.bPlaying && Now >= Loop.StopTime) StopFireLoopAt(LoopIndex);
+	}
+	FireLoopComponents.RemoveAll([](const UAudioComponent* Component) { return !IsValid(Component); });
+	//Owners only need remembering while they are inside the retrigger interval
+	for (int32 Index = 0; Index < static_cast<int32>(EGameplaySoundCategory::MAX); Index++)
+	{
+		const float RetriggerInterval = GetRetriggerInterval(static_cast<EGameplaySoundCategory>(Index));
+		for (auto It = LastPlayTimes[Index].CreateIterator(); It; ++It)
+		{
+			if (Now - It.Value() >= RetriggerInterval) It.RemoveCurrent();
+		}
+	}
+	UpdateVoiceStats(Now);
+}
+
+TStatId UGameplayAudioSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGameplayAudioSubsystem, STATGROUP_Tickables);
+}
+
+bool UGameplayAudioSubsystem::Play2D(USoundBase* Sound, EGameplaySoundCategory Category, const UObject* Owner, bool bIgnoreRetriggerInterval)
+{
+	if (Sound == nullptr) return false;
+	if (!ShouldPlay(Sound, FVector::ZeroVector, Category, Owner, bIgnoreRetriggerInterval)) return false;
+	UGameplayStatics::PlaySound2D(GetWorld(), Sound, 1.f, 1.f, 0.f, CategoryConcurrency[static_cast<int32>(Category)]);
+	TrackVoice(Sound, Category);
+	return true;
+}
+
+bool UGameplayAudioSubsystem::PlayAtLocation(USoundBase* Sound, const FVector& Location, EGameplaySoundCategory Category)
+{
+	if (Sound == nullptr) return false;
+	if (!ShouldPlay(Sound, Location, Category, nullptr, false)) return false;
+	UGameplayStatics::PlaySoundAtLocation(GetWorld(), Sound, Location, 1.f, 1.f, 0.f, nullptr, CategoryConcurrency[static_cast<int32>(Category)]);
+	TrackVoice(Sound, Category);
+	return true;
+}
+
+void UGameplayAudioSubsystem::KeepFireLoopAlive(const UObject* Owner, USoundBase* LoopSound, USoundBase* TailSound, float KeepAliveTime)
+{
+	if (Owner == nullptr || LoopSound == nullptr) return;
+	const double Now = GetWorld()->GetTimeSeconds();
+	FFireLoop* Loop = FireLoops.FindByPredicate([Owner](const FFireLoop& FireLoop) { return FireLoop.Owner.Get() == Owner; });
+	if (Loop == nullptr || !Loop->Component.IsValid())
+	{
+		UAudioComponent* Component = UGameplayStatics::SpawnSound2D(GetWorld(), LoopSound, 1.f, 1.f, 0.f, CategoryConcurrency[static_cast<int32>(EGameplaySoundCategory::WeaponFire)], false, false);
+		if (Component == nullptr) return;
+		FireLoopComponents.Add(Component);
+		if (Loop) Loop->Component = Component;
+		else Loop = &FireLoops.Add_GetRef(FFireLoop{ Owner, Component, nullptr, 0.0, false });
+		Loop->bPlaying = true;
+		INC_DWORD_STAT(STAT_AudioFireLoopsStarted);
+	}
+	else if (!Loop->bPlaying)
+	{
+		UAudioComponent* Component = Loop->Component.Get();
+		if (Component->Sound != LoopSound) Component->SetSound(LoopSound);
+		Component->Play();
+		Loop->bPlaying = true;
+		INC_DWORD_STAT(STAT_AudioFireLoopsStarted);
+	}
+	Loop->TailSound = TailSound;
+	Loop->StopTime = Now + KeepAliveTime;
+}
+
+void UGameplayAudioSubsystem::StopFireLoop(const UObject* Owner)
+{
+	const int32 LoopIndex = FireLoops.IndexOfByPredicate([Owner](const FFireLoop& FireLoop) { return FireLoop.Owner.Get() == Owner; });
+	if (LoopIndex != INDEX_NONE && FireLoops[LoopIndex].bPlaying) StopFireLoopAt(LoopIndex);
+}
+
+bool UGameplayAudioSubsystem::PlaySound2D(const UObject* WorldContextObject, USoundBase* Sound, EGameplaySoundCategory Category, const UObject* Owner, bool bIgnoreRetriggerInterval)
+{
+	if (WorldContextObject == nullptr || Sound == nullptr) return false;
+	UWorld* World = WorldContextObject->GetWorld();
+	if (World == nullptr) return false;
+	if (UGameplayAudioSubsystem* AudioSubsystem = World->GetSubsystem<UGameplayAudioSubsystem>()) return AudioSubsystem->Play2D(Sound, Category, Owner, bIgnoreRetriggerInterval);
+	UGameplayStatics::PlaySound2D(World, Sound);
+	return true;
+}
+
+bool UGameplayAudioSubsystem::PlaySoundAtLocation(const UObject* WorldContextObject, USoundBase* Sound, const FVector& Location, EGameplaySoundCategory Category)
+{
+	if (WorldContextObject == nullptr || Sound == nullptr) return false;
+	UWorld* World = WorldContextObject->GetWorld();
+	if (World == nullptr) return false;
+	if (UGameplayAudioSubsystem* AudioSubsystem = World->GetSubsystem<UGameplayAudioSubsystem>()) return AudioSubsystem->PlayAtLocation(Sound, Location, Category);
+	UGameplayStatics::PlaySoundAtLocation(World, Sound, Location);
+	return true;
+}
+
+bool UGameplayAudioSubsystem::ShouldPlay(USoundBase* Sound, const FVector& Location, EGameplaySoundCategory Category, const UObject* Owner, bool bIgnoreRetriggerInterval)
+{
+	INC_DWORD_STAT(STAT_AudioPlayRequests);
+	const int32 CategoryIndex = static_cast<int32>(Category);
+	const FGameplaySoundCategorySettings& Settings = CategorySettings[CategoryIndex];
+	if (SoundFrame != GFrameCounter)
+	{
+		SoundFrame = GFrameCounter;
+		for (TArray<FFrameSound>& Sounds : FrameSounds) Sounds.Reset();
+	}
+
+	//2D sounds all sit at the origin, so they are told apart by owner
+	const FObjectKey OwnerKey(Owner);
+	const float DeduplicateRadius = CVarAudioDeduplicateRadius.GetValueOnGameThread();
+	if (Settings.bDeduplicate && DeduplicateRadius > 0.f)
+	{
+		for (const FFrameSound& FrameSound : FrameSounds[CategoryIndex])
+		{
+			if (FrameSound.Sound == Sound && FrameSound.Owner == OwnerKey && FVector::DistSquared(FrameSound.Location, Location) <= FMath::Square(DeduplicateRadius))
+			{
+				INC_DWORD_STAT(STAT_AudioDeduplicated);
+				return false;
+			}
+		}
+	}
+
+	const float RetriggerInterval = GetRetriggerInterval(Category);
+	if (RetriggerInterval > 0.f)
+	{
+		const double Now = GetWorld()->GetTimeSeconds();
+		double& LastPlayTime = LastPlayTimes[CategoryIndex].FindOrAdd(OwnerKey, -DBL_MAX);
+		if (!bIgnoreRetriggerInterval && Now - LastPlayTime < RetriggerInterval)
+		{
+			INC_DWORD_STAT(STAT_AudioThrottled);
+			return false;
+		}
+		LastPlayTime = Now;
+	}
+	if (Settings.bDeduplicate) FrameSounds[CategoryIndex].Add(FFrameSound{ Sound, Location, OwnerKey });
+	return true;
+}
+
+float UGameplayAudioSubsystem::GetRetriggerInterval(EGameplaySoundCategory Category) const
+{
+	switch (Category)
+	{
+	case EGameplaySoundCategory::Pickup:
+		return PickupSoundInterval;
+	case EGameplaySoundCategory::Equip:
+		return EquipSoundInterval;
+	default:
+		return 0.f;
+	}
+}
+
+void UGameplayAudioSubsystem::TrackVoice(USoundBase* Sound, EGameplaySoundCategory Category)
+{
+	const float Duration = Sound->GetDuration();
+	if (Duration <= 0.f || Duration >= INDEFINITELY_LOOPING_DURATION) return;
+	TArray<double>& EndTimes = VoiceEndTimes[static_cast<int32>(Category)];
+	//The engine stops voices beyond the cap, the estimate is capped the same way
+	if (EndTimes.Num() >= CategorySettings[static_cast<int32>(Category)].MaxVoices) EndTimes.RemoveAt(0, 1, false);
+	EndTimes.Add(GetWorld()->GetTimeSeconds() + Duration);
+}
+
+void UGameplayAudioSubsystem::StopFireLoopAt(int32 LoopIndex)
+{
+	FFireLoop& Loop = FireLoops[LoopIndex];
+	Loop.bPlaying = false;
+	if (UAudioComponent* Component = Loop.Component.Get()) Component->Stop();
+	if (USoundBase* TailSound = Loop.TailSound.Get()) Play2D(TailSound, EGameplaySoundCategory::WeaponFire, Loop.Owner.Get(), true);
+}
+
+void UGameplayAudioSubsystem::UpdateVoiceStats(double Now)
+{
+	for (int32 Index = 0; Index < static_cast<int32>(EGameplaySoundCategory::MAX); Index++)
+	{
+		TArray<double>& EndTimes = VoiceEndTimes[Index];
+		EndTimes.RemoveAll([Now](double EndTime) { return EndTime <= Now; });
+		SetVoiceStat(static_cast<EGameplaySoundCategory>(Index), EndTimes.Num());
+	}
+}
@@ -6,6 +6,128 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Items/Weapon.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "HAL/IConsoleManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Arcorox Anim Gather (Game Thread)"), STAT_ArcoroxAnimGather, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Arcorox Anim Update"), STAT_ArcoroxAnimUpdate, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<int32> CVarAnimThreadSafeUpdate(
+	TEXT("Arcorox.Anim.ThreadSafeUpdate"),
+	1,
+	TEXT("1 runs the character animation math in the thread safe update on worker threads, 0 runs it on the game thread for comparison."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkAnimUpdateCommand(
+	TEXT("Arcorox.Anim.BenchmarkUpdate"),
+	TEXT("Arcorox.Anim.BenchmarkUpdate [NumCharacters] [NumFrames] - spawns NumCharacters copies of the player character and times the game thread actor tick for NumFrames with Arcorox.Anim.ThreadSafeUpdate 0, then 1."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 NumCharacters = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+		const int32 NumFrames = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 300;
+		UArcoroxAnimInstance::BenchmarkUpdate(World, NumCharacters, NumFrames);
+	}));
+
+namespace
+{
+	/* Frames skipped after spawning and after switching the update mode, so spawning and the switch are not timed */
+	constexpr int32 BenchmarkWarmupFrames = 10;
+
+	/* Spacing of the benchmark characters in front of the player */
+	constexpr float BenchmarkSpacing = 150.f;
+
+	/**
+	 * Times the game thread part of the actor and component tick groups over real frames, which is where the character meshes
+	 * run their animation update, first with the thread safe update off and then with it on.
+	 */
+	class FAnimUpdateBenchmark
+	{
+	public:
+		FAnimUpdateBenchmark(UWorld* InWorld, TArray<TWeakObjectPtr<ACharacter>>&& InCharacters, int32 InNumFrames) :
+			World(InWorld),
+			Characters(MoveTemp(InCharacters)),
+			NumFrames(InNumFrames),
+			PreviousThreadSafeUpdate(CVarAnimThreadSafeUpdate.GetValueOnGameThread())
+		{
+			CVarAnimThreadSafeUpdate->Set(0, ECVF_SetByCode);
+			PreTickHandle = FWorldDelegates::OnWorldPreActorTick.AddRaw(this, &FAnimUpdateBenchmark::OnPreActorTick);
+			PostTickHandle = FWorldDelegates::OnWorldPostActorTick.AddRaw(this, &FAnimUpdateBenchmark::OnPostActorTick);
+		}
+
+		~FAnimUpdateBenchmark()
+		{
+			Finish();
+		}
+
+	private:
+		void OnPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+		{
+			if (InWorld != World.Get()) return;
+			//Characters keep turning so turn in place and lean have work to do
+			const FRotator Rotation(0.f, Frame * 2.f, 0.f);
+			for (const TWeakObjectPtr<ACharacter>& Character : Characters)
+			{
+				if (Character.IsValid()) Character->SetActorRotation(Rotation);
+			}
+			TickStartTime = FPlatformTime::Seconds();
+		}
+
+		void OnPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+		{
+			if (InWorld != World.Get()) return;
+			const double TickSeconds = FPlatformTime::Seconds() - TickStartTime;
+			const int32 PhaseFrame = Frame++ % (BenchmarkWarmupFrames + NumFrames);
+			const bool bThreadSafePhase = Frame > BenchmarkWarmupFrames + NumFrames;
+			if (PhaseFrame >= BenchmarkWarmupFrames) PhaseSeconds[bThreadSafePhase] += TickSeconds;
+			if (PhaseFrame < BenchmarkWarmupFrames + NumFrames - 1) return;
+
+			if (!bThreadSafePhase)
+			{
+				CVarAnimThreadSafeUpdate->Set(1, ECVF_SetByCode);
+				return;
+			}
+			UE_LOG(LogArcorox, Log, TEXT("Anim update, %d characters over %d frames: game thread actor tick %.4f ms/frame with Arcorox.Anim.ThreadSafeUpdate 0, %.4f ms/frame with 1"),
+				Characters.Num(), NumFrames, PhaseSeconds[0] * 1000.0 / NumFrames, PhaseSeconds[1] * 1000.0 / NumFrames);
+			Finish();
+		}
+
+		/* Stops timing, destroys the characters and restores the update mode, safe to call more than once */
+		void Finish()
+		{
+			if (!PreTickHandle.IsValid()) return;
+			FWorldDelegates::OnWorldPreActorTick.Remove(PreTickHandle);
+			FWorldDelegates::OnWorldPostActorTick.Remove(PostTickHandle);
+			PreTickHandle.Reset();
+			PostTickHandle.Reset();
+			for (const TWeakObjectPtr<ACharacter>& Character : Characters)
+			{
+				if (!Character.IsValid()) continue;
+				if (AController* Controller = Character->GetController()) Controller->Destroy();
+				Character->Destroy();
+			}
+			Characters.Reset();
+			CVarAnimThreadSafeUpdate->Set(PreviousThreadSafeUpdate, ECVF_SetByCode);
+		}
+
+		TWeakObjectPtr<UWorld> World;
+		TArray<TWeakObjectPtr<ACharacter>> Characters;
+		int32 NumFrames;
+		int32 PreviousThreadSafeUpdate;
+		int32 Frame = 0;
+		double TickStartTime = 0.0;
+
+		/* Timed game thread seconds with the thread safe update off and on */
+		double PhaseSeconds[2] = {};
+
+		FDelegateHandle PreTickHandle;
+		FDelegateHandle PostTickHandle;
+	};
+
+	TUniquePtr<FAnimUpdateBenchmark> ActiveBenchmark;
+}
 
 UArcoroxAnimInstance::UArcoroxAnimInstance() :
 	Speed(0.f),
@@ -49,30 +171,66 @@ void UArcoroxAnimInstance::NativeUpdateAnimation(float DeltaTime)
 {
 	Super::NativeUpdateAnimation(DeltaTime);
 
-	if (ArcoroxCharacter && ArcoroxCharacterMovement)
+	GatherSnapshot();
+	if (!CVarAnimThreadSafeUpdate.GetValueOnGameThread()) UpdateFromSnapshot(DeltaTime);
+}
+
+void UArcoroxAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaTime)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaTime);
+
+	if (CVarAnimThreadSafeUpdate.GetValueOnAnyThread()) UpdateFromSnapshot(DeltaTime);
+}
+
+void UArcoroxAnimInstance::GatherSnapshot()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ArcoroxAnimGather);
+	Snapshot.bValid = ArcoroxCharacter && ArcoroxCharacterMovement;
+	if (!Snapshot.bValid) return;
+
+	Snapshot.Velocity = ArcoroxCharacter->GetVelocity();
+	Snapshot.AimRotation = ArcoroxCharacter->GetBaseAimRotation();
+	Snapshot.ActorRotation = ArcoroxCharacter->GetActorRotation();
+	Snapshot.bIsFalling = ArcoroxCharacterMovement->IsFalling();
+	Snapshot.bIsAccelerating = ArcoroxCharacterMovement->GetCurrentAcceleration().SizeSquared() > 0.f;
+	Snapshot.bCrouching = ArcoroxCharacter->IsCrouching();
+	Snapshot.bAiming = ArcoroxCharacter->IsAiming();
+	const ECombatState CombatState = ArcoroxCharacter->GetCombatState();
+	Snapshot.bReloading = CombatState == ECombatState::ECS_Reloading;
+	Snapshot.bEquipping = CombatState == ECombatState::ECS_Equipping;
+	Snapshot.bShouldUseFABRIK = CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_Firing;
+	Snapshot.bHasEquippedWeapon = ArcoroxCharacter->GetEquippedWeapon() != nullptr;
+	if (Snapshot.bHasEquippedWeapon) Snapshot.EquippedWeaponType = ArcoroxCharacter->GetEquippedWeapon()->GetWeaponType();
+	//Curves are read here with the rest of the game thread state rather than from the worker
+	Snapshot.TurningCurve = GetCurveValue(TEXT("Turning"));
+	Snapshot.RotationCurve = GetCurveValue(TEXT("Rotation"));
+}
+
+void UArcoroxAnimInstance::UpdateFromSnapshot(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ArcoroxAnimUpdate);
+	if (Snapshot.bValid)
 	{
-		Speed = UKismetMathLibrary::VSizeXY(ArcoroxCharacterMovement->Velocity);
-		bIsFalling = ArcoroxCharacterMovement->IsFalling();
-		bIsAccelerating = ArcoroxCharacterMovement->GetCurrentAcceleration().Size() > 0.f;
-		bCrouching = ArcoroxCharacter->IsCrouching();
-		ECombatState CombatState = ArcoroxCharacter->GetCombatState();
-		bShouldUseFABRIK = CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_Firing;
-
-		FRotator AimRotation = ArcoroxCharacter->GetBaseAimRotation();
-		FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX(ArcoroxCharacter->GetVelocity());
-		MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, AimRotation).Yaw;
-		if (ArcoroxCharacter->GetVelocity().Size() > 0) LastMovementOffsetYaw = MovementOffsetYaw;
-
-		bReloading = CombatState == ECombatState::ECS_Reloading;
-		bAiming = ArcoroxCharacter->IsAiming();
-		bEquipping = CombatState == ECombatState::ECS_Equipping;
+		Speed = Snapshot.Velocity.Size2D();
+		bIsFalling = Snapshot.bIsFalling;
+		bIsAccelerating = Snapshot.bIsAccelerating;
+		bCrouching = Snapshot.bCrouching;
+		bShouldUseFABRIK = Snapshot.bShouldUseFABRIK;
+
+		const FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX(Snapshot.Velocity);
+		MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, Snapshot.AimRotation).Yaw;
+		if (Snapshot.Velocity.Size() > 0) LastMovementOffsetYaw = MovementOffsetYaw;
+
+		bReloading = Snapshot.bReloading;
+		bAiming = Snapshot.bAiming;
+		bEquipping = Snapshot.bEquipping;
 
 		if (bReloading) OffsetState = EOffsetState::EOS_Reloading;
 		else if (bIsFalling) OffsetState = EOffsetState::EOS_InAir;
 		else if (bAiming) OffsetState = EOffsetState::EOS_Aiming;
 		else OffsetState = EOffsetState::EOS_Hip;
 
-		if (ArcoroxCharacter->GetEquippedWeapon()) EquippedWeaponType = ArcoroxCharacter->GetEquippedWeapon()->GetWeaponType();
+		if (Snapshot.bHasEquippedWeapon) EquippedWeaponType = Snapshot.EquippedWeaponType;
 	}
 	TurnInPlace();
 	Lean(DeltaTime);
@@ -80,12 +238,12 @@ void UArcoroxAnimInstance::NativeUpdateAnimation(float DeltaTime)
 
 void UArcoroxAnimInstance::TurnInPlace()
 {
-	if (ArcoroxCharacter == nullptr || ArcoroxCharacterMovement == nullptr) return;
-	Pitch = ArcoroxCharacter->GetBaseAimRotation().Pitch;
+	if (!Snapshot.bValid) return;
+	Pitch = Snapshot.AimRotation.Pitch;
 	if (Speed > 0 || bIsFalling)
 	{
 		RootYawOffset = 0.f;
-		TIPCharacterRotationYaw = ArcoroxCharacter->GetActorRotation().Yaw;
+		TIPCharacterRotationYaw = Snapshot.ActorRotation.Yaw;
 		TIPCharacterRotationYawLastFrame = TIPCharacterRotationYaw;
 		RotationCurveLastFrame = 0.f;
 		RotationCurve = 0.f;
@@ -93,16 +251,16 @@ void UArcoroxAnimInstance::TurnInPlace()
 	else
 	{
 		TIPCharacterRotationYawLastFrame = TIPCharacterRotationYaw;
-		TIPCharacterRotationYaw = ArcoroxCharacter->GetActorRotation().Yaw;
+		TIPCharacterRotationYaw = Snapshot.ActorRotation.Yaw;
 		const float TIPDeltaYaw{ TIPCharacterRotationYaw - TIPCharacterRotationYawLastFrame };
 		//Clamp RootYawOffset between [-180, 180]
 		RootYawOffset = UKismetMathLibrary::NormalizeAxis(RootYawOffset - TIPDeltaYaw);
-		const float Turning{ GetCurveValue(TEXT("Turning")) };
+		const float Turning{ Snapshot.TurningCurve };
 		if (Turning > 0)
 		{
 			bTurningInPlace = true;
 			RotationCurveLastFrame = RotationCurve;
-			RotationCurve = GetCurveValue(TEXT("Rotation"));
+			RotationCurve = Snapshot.RotationCurve;
 			const float DeltaRotation{ RotationCurve - RotationCurveLastFrame };
 			//RootYawOffset > 0  Turning Left, otherwise  Turning Right
 			RootYawOffset > 0 ? RootYawOffset -= DeltaRotation : RootYawOffset += DeltaRotation;
@@ -120,13 +278,16 @@ void UArcoroxAnimInstance::TurnInPlace()
 
 void UArcoroxAnimInstance::Lean(float DeltaTime)
 {
-	if (ArcoroxCharacter == nullptr || ArcoroxCharacterMovement == nullptr) return;
+	if (!Snapshot.bValid) return;
 	CharacterRotationLastFrame = CharacterRotation;
-	CharacterRotation = ArcoroxCharacter->GetActorRotation();
+	CharacterRotation = Snapshot.ActorRotation;
 	const FRotator DeltaRotation{ UKismetMathLibrary::NormalizedDeltaRotator(CharacterRotation, CharacterRotationLastFrame) };
 	const float Target = DeltaRotation.Yaw / DeltaTime;
-	const float Interpolation{ FMath::FInterpTo<float>(DeltaYaw, Target, DeltaTime, 1.f) };
-	DeltaYaw = FMath::Clamp(Interpolation, -85.f, 85.f);
+	//Eased in fixed steps so the lean does not depend on the frame rate
+	LeanSmoothing.SetTarget(Target, 1.f);
+	const int32 NumSteps = LeanClock.Advance(DeltaTime);
+	for (int32 i = 0; i < NumSteps; i++) LeanSmoothing.Step(FFixedStepClock::GetFixedStep());
+	DeltaYaw = FMath::Clamp(LeanSmoothing.Sample(LeanClock.GetAlpha()), -85.f, 85.f);
 }
 
 void UArcoroxAnimInstance::SetRecoilScale()
@@ -150,3 +311,30 @@ void UArcoroxAnimInstance::SetRecoilScale()
 		}
 	}
 }
+
+void UArcoroxAnimInstance::BenchmarkUpdate(UWorld* World, int32 NumCharacters, int32 NumFrames)
+{
+	//A benchmark still running is cut short and cleans up its characters first
+	ActiveBenchmark.Reset();
+	const APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	const APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	if (PlayerPawn == nullptr || !PlayerPawn->IsA<ACharacter>()) return;
+
+	//Copies of the player character in a grid in front of it, always updating so the measured work does not depend on the view
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	const int32 Columns = FMath::CeilToInt32(FMath::Sqrt(static_cast<float>(NumCharacters)));
+	const FVector Forward = PlayerPawn->GetActorForwardVector();
+	const FVector Right = PlayerPawn->GetActorRightVector();
+	TArray<TWeakObjectPtr<ACharacter>> Characters;
+	for (int32 i = 0; i < NumCharacters; i++)
+	{
+		const FVector Location = PlayerPawn->GetActorLocation() + Forward * (2.f + i / Columns) * BenchmarkSpacing + Right * (i % Columns - Columns / 2) * BenchmarkSpacing;
+		ACharacter* Character = World->SpawnActor<ACharacter>(PlayerPawn->GetClass(), Location, PlayerPawn->GetActorRotation(), SpawnParams);
+		if (Character == nullptr) continue;
+		Character->GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPose;
+		Characters.Add(Character);
+	}
+	UE_LOG(LogArcorox, Log, TEXT("Anim update: timing %d characters for %d frames with the thread safe update off, then on"), Characters.Num(), NumFrames);
+	ActiveBenchmark = MakeUnique<FAnimUpdateBenchmark>(World, MoveTemp(Characters), NumFrames);
+}
@@ -2,6 +2,9 @@
 
 
 #include "Characters/ArcoroxCharacter.h"
+#include "Characters/SmoothedValueComponent.h"
+#include "Items/InventoryComponent.h"
+#include "HUD/InventoryViewModel.h"
 #include "Items/Item.h"
 #include "Items/Weapon.h"
 #include "Items/Ammo.h"
@@ -11,14 +14,44 @@
 #include "GameFramework/SpringArmComponent.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/BoxComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Engine/SkeletalMeshSocket.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Animation/AnimMontage.h"
 #include "Kismet/GameplayStatics.h"
 #include "PhysicalMaterials/PhysicalMaterial.h"
+#include "HAL/IConsoleManager.h"
 #include "Arcorox/Arcorox.h"
 #include "Enemy/Enemy.h"
+#include "Combat/HitscanSubsystem.h"
+#include "Combat/DamageQueueSubsystem.h"
+#include "Pooling/ActorPoolSubsystem.h"
+#include "FX/FXSubsystem.h"
+#include "Audio/GameplayAudioSubsystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair Ray Cache Hits"), STAT_CrosshairRayCacheHits, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair Ray Cache Misses"), STAT_CrosshairRayCacheMisses, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair Trace Cache Hits"), STAT_CrosshairTraceCacheHits, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair Trace Cache Misses"), STAT_CrosshairTraceCacheMisses, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Aimed Item Candidates"), STAT_AimedItemCandidates, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Aimed Item Tie Traces"), STAT_AimedItemTieTraces, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Aimed Item Occlusion Traces"), STAT_AimedItemOcclusionTraces, STATGROUP_Arcorox);
+
+namespace
+{
+	/* Candidates this close in angle to the best one are decided by the crosshair trace */
+	constexpr double AimedItemTieDegrees = 2.0;
+
+	/* Seconds before the view of the same aimed item is traced again */
+	constexpr double AimedItemOcclusionInterval = 0.25;
+}
+
+static TAutoConsoleVariable<bool> CVarInventoryDelegates(
+	TEXT("Arcorox.HUD.InventoryDelegates"),
+	true,
+	TEXT("Also publish inventory view updates through EquipItemDelegate and HighlightIconDelegate, once per frame, for widgets not yet derived from UInventoryBarWidget."),
+	ECVF_Default);
 
 AArcoroxCharacter::AArcoroxCharacter() :
 	//Is Aiming
@@ -40,14 +73,17 @@ AArcoroxCharacter::AArcoroxCharacter() :
 	CrosshairAimFactor(0.f),
 	CrosshairShootingFactor(0.f),
 	ShootTimeDuration(0.05f),
-	bFiringWeapon(false),
+	CrosshairShootEndTime(0.0),
 	//Automatic weapon fire
 	bShouldFire(true),
 	bFireButtonPressed(false),
-	bShouldTraceForItems(false),
 	//Camera interp location variables
 	CameraInterpDistance(200.f),
 	CameraInterpElevation(50.f),
+	//Aimed item occlusion
+	OcclusionCheckedItem(nullptr),
+	bAimedItemOccluded(false),
+	NextOcclusionCheckTime(0.0),
 	//Default ammo amounts
 	Starting9mmAmmo(120),
 	Starting556Ammo(90),
@@ -64,11 +100,6 @@ AArcoroxCharacter::AArcoroxCharacter() :
 	//Ground friction
 	DefaultGroundFriction(2.f),
 	CrouchingGroundFriction(100.f),
-	//Sound timer properties
-	bShouldPlayPickupSound(true),
-	bShouldPlayEquipSound(true),
-	PickupSoundTime(0.2f),
-	EquipSoundTime(0.2f),
 	//Highlight Icon animation property
 	HighlightedInventorySlot(-1),
 	//Health
@@ -99,6 +130,12 @@ AArcoroxCharacter::AArcoroxCharacter() :
 
 	HandSceneComponent = CreateDefaultSubobject<USceneComponent>(TEXT("HandSceneComponent"));
 
+	SmoothedValues = CreateDefaultSubobject<USmoothedValueComponent>(TEXT("SmoothedValues"));
+
+	InventoryComponent = CreateDefaultSubobject<UInventoryComponent>(TEXT("InventoryComponent"));
+
+	InventoryViewModel = CreateDefaultSubobject<UInventoryViewModel>(TEXT("InventoryViewModel"));
+
 	WeaponInterpComp = CreateDefaultSubobject<USceneComponent>(TEXT("Weapon Interpolation Component"));
 	WeaponInterpComp->SetupAttachment(GetCamera());
 	InterpComp1 = CreateDefaultSubobject<USceneComponent>(TEXT("Interpolation Component 1"));
@@ -128,13 +165,13 @@ void AArcoroxCharacter::BeginPlay()
 		CameraDefaultFOV = GetCamera()->FieldOfView;
 		CameraCurrentFOV = CameraDefaultFOV;
 	}
+	InitializeSmoothedValues();
 
 	if (GetCharacterMovement()) GetCharacterMovement()->MaxWalkSpeed = DefaultMovementSpeed;
 	EquipWeapon(SpawnDefaultWeapon());
 	if (EquippedWeapon)
 	{
-		Inventory.Add(EquippedWeapon);
-		EquippedWeapon->SetInventorySlotIndex(0);
+		UpdateInventoryMirror(InventoryComponent->AddItem(EquippedWeapon));
 		EquippedWeapon->SetArcoroxCharacter(this);
 		EquippedWeapon->DisableGlowMaterial();
 		EquippedWeapon->DisableCustomDepth();
@@ -143,15 +180,35 @@ void AArcoroxCharacter::BeginPlay()
 	InitializeInterpLocations();
 }
 
+void AArcoroxCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	//The next character's SpawnDefaultWeapon reuses the weapons this one carried
+	if (EndPlayReason == EEndPlayReason::Destroyed && InventoryComponent)
+	{
+		const TArray<AItem*> Carried = InventoryComponent->GetSlots();
+		for (AItem* Item : Carried)
+		{
+			if (AWeapon* Weapon = Cast<AWeapon>(Item)) UActorPoolSubsystem::ReleaseOrDestroy(Weapon);
+		}
+	}
+	EquippedWeapon = nullptr;
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AArcoroxCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	CameraZoomInterpolation(DeltaTime);
+	CameraZoomInterpolation();
 	SetLookScale();
-	CalculateCrosshairSpread(DeltaTime);
+	UpdateAutoFire();
+	SetCrosshairSpreadTargets();
+	InterpolateCapsuleHalfHeight();
+	if (SmoothedValues) SmoothedValues->Integrate(DeltaTime);
+	CalculateCrosshairSpread();
 	ItemTrace();
-	InterpolateCapsuleHalfHeight(DeltaTime);
+	PublishInventoryView();
 }
 
 void AArcoroxCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -211,10 +268,14 @@ float AArcoroxCharacter::TakeDamage(float DamageAmount, FDamageEvent const& Dama
 	return DamageAmount;
 }
 
-void AArcoroxCharacter::IncrementOverlappedItemCount(int8 Amount)
+void AArcoroxCharacter::AddOverlappingItem(AItem* Item)
+{
+	if (Item) OverlappingItems.AddUnique(Item);
+}
+
+void AArcoroxCharacter::RemoveOverlappingItem(AItem* Item)
 {
-	OverlappedItemCount += Amount;
-	bShouldTraceForItems = OverlappedItemCount > 0;
+	OverlappingItems.RemoveSingleSwap(Item, false);
 }
 
 void AArcoroxCharacter::GetPickupItem(AItem* Item)
@@ -223,10 +284,10 @@ void AArcoroxCharacter::GetPickupItem(AItem* Item)
 	auto Weapon = Cast<AWeapon>(Item);
 	if (Weapon)
 	{
-		if (Inventory.Num() < InventoryCapacity)
+		const int32 Slot = InventoryComponent->AddItem(Weapon);
+		if (Slot != INDEX_NONE)
 		{
-			Inventory.Add(Weapon);
-			Weapon->SetInventorySlotIndex(Inventory.Num() - 1);
+			UpdateInventoryMirror(Slot);
 			Weapon->SetItemState(EItemState::EIS_PickedUp);
 		}
 		else SwapWeapon(Weapon);
@@ -251,16 +312,9 @@ void AArcoroxCharacter::DecrementInterpLocationItemCount(int32 Index)
 	if (InterpLocations.Num() >= Index) InterpLocations[Index].ItemCount--;
 }
 
-void AArcoroxCharacter::StartPickupSoundTimer()
+const FBakedCrosshairSpread& AArcoroxCharacter::GetCrosshairSpreadProfile() const
 {
-	bShouldPlayPickupSound = false;
-	GetWorldTimerManager().SetTimer(PickupSoundTimer, this, &AArcoroxCharacter::ResetPickupSoundTimer, PickupSoundTime);
-}
-
-void AArcoroxCharacter::StartEquipSoundTimer()
-{
-	bShouldPlayEquipSound = false;
-	GetWorldTimerManager().SetTimer(EquipSoundTimer, this, &AArcoroxCharacter::ResetEquipSoundTimer, EquipSoundTime);
+	return EquippedWeapon ? EquippedWeapon->GetCrosshairSpread() : FBakedCrosshairSpread::GetDefault();
 }
 
 float AArcoroxCharacter::GetCrosshairSpreadMultiplier() const
@@ -270,12 +324,12 @@ float AArcoroxCharacter::GetCrosshairSpreadMultiplier() const
 
 void AArcoroxCharacter::PlayMeleeImpactSound()
 {
-	if (MeleeImpactSound) UGameplayStatics::PlaySoundAtLocation(this, MeleeImpactSound, GetActorLocation());
+	UGameplayAudioSubsystem::PlaySoundAtLocation(this, MeleeImpactSound, GetActorLocation(), EGameplaySoundCategory::Impact);
 }
 
 void AArcoroxCharacter::SpawnBloodParticles(const FTransform& SocketTransform)
 {
-	if (BloodParticles) UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BloodParticles, SocketTransform);
+	if (BloodParticles) UFXSubsystem::SpawnEmitterAtLocation(this, BloodParticles, SocketTransform, EFXPriority::Budgeted);
 }
 
 void AArcoroxCharacter::Move(const FInputActionValue& Value)
@@ -305,19 +359,51 @@ void AArcoroxCharacter::Look(const FInputActionValue& Value)
 
 void AArcoroxCharacter::FireWeapon()
 {
-	if (EquippedWeapon == nullptr || CombatState != ECombatState::ECS_Unoccupied) return;
+	//A weapon still streaming its mesh and sounds can be equipped but not fired
+	if (EquippedWeapon == nullptr || !EquippedWeapon->HasWeaponAssets() || CombatState != ECombatState::ECS_Unoccupied) return;
 	if (WeaponHasAmmo())
 	{
-		PlayFireSound();
-		SendBullet();
-		PlayGunfireMontage();
-		StartCrosshairShootTimer();
-		EquippedWeapon->DecrementAmmo();
-		StartAutoFireTimer();
-		if (EquippedWeapon->GetWeaponType() == EWeaponType::EWT_Pistol) EquippedWeapon->StartPistolSlideTimer();
+		const double Now = GetWorld()->GetTimeSeconds();
+		if (!FireScheduler.StartFiring(Now, EquippedWeapon->GetFireRate())) return;
+		CombatState = ECombatState::ECS_Firing;
+		FireShot(Now);
 	}
 }
 
+void AArcoroxCharacter::FireShot(double ShotTime)
+{
+	PlayFireSound();
+	SendBullet();
+	PlayGunfireMontage();
+	CrosshairShootEndTime = FMath::Max(CrosshairShootEndTime, ShotTime + ShootTimeDuration);
+	EquippedWeapon->DecrementAmmo();
+	if (EquippedWeapon->GetWeaponType() == EWeaponType::EWT_Pistol) EquippedWeapon->StartPistolSlide(ShotTime);
+}
+
+void AArcoroxCharacter::UpdateAutoFire()
+{
+	if (CombatState != ECombatState::ECS_Firing) return;
+	if (EquippedWeapon == nullptr)
+	{
+		FireScheduler.Reset();
+		CombatState = ECombatState::ECS_Unoccupied;
+		return;
+	}
+
+	//Rounds keep their own timestamps so a long frame fires every round that fell due within it
+	const double Now = GetWorld()->GetTimeSeconds();
+	const float FireRate = EquippedWeapon->GetFireRate();
+	const bool bTriggerHeld = bFireButtonPressed && EquippedWeapon->IsWeaponAutomatic();
+	double ShotTime = 0.0;
+	const int32 NumShots = FireScheduler.Advance(Now, FireRate, bTriggerHeld, EquippedWeapon->GetAmmo(), ShotTime);
+	for (int32 i = 0; i < NumShots; i++, ShotTime += FireRate) FireShot(ShotTime);
+
+	if (FireScheduler.IsCycling(Now)) return;
+	FireScheduler.StopFiring();
+	CombatState = ECombatState::ECS_Unoccupied;
+	if (!WeaponHasAmmo()) ReloadWeapon();
+}
+
 void AArcoroxCharacter::ReloadWeapon()
 {
 	if (EquippedWeapon == nullptr || CombatState != ECombatState::ECS_Unoccupied) return;
@@ -338,6 +424,7 @@ void AArcoroxCharacter::FireButtonPressed()
 void AArcoroxCharacter::FireButtonReleased()
 {
 	bFireButtonPressed = false;
+	if (UGameplayAudioSubsystem* AudioSubsystem = GetWorld()->GetSubsystem<UGameplayAudioSubsystem>()) AudioSubsystem->StopFireLoop(this);
 }
 
 void AArcoroxCharacter::AimButtonPressed()
@@ -430,74 +517,69 @@ void AArcoroxCharacter::FiveKeyPressed()
 	ExchangeInventoryItems(EquippedWeapon->GetInventorySlotIndex(), 5);
 }
 
-bool AArcoroxCharacter::GetBeamEndLocation(const FVector& BarrelSocketLocation, FHitResult& OutHit)
+void AArcoroxCharacter::SendBullet()
 {
-	FVector OutBeamLocation;
-	//Check for crosshair trace hit
-	FHitResult CrosshairHitResult;
-	if (CrosshairLineTrace(CrosshairHitResult, OutBeamLocation))
-	{
-		OutBeamLocation = CrosshairHitResult.Location;
-	}
-	//Perform line trace from weapon barrel
-	const FVector WeaponTraceStart{ BarrelSocketLocation };
-	const FVector StartToEnd{ OutBeamLocation - BarrelSocketLocation };
-	const FVector WeaponTraceEnd{ BarrelSocketLocation + StartToEnd * 1.25f };
-	GetWorld()->LineTraceSingleByChannel(OutHit, WeaponTraceStart, WeaponTraceEnd, ECollisionChannel::ECC_Visibility);
-	if (!OutHit.bBlockingHit) //No object between weapon barrel and beam end point?
+	const USkeletalMeshSocket* BarrelSocket = EquippedWeapon->GetItemMesh()->GetSocketByName("BarrelSocket");
+	UHitscanSubsystem* HitscanSubsystem = GetWorld()->GetSubsystem<UHitscanSubsystem>();
+	if (BarrelSocket && HitscanSubsystem)
 	{
-		OutHit.Location = OutBeamLocation;
-		return false;
+		FHitscanShot Shot;
+		Shot.BarrelTransform = BarrelSocket->GetSocketTransform(EquippedWeapon->GetItemMesh());
+		SpawnMuzzleFlash(Shot.BarrelTransform);
+		if (!GetCrosshairTraceSegment(Shot.CrosshairStart, Shot.CrosshairEnd))
+		{
+			//No crosshair deprojection, shoot straight out of the barrel
+			Shot.CrosshairStart = Shot.BarrelTransform.GetLocation();
+			Shot.CrosshairEnd = Shot.CrosshairStart + Shot.BarrelTransform.GetRotation().GetForwardVector() * 50000;
+		}
+		else if (CrosshairQueryCache.bTraced)
+		{
+			//Reuse this frame's crosshair trace from item tracing
+			Shot.CrosshairHit = CrosshairQueryCache.Hit;
+			Shot.bHasCrosshairHit = true;
+		}
+		//Damage is captured now since the weapon may be swapped before the shot resolves
+		HitscanSubsystem->QueueShot(Shot, FOnHitscanResolved::CreateUObject(this, &AArcoroxCharacter::BulletResolved, EquippedWeapon->GetDamage(), EquippedWeapon->GetHeadshotMultiplier()));
 	}
-	return true;
 }
 
-void AArcoroxCharacter::SendBullet()
+void AArcoroxCharacter::BulletResolved(const FHitscanResult& Result, float Damage, float HeadshotMultiplier)
 {
-	const USkeletalMeshSocket* BarrelSocket = EquippedWeapon->GetItemMesh()->GetSocketByName("BarrelSocket");
-	if (BarrelSocket)
+	if (!Result.bBlockingHit) return;
+	const FHitResult& BeamHitResult = Result.Hit;
+	if (BeamHitResult.GetActor())
 	{
-		const FTransform SocketTransform = BarrelSocket->GetSocketTransform(EquippedWeapon->GetItemMesh());
-		FHitResult BeamHitResult;
-		SpawnMuzzleFlash(SocketTransform);
-		if (GetBeamEndLocation(SocketTransform.GetLocation(), BeamHitResult))
+		//Does the hit Actor implement the HitInterface
+		IHitInterface* HitInterface = Cast<IHitInterface>(BeamHitResult.GetActor());
+		if (HitInterface) HitInterface->Hit_Implementation(BeamHitResult);
+		else
+		{
+			SpawnImpactParticles(BeamHitResult.Location);
+			SpawnBeamParticles(Result.BarrelTransform, BeamHitResult.Location);
+		}
+		//Is the hit Actor an Enemy
+		AEnemy* Enemy = Cast<AEnemy>(BeamHitResult.GetActor());
+		if (Enemy)
 		{
-			if (BeamHitResult.GetActor())
+			bool bHeadshot = false;
+			if (BeamHitResult.BoneName.ToString().Equals(Enemy->GetHeadBone()))
 			{
-				//Does the hit Actor implement the HitInterface
-				IHitInterface* HitInterface = Cast<IHitInterface>(BeamHitResult.GetActor());
-				if (HitInterface) HitInterface->Hit_Implementation(BeamHitResult);
-				else
-				{
-					SpawnImpactParticles(BeamHitResult.Location);
-					SpawnBeamParticles(SocketTransform, BeamHitResult.Location);
-				}
-				//Is the hit Actor an Enemy
-				AEnemy* Enemy = Cast<AEnemy>(BeamHitResult.GetActor());
-				if (Enemy)
-				{
-					float Damage = EquippedWeapon->GetDamage();
-					bool bHeadshot = false;
-					if (BeamHitResult.BoneName.ToString().Equals(Enemy->GetHeadBone()))
-					{
-						bHeadshot = true;
-						Damage *= EquippedWeapon->GetHeadshotMultiplier();
-					}
-					UGameplayStatics::ApplyDamage(BeamHitResult.GetActor(), Damage, GetController(), this, UDamageType::StaticClass());
-					Enemy->ShowHitDamage(Damage, BeamHitResult.Location, bHeadshot);
-				}
+				bHeadshot = true;
+				Damage *= HeadshotMultiplier;
 			}
+			UDamageQueueSubsystem::QueueDamage(this, Enemy, Damage, GetController(), this, BeamHitResult.Location, bHeadshot, true);
 		}
 	}
 }
 
 void AArcoroxCharacter::ExchangeInventoryItems(int32 CurrentSlotIndex, int32 TargetSlotIndex)
 {
-	const bool CannotExchangeItems = ((CombatState != ECombatState::ECS_Unoccupied && CombatState != ECombatState::ECS_Equipping) || EquippedWeapon == nullptr || CurrentSlotIndex == TargetSlotIndex || TargetSlotIndex >= Inventory.Num());
+	const bool CannotExchangeItems = ((CombatState != ECombatState::ECS_Unoccupied && CombatState != ECombatState::ECS_Equipping) || EquippedWeapon == nullptr || CurrentSlotIndex == TargetSlotIndex);
 	if (CannotExchangeItems) return;
+	AWeapon* NewEquippedWeapon = Cast<AWeapon>(InventoryComponent->GetItemAt(TargetSlotIndex));
+	if (NewEquippedWeapon == nullptr) return;
 	if (bAiming) StopAiming();
 	AWeapon* CurrentEquippedWeapon = EquippedWeapon;
-	AWeapon* NewEquippedWeapon = Cast<AWeapon>(Inventory[TargetSlotIndex]);
 	EquipWeapon(NewEquippedWeapon);
 	NewEquippedWeapon->ForcePlayEquipSound();
 	CurrentEquippedWeapon->SetItemState(EItemState::EIS_PickedUp);
@@ -505,8 +587,17 @@ void AArcoroxCharacter::ExchangeInventoryItems(int32 CurrentSlotIndex, int32 Tar
 	PlayEquipMontage();
 }
 
-bool AArcoroxCharacter::CrosshairLineTrace(FHitResult& OutHit, FVector& OutHitLocation)
+void AArcoroxCharacter::RefreshCrosshairQueryCache()
 {
+	if (CrosshairQueryCache.Frame == GFrameCounter)
+	{
+		INC_DWORD_STAT(STAT_CrosshairRayCacheHits);
+		return;
+	}
+	INC_DWORD_STAT(STAT_CrosshairRayCacheMisses);
+	CrosshairQueryCache.Frame = GFrameCounter;
+	CrosshairQueryCache.bTraced = false;
+	CrosshairQueryCache.Hit.Reset();
 	//Get size of viewport
 	FVector2D ViewportSize;
 	if (GEngine && GEngine->GameViewport) GEngine->GameViewport->GetViewportSize(ViewportSize);
@@ -514,14 +605,38 @@ bool AArcoroxCharacter::CrosshairLineTrace(FHitResult& OutHit, FVector& OutHitLo
 	FVector2D CrosshairLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
 	FVector CrosshairWorldPosition, CrosshairWorldDirection;
 	//Get crosshairs world position and direction
-	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0), CrosshairLocation, CrosshairWorldPosition, CrosshairWorldDirection);
-	if (bScreenToWorld) //was deprojection successful
+	CrosshairQueryCache.bRayValid = UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0), CrosshairLocation, CrosshairWorldPosition, CrosshairWorldDirection);
+	if (CrosshairQueryCache.bRayValid) //was deprojection successful
+	{
+		CrosshairQueryCache.Start = CrosshairWorldPosition;
+		CrosshairQueryCache.End = CrosshairWorldPosition + CrosshairWorldDirection * 50000;
+	}
+}
+
+bool AArcoroxCharacter::GetCrosshairTraceSegment(FVector& OutStart, FVector& OutEnd)
+{
+	RefreshCrosshairQueryCache();
+	if (!CrosshairQueryCache.bRayValid) return false;
+	OutStart = CrosshairQueryCache.Start;
+	OutEnd = CrosshairQueryCache.End;
+	return true;
+}
+
+bool AArcoroxCharacter::CrosshairLineTrace(FHitResult& OutHit, FVector& OutHitLocation)
+{
+	FVector Start, End;
+	if (GetCrosshairTraceSegment(Start, End))
 	{
 		//Trace outward from crosshair location
-		const FVector Start{ CrosshairWorldPosition };
-		const FVector End{ Start + CrosshairWorldDirection * 50000 };
+		if (CrosshairQueryCache.bTraced) INC_DWORD_STAT(STAT_CrosshairTraceCacheHits);
+		else
+		{
+			INC_DWORD_STAT(STAT_CrosshairTraceCacheMisses);
+			GetWorld()->LineTraceSingleByChannel(CrosshairQueryCache.Hit, Start, End, ECollisionChannel::ECC_Visibility);
+			CrosshairQueryCache.bTraced = true;
+		}
+		OutHit = CrosshairQueryCache.Hit;
 		OutHitLocation = End;
-		GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECollisionChannel::ECC_Visibility);
 		if (OutHit.bBlockingHit)
 		{
 			OutHitLocation = OutHit.Location;
@@ -531,62 +646,57 @@ bool AArcoroxCharacter::CrosshairLineTrace(FHitResult& OutHit, FVector& OutHitLo
 	return false;
 }
 
-void AArcoroxCharacter::CalculateCrosshairSpread(float DeltaTime)
+void AArcoroxCharacter::SetCrosshairSpreadTargets()
 {
-	//Calculate CrosshairVelocityFactor
-	FVector2D WalkSpeedRange{ 0.f, 600.f };
-	FVector2D VelocityMultiplierRange{ 0.f, 1.f };
-	FVector Velocity{ GetVelocity() };
-	Velocity.Z = 0.f;
-	CrosshairVelocityFactor = FMath::GetMappedRangeValueClamped(WalkSpeedRange, VelocityMultiplierRange, Velocity.Size());
+	if (SmoothedValues == nullptr) return;
+	const FBakedCrosshairSpread& Spread = GetCrosshairSpreadProfile();
 	//Calculate CrosshairInAirFactor
-	if (GetCharacterMovement()->IsFalling()) CrosshairInAirFactor = FMath::FInterpTo<float>(CrosshairInAirFactor, 2.25f, DeltaTime, 2.25f);
-	else CrosshairInAirFactor = FMath::FInterpTo<float>(CrosshairInAirFactor, 0.f, DeltaTime, 30.f);
+	if (GetCharacterMovement()->IsFalling()) SmoothedValues->SetTarget(CrosshairInAirHandle, Spread.InAirSpread, Spread.InAirInterpSpeed);
+	else SmoothedValues->SetTarget(CrosshairInAirHandle, 0.f, Spread.LandedInterpSpeed);
 	//Calculate CrosshairAimFactor
-	if (bAiming) CrosshairAimFactor = FMath::FInterpTo<float>(CrosshairAimFactor, -0.6f, DeltaTime, 30.f);
-	else CrosshairAimFactor = FMath::FInterpTo<float>(CrosshairAimFactor, 0.f, DeltaTime, 30.f);
+	SmoothedValues->SetTarget(CrosshairAimHandle, bAiming ? Spread.AimSpread : 0.f, Spread.AimInterpSpeed);
 	//Calculate CrosshairShootFactor
-	if (bFiringWeapon) CrosshairShootingFactor = FMath::FInterpTo<float>(CrosshairShootingFactor, 0.4f, DeltaTime, 60.f);
-	else CrosshairShootingFactor = FMath::FInterpTo<float>(CrosshairShootingFactor, 0.f, DeltaTime, 60.f);
-	CrosshairSpreadMultiplier = 0.5f + CrosshairVelocityFactor + CrosshairInAirFactor + CrosshairAimFactor + CrosshairShootingFactor;
+	SmoothedValues->SetTarget(CrosshairShootingHandle, GetWorld()->GetTimeSeconds() < CrosshairShootEndTime ? Spread.ShootSpread : 0.f, Spread.ShootInterpSpeed);
+}
+
+void AArcoroxCharacter::CalculateCrosshairSpread()
+{
+	const FBakedCrosshairSpread& Spread = GetCrosshairSpreadProfile();
+	//Calculate CrosshairVelocityFactor
+	CrosshairVelocityFactor = Spread.SampleVelocityFactor(GetVelocity().Size2D());
+	CrosshairSpreadMultiplier = Spread.BaseSpread + CrosshairVelocityFactor + CrosshairInAirFactor + CrosshairAimFactor + CrosshairShootingFactor;
 }
 
 void AArcoroxCharacter::ItemTrace()
 {
-	if (bShouldTraceForItems)
+	if (OverlappingItems.Num() > 0)
 	{
-		FHitResult ItemTraceResult;
-		FVector HitLocation;
-		if (CrosshairLineTrace(ItemTraceResult, HitLocation))
+		TraceHitItem = FindAimedItem();
+		if (TraceHitItem && TraceHitItem->GetItemType() == EItemType::EIT_Weapon)
 		{
-			TraceHitItem = Cast<AItem>(ItemTraceResult.GetActor());
-			const AWeapon* TraceHitWeapon = Cast<AWeapon>(TraceHitItem);
-			if (TraceHitWeapon)
-			{
-				if (HighlightedInventorySlot == -1) HighlightInventorySlot();
-			}
-			else
-			{
-				if (HighlightedInventorySlot != -1) UnhighlightInventorySlot();
-			}
-			if (TraceHitItem && TraceHitItem->GetItemState() == EItemState::EIS_EquipInterpolating) TraceHitItem = nullptr;
-			if (TraceHitItem)
-			{
-				TraceHitItem->ShowPickupWidget();
-				TraceHitItem->EnableCustomDepth();
-				TraceHitItem->SetCharacterInventoryFull(Inventory.Num() >= InventoryCapacity);
-			}
-			
-			if (TraceHitItemLastFrame)
+			if (HighlightedInventorySlot == -1) HighlightInventorySlot();
+		}
+		else
+		{
+			if (HighlightedInventorySlot != -1) UnhighlightInventorySlot();
+		}
+		if (TraceHitItem && TraceHitItem->GetItemState() == EItemState::EIS_EquipInterpolating) TraceHitItem = nullptr;
+		if (TraceHitItem)
+		{
+			TraceHitItem->ShowPickupWidget();
+			TraceHitItem->EnableCustomDepth();
+			TraceHitItem->SetCharacterInventoryFull(InventoryComponent->IsFull());
+		}
+		
+		if (TraceHitItemLastFrame)
+		{
+			if (TraceHitItem != TraceHitItemLastFrame)
 			{
-				if (TraceHitItem != TraceHitItemLastFrame)
-				{
-					TraceHitItemLastFrame->HidePickupWidget();
-					TraceHitItemLastFrame->DisableCustomDepth();
-				}
+				TraceHitItemLastFrame->HidePickupWidget();
+				TraceHitItemLastFrame->DisableCustomDepth();
 			}
-			TraceHitItemLastFrame = TraceHitItem;
 		}
+		TraceHitItemLastFrame = TraceHitItem;
 	}
 	else if (TraceHitItemLastFrame)
 	{
@@ -596,27 +706,74 @@ void AArcoroxCharacter::ItemTrace()
 	}
 }
 
-void AArcoroxCharacter::StartCrosshairShootTimer()
+AItem* AArcoroxCharacter::FindAimedItem()
 {
-	bFiringWeapon = true;
-	GetWorldTimerManager().SetTimer(CrosshairShootTimer, this, &AArcoroxCharacter::FinishedCrosshairShootTimer, ShootTimeDuration);
-}
+	FVector Start, End;
+	if (!GetCrosshairTraceSegment(Start, End)) return nullptr;
+	const FVector Direction = (End - Start).GetSafeNormal();
 
-void AArcoroxCharacter::StartAutoFireTimer()
-{
-	if (EquippedWeapon == nullptr) return;
-	CombatState = ECombatState::ECS_Firing;
-	GetWorldTimerManager().SetTimer(AutoFireTimer, this, &AArcoroxCharacter::AutoFireReset, EquippedWeapon->GetFireRate());
+	//Candidates are items whose collision box bounding sphere the crosshair ray passes through, the one closest in angle to the ray is aimed at
+	AItem* BestItem = nullptr;
+	double BestAngle = UE_DOUBLE_BIG_NUMBER;
+	double SecondAngle = UE_DOUBLE_BIG_NUMBER;
+	int32 NumCandidates = 0;
+	for (AItem* Item : OverlappingItems)
+	{
+		if (Item == nullptr || Item->GetCollisionBox() == nullptr) continue;
+		const FBoxSphereBounds& Bounds = Item->GetCollisionBox()->Bounds;
+		const FVector ToItem = Bounds.Origin - Start;
+		const double Along = FVector::DotProduct(ToItem, Direction);
+		if (Along <= 0.0) continue;
+		if ((ToItem - Direction * Along).SizeSquared() > FMath::Square(Bounds.SphereRadius)) continue;
+		NumCandidates++;
+		const double Angle = FMath::Acos(FMath::Clamp(Along / FMath::Max(ToItem.Size(), UE_DOUBLE_SMALL_NUMBER), -1.0, 1.0));
+		if (Angle < BestAngle)
+		{
+			SecondAngle = BestAngle;
+			BestAngle = Angle;
+			BestItem = Item;
+		}
+		else SecondAngle = FMath::Min(SecondAngle, Angle);
+	}
+	INC_DWORD_STAT_BY(STAT_AimedItemCandidates, NumCandidates);
+	if (BestItem == nullptr) return nullptr;
+
+	//Items about as close to the crosshairs, the (shared) crosshair trace picks the one in front
+	if (SecondAngle - BestAngle < FMath::DegreesToRadians(AimedItemTieDegrees))
+	{
+		INC_DWORD_STAT(STAT_AimedItemTieTraces);
+		FHitResult CrosshairHit;
+		FVector HitLocation;
+		if (!CrosshairLineTrace(CrosshairHit, HitLocation)) return nullptr;
+		return Cast<AItem>(CrosshairHit.GetActor());
+	}
+
+	//Items behind walls are never aimed at, the view is traced when the item changes and every so often while it stays aimed at
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (BestItem != OcclusionCheckedItem || Now >= NextOcclusionCheckTime)
+	{
+		INC_DWORD_STAT(STAT_AimedItemOcclusionTraces);
+		FHitResult OcclusionHit;
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AimedItemOcclusion));
+		QueryParams.AddIgnoredActor(this);
+		if (EquippedWeapon) QueryParams.AddIgnoredActor(EquippedWeapon);
+		const FVector ItemCenter = BestItem->GetCollisionBox()->Bounds.Origin;
+		bAimedItemOccluded = GetWorld()->LineTraceSingleByChannel(OcclusionHit, Start, ItemCenter, ECollisionChannel::ECC_Visibility, QueryParams) && OcclusionHit.GetActor() != BestItem;
+		OcclusionCheckedItem = BestItem;
+		NextOcclusionCheckTime = Now + AimedItemOcclusionInterval;
+	}
+	return bAimedItemOccluded ? nullptr : BestItem;
 }
 
 AWeapon* AArcoroxCharacter::SpawnDefaultWeapon()
 {
 	UWorld* World = GetWorld();
-	if (World && DefaultWeaponClass) return World->SpawnActor<AWeapon>(DefaultWeaponClass);
+	//Carried weapons go back to the pool when the character is destroyed, dropped weapons stay in the world as pickups
+	if (World && DefaultWeaponClass) return UActorPoolSubsystem::AcquireOrSpawn<AWeapon>(World, DefaultWeaponClass);
 	return nullptr;
 }
 
-void AArcoroxCharacter::EquipWeapon(AWeapon* Weapon, bool bSwapping)
+void AArcoroxCharacter::EquipWeapon(AWeapon* Weapon)
 {
 	if (Weapon)
 	{
@@ -624,8 +781,7 @@ void AArcoroxCharacter::EquipWeapon(AWeapon* Weapon, bool bSwapping)
 		if (WeaponSocket)
 		{
 			WeaponSocket->AttachActor(Weapon, GetMesh());
-			if (EquippedWeapon == nullptr) EquipItemDelegate.Broadcast(-1, Weapon->GetInventorySlotIndex());
-			else if(!bSwapping) EquipItemDelegate.Broadcast(EquippedWeapon->GetInventorySlotIndex(), Weapon->GetInventorySlotIndex());
+			InventoryViewModel->SetEquippedSlot(Weapon->GetInventorySlotIndex());
 			EquippedWeapon = Weapon;
 			EquippedWeapon->SetItemState(EItemState::EIS_Equipped);
 		}
@@ -646,42 +802,73 @@ void AArcoroxCharacter::DropWeapon()
 void AArcoroxCharacter::SwapWeapon(AWeapon* Weapon)
 {
 	if (EquippedWeapon == nullptr) return;
-	if (Inventory.Num() - 1 >= EquippedWeapon->GetInventorySlotIndex())
+	if (InventoryComponent->IsValidSlot(EquippedWeapon->GetInventorySlotIndex()))
 	{
-		Inventory[EquippedWeapon->GetInventorySlotIndex()] = Weapon;
-		Weapon->SetInventorySlotIndex(EquippedWeapon->GetInventorySlotIndex());
+		InventoryComponent->SetItemAt(EquippedWeapon->GetInventorySlotIndex(), Weapon);
+		UpdateInventoryMirror(EquippedWeapon->GetInventorySlotIndex());
 	}
 	DropWeapon();
-	EquipWeapon(Weapon, true);
+	EquipWeapon(Weapon);
 	TraceHitItem = nullptr;
 	TraceHitItemLastFrame = nullptr;
 }
 
 int32 AArcoroxCharacter::GetEmptyInventorySlot() const
 {
-	if (Inventory.Num() >= InventoryCapacity) return -1;
-	for (int32 i = 0; i < Inventory.Num(); i++)	if (Inventory[i] == nullptr) return i;
-	if (Inventory.Num() < InventoryCapacity) return Inventory.Num();
-	return -1;
+	return InventoryComponent->GetEmptySlot();
+}
+
+void AArcoroxCharacter::UpdateInventoryMirror(int32 ChangedSlot)
+{
+	InventoryViewModel->MarkSlotChanged(ChangedSlot);
+	//Slots fill from the front and are never emptied, so the mirror stops at the first empty slot
+	const TArray<AItem*>& Slots = InventoryComponent->GetSlots();
+	Inventory.Reset();
+	for (AItem* Item : Slots)
+	{
+		if (Item == nullptr) break;
+		Inventory.Add(Item);
+	}
+}
+
+void AArcoroxCharacter::UpdateAmmoMirror(EAmmoType AmmoType)
+{
+	AmmoMap.Add(AmmoType, InventoryComponent->GetAmmo(AmmoType));
+	InventoryViewModel->MarkAmmoChanged(AmmoType);
+}
+
+void AArcoroxCharacter::PublishInventoryView()
+{
+	if (!InventoryViewModel->Flush() || !CVarInventoryDelegates.GetValueOnGameThread()) return;
+	//One broadcast per delegate for the whole frame, however many times the slots changed within it
+	const FInventoryViewState& State = InventoryViewModel->GetState();
+	if (State.EquippedSlot != State.PreviousEquippedSlot) EquipItemDelegate.Broadcast(State.PreviousEquippedSlot, State.EquippedSlot);
+	if (State.HighlightedSlot != State.PreviousHighlightedSlot)
+	{
+		if (State.PreviousHighlightedSlot != INDEX_NONE) HighlightIconDelegate.Broadcast(State.PreviousHighlightedSlot, false);
+		if (State.HighlightedSlot != INDEX_NONE) HighlightIconDelegate.Broadcast(State.HighlightedSlot, true);
+	}
 }
 
 void AArcoroxCharacter::HighlightInventorySlot()
 {
 	HighlightedInventorySlot = GetEmptyInventorySlot();
-	HighlightIconDelegate.Broadcast(HighlightedInventorySlot, true);
+	InventoryViewModel->SetHighlightedSlot(HighlightedInventorySlot);
 }
 
 void AArcoroxCharacter::UnhighlightInventorySlot()
 {
 	if (HighlightedInventorySlot == -1) return;
-	HighlightIconDelegate.Broadcast(HighlightedInventorySlot, false);
 	HighlightedInventorySlot = -1;
+	InventoryViewModel->SetHighlightedSlot(HighlightedInventorySlot);
 }
 
 void AArcoroxCharacter::InitializeAmmoMap()
 {
-	AmmoMap.Add(EAmmoType::EAT_9mm, Starting9mmAmmo);
-	AmmoMap.Add(EAmmoType::EAT_556, Starting556Ammo);
+	InventoryComponent->SetAmmo(EAmmoType::EAT_9mm, Starting9mmAmmo);
+	InventoryComponent->SetAmmo(EAmmoType::EAT_556, Starting556Ammo);
+	UpdateAmmoMirror(EAmmoType::EAT_9mm);
+	UpdateAmmoMirror(EAmmoType::EAT_556);
 }
 
 bool AArcoroxCharacter::WeaponHasAmmo()
@@ -692,26 +879,39 @@ bool AArcoroxCharacter::WeaponHasAmmo()
 
 bool AArcoroxCharacter::CarryingAmmo()
 {
-	if (EquippedWeapon)
-	{
-		auto AmmoType = EquippedWeapon->GetAmmoType();
-		if (AmmoMap.Contains(AmmoType)) return AmmoMap[AmmoType] > 0;
-	}
+	if (EquippedWeapon) return InventoryComponent->HasAmmo(EquippedWeapon->GetAmmoType());
 	return false;
 }
 
-void AArcoroxCharacter::InterpolateCapsuleHalfHeight(float DeltaTime)
+void AArcoroxCharacter::InterpolateCapsuleHalfHeight()
+{
+	if (SmoothedValues == nullptr) return;
+	SmoothedValues->SetTarget(CapsuleHalfHeightHandle, bCrouching ? CrouchingCapsuleHalfHeight : DefaultCapsuleHalfHeight, 20.f);
+}
+
+void AArcoroxCharacter::ApplyCapsuleHalfHeight(float HalfHeight)
 {
 	if (GetCapsuleComponent() == nullptr || GetMesh() == nullptr) return;
-	const float CurrentCapsuleHalfHeight{ GetCapsuleComponent()->GetScaledCapsuleHalfHeight() };
-	float TargetCapsuleHalfHeight;
-	bCrouching ? TargetCapsuleHalfHeight = CrouchingCapsuleHalfHeight : TargetCapsuleHalfHeight = DefaultCapsuleHalfHeight;
-	const float InterpolatedCapsuleHalfHeight{ FMath::FInterpTo<float>(CurrentCapsuleHalfHeight, TargetCapsuleHalfHeight, DeltaTime, 20.f) };
 	//Negative if crouching, positive if standing
-	const float DeltaCapsuleHalfHeight{ InterpolatedCapsuleHalfHeight - CurrentCapsuleHalfHeight };
+	const float DeltaCapsuleHalfHeight{ HalfHeight - GetCapsuleComponent()->GetScaledCapsuleHalfHeight() };
 	const FVector MeshOffset{ 0.f, 0.f, -DeltaCapsuleHalfHeight };
 	GetMesh()->AddLocalOffset(MeshOffset);
-	GetCapsuleComponent()->SetCapsuleHalfHeight(InterpolatedCapsuleHalfHeight);
+	GetCapsuleComponent()->SetCapsuleHalfHeight(HalfHeight);
+}
+
+void AArcoroxCharacter::InitializeSmoothedValues()
+{
+	if (SmoothedValues == nullptr) return;
+	CameraFOVHandle = SmoothedValues->AddValue(CameraCurrentFOV, 0.01f, [this](float FOV)
+	{
+		CameraCurrentFOV = FOV;
+		if (GetCamera()) GetCamera()->SetFieldOfView(FOV);
+	});
+	const float CapsuleHalfHeight = GetCapsuleComponent() ? GetCapsuleComponent()->GetScaledCapsuleHalfHeight() : DefaultCapsuleHalfHeight;
+	CapsuleHalfHeightHandle = SmoothedValues->AddValue(CapsuleHalfHeight, 0.01f, [this](float HalfHeight) { ApplyCapsuleHalfHeight(HalfHeight); });
+	CrosshairInAirHandle = SmoothedValues->AddValue(CrosshairInAirFactor, 0.001f, [this](float Factor) { CrosshairInAirFactor = Factor; });
+	CrosshairAimHandle = SmoothedValues->AddValue(CrosshairAimFactor, 0.001f, [this](float Factor) { CrosshairAimFactor = Factor; });
+	CrosshairShootingHandle = SmoothedValues->AddValue(CrosshairShootingFactor, 0.001f, [this](float Factor) { CrosshairShootingFactor = Factor; });
 }
 
 void AArcoroxCharacter::Aim()
@@ -729,17 +929,13 @@ void AArcoroxCharacter::StopAiming()
 void AArcoroxCharacter::PickupAmmo(AAmmo* Ammo)
 {
 	if (Ammo == nullptr) return;
-	if (AmmoMap.Contains(Ammo->GetAmmoType()))
-	{
-		int32 CurrentAmmoCount{ AmmoMap[Ammo->GetAmmoType()] };
-		CurrentAmmoCount += Ammo->GetItemCount();
-		AmmoMap[Ammo->GetAmmoType()] = CurrentAmmoCount;
-	}
+	InventoryComponent->AddAmmo(Ammo->GetAmmoType(), Ammo->GetItemCount());
+	UpdateAmmoMirror(Ammo->GetAmmoType());
 	if (EquippedWeapon && EquippedWeapon->GetAmmoType() == Ammo->GetAmmoType())
 	{
 		if (!WeaponHasAmmo()) ReloadWeapon();
 	}
-	Ammo->Destroy();
+	UActorPoolSubsystem::ReleaseOrDestroy(Ammo);
 }
 
 void AArcoroxCharacter::InitializeInterpLocations()
@@ -768,43 +964,14 @@ int32 AArcoroxCharacter::GetInterpLocationIndex()
 	return TargetIndex;
 }
 
-void AArcoroxCharacter::AutoFireReset()
-{
-	CombatState = ECombatState::ECS_Unoccupied;
-	if (EquippedWeapon == nullptr) return;
-	if (WeaponHasAmmo())
-	{
-		if (bFireButtonPressed && EquippedWeapon->IsWeaponAutomatic()) FireWeapon();
-	}
-	else
-	{
-		ReloadWeapon();
-	}
-}
-
-void AArcoroxCharacter::FinishedCrosshairShootTimer()
-{
-	bFiringWeapon = false;
-}
-
 void AArcoroxCharacter::FinishReloading()
 {
 	CombatState = ECombatState::ECS_Unoccupied;
 	if (bAimButtonPressed) Aim();
-	int32 CarriedAmmo = AmmoMap[EquippedWeapon->GetAmmoType()];
+	if (EquippedWeapon == nullptr) return;
 	const int32 MagEmptySpace = EquippedWeapon->GetMagazineCapacity() - EquippedWeapon->GetAmmo();
-	if (MagEmptySpace > CarriedAmmo)
-	{
-		EquippedWeapon->ReloadAmmo(CarriedAmmo);
-		CarriedAmmo = 0;
-		AmmoMap.Add(EquippedWeapon->GetAmmoType(), CarriedAmmo);
-	}
-	else
-	{
-		EquippedWeapon->ReloadAmmo(MagEmptySpace);
-		CarriedAmmo -= MagEmptySpace;
-		AmmoMap.Add(EquippedWeapon->GetAmmoType(), CarriedAmmo);
-	}
+	EquippedWeapon->ReloadAmmo(InventoryComponent->TakeAmmo(EquippedWeapon->GetAmmoType(), MagEmptySpace));
+	UpdateAmmoMirror(EquippedWeapon->GetAmmoType());
 }
 
 void AArcoroxCharacter::FinishEquipping()
@@ -844,24 +1011,32 @@ EPhysicalSurface AArcoroxCharacter::GetSurfaceType()
 
 void AArcoroxCharacter::PlayFireSound()
 {
-	if (EquippedWeapon->GetFireSound()) UGameplayStatics::PlaySound2D(this, EquippedWeapon->GetFireSound());
+	//Automatic weapons with a loop keep it alive a little longer than one shot so consecutive shots stitch together
+	UGameplayAudioSubsystem* AudioSubsystem = GetWorld()->GetSubsystem<UGameplayAudioSubsystem>();
+	if (AudioSubsystem && EquippedWeapon->IsWeaponAutomatic() && EquippedWeapon->GetFireLoopSound())
+	{
+		AudioSubsystem->KeepFireLoopAlive(this, EquippedWeapon->GetFireLoopSound(), EquippedWeapon->GetFireLoopTailSound(), EquippedWeapon->GetFireRate() * 1.5f);
+		return;
+	}
+	UGameplayAudioSubsystem::PlaySound2D(this, EquippedWeapon->GetFireSound(), EGameplaySoundCategory::WeaponFire, this);
 }
 
 void AArcoroxCharacter::SpawnMuzzleFlash(const FTransform& SocketTransform)
 {
-	if (EquippedWeapon->GetMuzzleFlash()) UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), EquippedWeapon->GetMuzzleFlash(), SocketTransform);
+	if (EquippedWeapon->GetMuzzleFlash()) UFXSubsystem::SpawnEmitterAtLocation(this, EquippedWeapon->GetMuzzleFlash(), SocketTransform, EFXPriority::Critical);
 }
 
 void AArcoroxCharacter::SpawnImpactParticles(const FVector& BeamEnd)
 {
-	if (ImpactParticles) UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, BeamEnd);
+	if (ImpactParticles) UFXSubsystem::SpawnEmitterAtLocation(this, ImpactParticles, BeamEnd, EFXPriority::Budgeted);
 }
 
 void AArcoroxCharacter::SpawnBeamParticles(const FTransform& SocketTransform, const FVector& BeamEnd)
 {
 	if (BeamParticles)
 	{
-		UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BeamParticles, SocketTransform);
+		//Each beam has its own target, so beams are never coalesced
+		UParticleSystemComponent* Beam = UFXSubsystem::SpawnEmitterAtLocation(this, BeamParticles, SocketTransform, EFXPriority::Budgeted, false);
 		if (Beam) Beam->SetVectorParameter(FName("Target"), BeamEnd);
 	}
 }
@@ -898,20 +1073,10 @@ void AArcoroxCharacter::PlayEquipMontage()
 	PlayMontageSection(EquipMontage, FName(TEXT("Default")));
 }
 
-void AArcoroxCharacter::CameraZoomInterpolation(float DeltaTime)
+void AArcoroxCharacter::CameraZoomInterpolation()
 {
 	//Smoothly transition the current camera field of view
-	if (bAiming)
-	{
-		//Interpolate to zoomed field of view
-		CameraCurrentFOV = FMath::FInterpTo<float>(CameraCurrentFOV, CameraZoomedFOV, DeltaTime, ZoomInterpolationSpeed);
-	}
-	else
-	{
-		//Interpolate to default field of view
-		CameraCurrentFOV = FMath::FInterpTo<float>(CameraCurrentFOV, CameraDefaultFOV, DeltaTime, ZoomInterpolationSpeed);
-	}
-	if (GetCamera()) GetCamera()->SetFieldOfView(CameraCurrentFOV);
+	if (SmoothedValues) SmoothedValues->SetTarget(CameraFOVHandle, bAiming ? CameraZoomedFOV : CameraDefaultFOV, ZoomInterpolationSpeed);
 }
 
 void AArcoroxCharacter::SetupEnhancedInput()
@@ -932,12 +1097,4 @@ void AArcoroxCharacter::SetLookScale()
 	else LookScale = HipLookScale;
 }
 
-void AArcoroxCharacter::ResetPickupSoundTimer()
-{
-	bShouldPlayPickupSound = true;
-}
 
-void AArcoroxCharacter::ResetEquipSoundTimer()
-{
-	bShouldPlayEquipSound = true;
-}
@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Characters/SmoothedValueComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Smoothed Values Moving"), STAT_SmoothedValuesMoving, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Smoothed Value Writes"), STAT_SmoothedValueWrites, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Smoothed Value Writes Skipped"), STAT_SmoothedValueWritesSkipped, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<float> CVarSmoothingStepRate(
+	TEXT("Arcorox.Smoothing.StepRate"),
+	120.f,
+	TEXT("Fixed steps per second used to ease the crosshair spread, camera zoom, capsule height and lean."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSmoothingMaxSteps(
+	TEXT("Arcorox.Smoothing.MaxStepsPerFrame"),
+	16,
+	TEXT("Most fixed smoothing steps run in one frame, longer hitches drop the remainder."),
+	ECVF_Default);
+
+void FSmoothedFloat::Reset(float Value)
+{
+	Current = Previous = Target = Value;
+}
+
+void FSmoothedFloat::SetTarget(float InTarget, float InSpeed)
+{
+	Target = InTarget;
+	Speed = InSpeed;
+}
+
+void FSmoothedFloat::Step(float FixedStep)
+{
+	Previous = Current;
+	Current = FMath::FInterpTo<float>(Current, Target, FixedStep, Speed);
+	if (FMath::Abs(Target - Current) <= Epsilon) Current = Target;
+}
+
+int32 FFixedStepClock::Advance(float DeltaTime)
+{
+	const float FixedStep = GetFixedStep();
+	Accumulator += FMath::Max(DeltaTime, 0.f);
+	const int32 NumSteps = FMath::FloorToInt32(Accumulator / FixedStep);
+	const int32 MaxSteps = FMath::Max(CVarSmoothingMaxSteps.GetValueOnAnyThread(), 1);
+	if (NumSteps > MaxSteps)
+	{
+		Accumulator = 0.f;
+		return MaxSteps;
+	}
+	Accumulator -= NumSteps * FixedStep;
+	return NumSteps;
+}
+
+float FFixedStepClock::GetAlpha() const
+{
+	return FMath::Clamp(Accumulator / GetFixedStep(), 0.f, 1.f);
+}
+
+float FFixedStepClock::GetFixedStep()
+{
+	return 1.f / FMath::Max(CVarSmoothingStepRate.GetValueOnAnyThread(), 1.f);
+}
+
+USmoothedValueComponent::USmoothedValueComponent() :
+	NumMoving(0)
+{
+	//Integrated by the owner so the values are ready before it reads them
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+int32 USmoothedValueComponent::AddValue(float InitialValue, float WriteEpsilon, TFunction<void(float)>&& Writer)
+{
+	FSmoothedEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Value.Reset(InitialValue);
+	Entry.Value.Epsilon = WriteEpsilon * 0.5f;
+	Entry.Writer = MoveTemp(Writer);
+	Entry.WrittenValue = InitialValue;
+	Entry.WriteEpsilon = WriteEpsilon;
+	Entry.bMoving = false;
+	return Entries.Num() - 1;
+}
+
+void USmoothedValueComponent::SetTarget(int32 Handle, float Target, float Speed)
+{
+	if (!Entries.IsValidIndex(Handle)) return;
+	FSmoothedEntry& Entry = Entries[Handle];
+	Entry.Value.SetTarget(Target, Speed);
+	if (!Entry.bMoving && Target != Entry.WrittenValue)
+	{
+		Entry.bMoving = true;
+		NumMoving++;
+	}
+}
+
+void USmoothedValueComponent::Integrate(float DeltaTime)
+{
+	const int32 NumSteps = Clock.Advance(DeltaTime);
+	if (NumMoving == 0) return;
+	INC_DWORD_STAT_BY(STAT_SmoothedValuesMoving, NumMoving);
+
+	const float FixedStep = FFixedStepClock::GetFixedStep();
+	const float Alpha = Clock.GetAlpha();
+	for (FSmoothedEntry& Entry : Entries)
+	{
+		if (!Entry.bMoving) continue;
+		for (int32 i = 0; i < NumSteps; i++) Entry.Value.Step(FixedStep);
+
+		//Settled values write their exact target once, moving values only once they drift past the epsilon
+		const bool bSettled = Entry.Value.IsSettled();
+		const float NewValue = bSettled ? Entry.Value.GetTarget() : Entry.Value.Sample(Alpha);
+		if (bSettled ? NewValue != Entry.WrittenValue : FMath::Abs(NewValue - Entry.WrittenValue) > Entry.WriteEpsilon)
+		{
+			Entry.WrittenValue = NewValue;
+			if (Entry.Writer) Entry.Writer(NewValue);
+			INC_DWORD_STAT(STAT_SmoothedValueWrites);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_SmoothedValueWritesSkipped);
+		}
+		if (bSettled)
+		{
+			Entry.bMoving = false;
+			NumMoving--;
+		}
+	}
+}
+
+float USmoothedValueComponent::GetValue(int32 Handle) const
+{
+	return Entries.IsValidIndex(Handle) ? Entries[Handle].WrittenValue : 0.f;
+}
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/CrosshairSpreadProfile.h"
+#include "Curves/CurveFloat.h"
+
+float FCrosshairSpreadProfile::EvaluateVelocityFactor(float Speed, const UCurveFloat* Curve) const
+{
+	const float Alpha = MaxVelocity > 0.f ? FMath::Clamp(Speed / MaxVelocity, 0.f, 1.f) : 1.f;
+	return VelocitySpread * (Curve ? Curve->GetFloatValue(Alpha) : Alpha);
+}
+
+void FBakedCrosshairSpread::Bake(const FCrosshairSpreadProfile& Profile)
+{
+	BaseSpread = Profile.BaseSpread;
+	InAirSpread = Profile.InAirSpread;
+	InAirInterpSpeed = Profile.InAirInterpSpeed;
+	LandedInterpSpeed = Profile.LandedInterpSpeed;
+	AimSpread = Profile.AimSpread;
+	AimInterpSpeed = Profile.AimInterpSpeed;
+	ShootSpread = Profile.ShootSpread;
+	ShootInterpSpeed = Profile.ShootInterpSpeed;
+
+	//The curve is only needed here, the baked table keeps no reference to it
+	const UCurveFloat* VelocityCurve = Profile.VelocityCurve.LoadSynchronous();
+	const float MaxVelocity = FMath::Max(Profile.MaxVelocity, KINDA_SMALL_NUMBER);
+	SpeedToSample = (NumVelocitySamples - 1) / MaxVelocity;
+	for (int32 i = 0; i < NumVelocitySamples; i++)
+	{
+		VelocityFactors[i] = Profile.EvaluateVelocityFactor(i * MaxVelocity / (NumVelocitySamples - 1), VelocityCurve);
+	}
+}
+
+float FBakedCrosshairSpread::SampleVelocityFactor(float Speed) const
+{
+	const float Sample = FMath::Clamp(Speed * SpeedToSample, 0.f, static_cast<float>(NumVelocitySamples - 1));
+	const int32 Index = FMath::Min(FMath::FloorToInt32(Sample), NumVelocitySamples - 2);
+	return FMath::Lerp(VelocityFactors[Index], VelocityFactors[Index + 1], Sample - Index);
+}
+
+float FBakedCrosshairSpread::MeasureMaxError(const FCrosshairSpreadProfile& Profile, int32 NumTestSpeeds) const
+{
+	float MaxError = 0.f;
+	const UCurveFloat* VelocityCurve = Profile.VelocityCurve.LoadSynchronous();
+	const float MaxTestSpeed = Profile.MaxVelocity * 1.25f;
+	for (int32 i = 0; i < NumTestSpeeds; i++)
+	{
+		const float Speed = MaxTestSpeed * i / FMath::Max(NumTestSpeeds - 1, 1);
+		MaxError = FMath::Max(MaxError, FMath::Abs(SampleVelocityFactor(Speed) - Profile.EvaluateVelocityFactor(Speed, VelocityCurve)));
+	}
+	return MaxError;
+}
+
+const FBakedCrosshairSpread& FBakedCrosshairSpread::GetDefault()
+{
+	static const FBakedCrosshairSpread Default = []()
+	{
+		FBakedCrosshairSpread Baked;
+		Baked.Bake(FCrosshairSpreadProfile());
+		return Baked;
+	}();
+	return Default;
+}
@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/DamageQueueSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/DamageType.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Events Queued"), STAT_DamageEventsQueued, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Groups Applied"), STAT_DamageGroupsApplied, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Damage Queue Resolve"), STAT_DamageQueueResolve, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<int32> CVarDamageQueueEnabled(
+	TEXT("Arcorox.Combat.DamageQueue.Enabled"),
+	1,
+	TEXT("1 queues hits and applies them once per frame summed per target, 0 applies every hit immediately."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkDamageQueueCommand(
+	TEXT("Arcorox.Combat.BenchmarkDamage"),
+	TEXT("Arcorox.Combat.BenchmarkDamage [Events] [Targets] - applies Events hits spread over Targets dummy actors through the damage queue and immediately, and logs events per second."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UDamageQueueSubsystem* DamageQueue = World ? World->GetSubsystem<UDamageQueueSubsystem>() : nullptr;
+		if (DamageQueue == nullptr) return;
+		const int32 NumEvents = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000000;
+		const int32 NumTargets = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 64;
+		DamageQueue->ResolveQueue();
+
+		TArray<AActor*> Targets;
+		for (int32 i = 0; i < NumTargets; i++)
+		{
+			if (AActor* Target = World->SpawnActor<AActor>()) Targets.Add(Target);
+		}
+		if (Targets.Num() == 0) return;
+
+		FQueuedDamage Damage;
+		Damage.Location = FVector::ZeroVector;
+		Damage.Amount = 1.f;
+		Damage.bHeadshot = false;
+		Damage.bShowHitNumber = false;
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumEvents; i++)
+		{
+			Damage.Target = Targets[i % Targets.Num()];
+			DamageQueue->QueueDamage(Damage);
+		}
+		const double QueueSeconds = FPlatformTime::Seconds() - StartTime;
+		StartTime = FPlatformTime::Seconds();
+		DamageQueue->ResolveQueue();
+		const double ResolveSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumEvents; i++) UGameplayStatics::ApplyDamage(Targets[i % Targets.Num()], 1.f, nullptr, nullptr, UDamageType::StaticClass());
+		const double ImmediateSeconds = FPlatformTime::Seconds() - StartTime;
+
+		for (AActor* Target : Targets) Target->Destroy();
+		UE_LOG(LogArcorox, Log, TEXT("Damage, %d events on %d targets: queued %.0f events/s (queue %.2f ms, resolve %.2f ms), immediate %.0f events/s (%.2f ms)"),
+			NumEvents, Targets.Num(), NumEvents / FMath::Max(QueueSeconds + ResolveSeconds, 1e-9), QueueSeconds * 1000.0, ResolveSeconds * 1000.0,
+			NumEvents / FMath::Max(ImmediateSeconds, 1e-9), ImmediateSeconds * 1000.0);
+	}));
+
+void FDamageQueueTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Subsystem) Subsystem->ResolveQueue();
+}
+
+FString FDamageQueueTickFunction::DiagnosticMessage()
+{
+	return TEXT("FDamageQueueTickFunction");
+}
+
+void UDamageQueueSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	TickFunction.Subsystem = this;
+	TickFunction.TickGroup = TG_PostUpdateWork;
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = true;
+	TickFunction.bTickEvenWhenPaused = false;
+	TickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+void UDamageQueueSubsystem::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered()) TickFunction.UnRegisterTickFunction();
+	TickFunction.Subsystem = nullptr;
+	Queue.Empty();
+	ResolvingQueue.Empty();
+	Groups.Empty();
+	GroupIndices.Empty();
+
+	Super::Deinitialize();
+}
+
+void UDamageQueueSubsystem::QueueDamage(const FQueuedDamage& Damage)
+{
+	if (CVarDamageQueueEnabled.GetValueOnGameThread() == 0)
+	{
+		ApplyDamage(Damage.Target.Get(), Damage.Amount, Damage.Instigator.Get(), Damage.Causer.Get(), Damage.Location, Damage.bHeadshot, Damage.bShowHitNumber);
+		return;
+	}
+	INC_DWORD_STAT(STAT_DamageEventsQueued);
+	Queue.Add(Damage);
+}
+
+void UDamageQueueSubsystem::QueueDamage(const UObject* WorldContextObject, AActor* Target, float Amount, AController* Instigator, AActor* Causer, const FVector& Location, bool bHeadshot, bool bShowHitNumber)
+{
+	if (WorldContextObject == nullptr || Target == nullptr) return;
+	UWorld* World = WorldContextObject->GetWorld();
+	UDamageQueueSubsystem* DamageQueue = World ? World->GetSubsystem<UDamageQueueSubsystem>() : nullptr;
+	if (DamageQueue == nullptr)
+	{
+		ApplyDamage(Target, Amount, Instigator, Causer, Location, bHeadshot, bShowHitNumber);
+		return;
+	}
+	DamageQueue->QueueDamage(FQueuedDamage{ Target, Instigator, Causer, Location, Amount, bHeadshot, bShowHitNumber });
+}
+
+void UDamageQueueSubsystem::ResolveQueue()
+{
+	if (Queue.Num() == 0) return;
+	SCOPE_CYCLE_COUNTER(STAT_DamageQueueResolve);
+	Swap(Queue, ResolvingQueue);
+
+	//Groups keep the order of the first hit on each target, the map is only used to find them
+	Groups.Reset();
+	GroupIndices.Reset();
+	for (const FQueuedDamage& Damage : ResolvingQueue)
+	{
+		AActor* Target = Damage.Target.Get();
+		if (Target == nullptr) continue;
+		AController* Instigator = Damage.Instigator.Get();
+		int32& GroupIndex = GroupIndices.FindOrAdd(TPair<const AActor*, const AController*>(Target, Instigator), INDEX_NONE);
+		if (GroupIndex == INDEX_NONE)
+		{
+			GroupIndex = Groups.Add(FDamageGroup{ Target, Instigator, Damage.Causer.Get(), Damage.Location, Damage.Amount, Damage.bHeadshot, Damage.bShowHitNumber });
+			continue;
+		}
+		FDamageGroup& Group = Groups[GroupIndex];
+		Group.Amount += Damage.Amount;
+		Group.Location = Damage.Location;
+		Group.bHeadshot |= Damage.bHeadshot;
+		Group.bShowHitNumber |= Damage.bShowHitNumber;
+	}
+	ResolvingQueue.Reset();
+
+	for (const FDamageGroup& Group : Groups)
+	{
+		//Damage applied to an earlier group can destroy the target of a later one
+		if (!IsValid(Group.Target)) continue;
+		ApplyDamage(Group.Target, Group.Amount, Group.Instigator, Group.Causer, Group.Location, Group.bHeadshot, Group.bShowHitNumber);
+	}
+	INC_DWORD_STAT_BY(STAT_DamageGroupsApplied, Groups.Num());
+}
+
+void UDamageQueueSubsystem::ApplyDamage(AActor* Target, float Amount, AController* Instigator, AActor* Causer, const FVector& Location, bool bHeadshot, bool bShowHitNumber)
+{
+	if (Target == nullptr) return;
+	UGameplayStatics::ApplyDamage(Target, Amount, Instigator, Causer, UDamageType::StaticClass());
+	if (!bShowHitNumber) return;
+	if (AEnemy* Enemy = Cast<AEnemy>(Target)) Enemy->DisplayHitDamage(Instigator, static_cast<int32>(Amount), Location, bHeadshot);
+}
@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/HitscanSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Shots Queued"), STAT_HitscanShotsQueued, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Async Traces"), STAT_HitscanAsyncTraces, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hitscan Shots Pending"), STAT_HitscanShotsPending, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Tick"), STAT_HitscanTick, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<int32> CVarHitscanMode(
+	TEXT("Arcorox.Hitscan.Mode"),
+	0,
+	TEXT("0: resolve hitscan shots immediately with synchronous traces.\n")
+	TEXT("1: queue hitscan shots and resolve them in batches of async traces."),
+	ECVF_Default);
+
+void UHitscanSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	CrosshairTraceDelegate.BindUObject(this, &UHitscanSubsystem::OnCrosshairTraceDone);
+	BarrelTraceDelegate.BindUObject(this, &UHitscanSubsystem::OnBarrelTraceDone);
+}
+
+void UHitscanSubsystem::Deinitialize()
+{
+	PendingShots.Empty();
+	SET_DWORD_STAT(STAT_HitscanShotsPending, 0);
+
+	Super::Deinitialize();
+}
+
+TStatId UHitscanSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHitscanSubsystem, STATGROUP_Tickables);
+}
+
+void UHitscanSubsystem::QueueShot(const FHitscanShot& Shot, FOnHitscanResolved OnResolved)
+{
+	INC_DWORD_STAT(STAT_HitscanShotsQueued);
+	if (CVarHitscanMode.GetValueOnGameThread() == 0)
+	{
+		FHitscanResult Result;
+		Result.BarrelTransform = Shot.BarrelTransform;
+		Result.bBlockingHit = ResolveShot(GetWorld(), Shot, Result.Hit);
+		OnResolved.ExecuteIfBound(Result);
+		return;
+	}
+
+	const uint32 Id = NextShotId++;
+	FPendingShot& Pending = PendingShots.Add(Id);
+	Pending.Id = Id;
+	Pending.Stage = EShotStage::Queued;
+	Pending.Shot = Shot;
+	if (Shot.bHasCrosshairHit)
+	{
+		//Shooter already traced the crosshairs this frame, go straight to the barrel trace
+		Pending.BeamEnd = GetBeamEndLocation(Shot, Shot.CrosshairHit);
+		Pending.Stage = EShotStage::CrosshairTraceDone;
+	}
+	Pending.OnResolved = MoveTemp(OnResolved);
+	SET_DWORD_STAT(STAT_HitscanShotsPending, PendingShots.Num());
+}
+
+bool UHitscanSubsystem::ResolveShot(UWorld* World, const FHitscanShot& Shot, FHitResult& OutHit)
+{
+	if (World == nullptr) return false;
+	//Trace outward from crosshair location
+	FHitResult CrosshairHit;
+	if (Shot.bHasCrosshairHit) CrosshairHit = Shot.CrosshairHit;
+	else World->LineTraceSingleByChannel(CrosshairHit, Shot.CrosshairStart, Shot.CrosshairEnd, ECollisionChannel::ECC_Visibility);
+	const FVector BeamEnd = GetBeamEndLocation(Shot, CrosshairHit);
+	//Perform line trace from weapon barrel
+	World->LineTraceSingleByChannel(OutHit, Shot.BarrelTransform.GetLocation(), GetBarrelTraceEnd(Shot, BeamEnd), ECollisionChannel::ECC_Visibility);
+	if (!OutHit.bBlockingHit) //No object between weapon barrel and beam end point?
+	{
+		OutHit.Location = BeamEnd;
+		return false;
+	}
+	return true;
+}
+
+void UHitscanSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_HitscanTick);
+
+	if (PendingShots.Num() == 0) return;
+
+	//Shots are delivered after the queue has been updated so callbacks can safely queue new shots
+	TArray<FPendingShot, TInlineAllocator<16>> ResolvedShots;
+	for (auto It = PendingShots.CreateIterator(); It; ++It)
+	{
+		FPendingShot& Pending = It.Value();
+		switch (Pending.Stage)
+		{
+		case EShotStage::Queued:
+			RequestCrosshairTrace(Pending);
+			break;
+		case EShotStage::CrosshairTraceDone:
+			RequestBarrelTrace(Pending);
+			break;
+		case EShotStage::BarrelTraceDone:
+			ResolvedShots.Add(MoveTemp(Pending));
+			It.RemoveCurrent();
+			break;
+		default:
+			break;
+		}
+	}
+	SET_DWORD_STAT(STAT_HitscanShotsPending, PendingShots.Num());
+
+	//Map order is not firing order once shots have been removed
+	ResolvedShots.Sort([](const FPendingShot& A, const FPendingShot& B) { return A.Id < B.Id; });
+	for (FPendingShot& Resolved : ResolvedShots) DeliverShot(Resolved);
+}
+
+FVector UHitscanSubsystem::GetBeamEndLocation(const FHitscanShot& Shot, const FHitResult& CrosshairHit)
+{
+	return CrosshairHit.bBlockingHit ? FVector(CrosshairHit.Location) : Shot.CrosshairEnd;
+}
+
+FVector UHitscanSubsystem::GetBarrelTraceEnd(const FHitscanShot& Shot, const FVector& BeamEnd)
+{
+	const FVector BarrelLocation{ Shot.BarrelTransform.GetLocation() };
+	const FVector StartToEnd{ BeamEnd - BarrelLocation };
+	return BarrelLocation + StartToEnd * 1.25f;
+}
+
+void UHitscanSubsystem::RequestCrosshairTrace(FPendingShot& Pending)
+{
+	INC_DWORD_STAT(STAT_HitscanAsyncTraces);
+	Pending.Stage = EShotStage::CrosshairTrace;
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Pending.Shot.CrosshairStart, Pending.Shot.CrosshairEnd, ECollisionChannel::ECC_Visibility,
+		FCollisionQueryParams::DefaultQueryParam, FCollisionResponseParams::DefaultResponseParam, &CrosshairTraceDelegate, Pending.Id);
+}
+
+void UHitscanSubsystem::RequestBarrelTrace(FPendingShot& Pending)
+{
+	INC_DWORD_STAT(STAT_HitscanAsyncTraces);
+	Pending.Stage = EShotStage::BarrelTrace;
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Pending.Shot.BarrelTransform.GetLocation(), GetBarrelTraceEnd(Pending.Shot, Pending.BeamEnd), ECollisionChannel::ECC_Visibility,
+		FCollisionQueryParams::DefaultQueryParam, FCollisionResponseParams::DefaultResponseParam, &BarrelTraceDelegate, Pending.Id);
+}
+
+void UHitscanSubsystem::OnCrosshairTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	FPendingShot* Pending = PendingShots.Find(TraceDatum.UserData);
+	if (Pending == nullptr) return;
+	const FHitResult CrosshairHit = TraceDatum.OutHits.Num() > 0 ? TraceDatum.OutHits[0] : FHitResult();
+	Pending->BeamEnd = GetBeamEndLocation(Pending->Shot, CrosshairHit);
+	Pending->Stage = EShotStage::CrosshairTraceDone;
+}
+
+void UHitscanSubsystem::OnBarrelTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	FPendingShot* Pending = PendingShots.Find(TraceDatum.UserData);
+	if (Pending == nullptr) return;
+	Pending->BarrelHit = TraceDatum.OutHits.Num() > 0 ? TraceDatum.OutHits[0] : FHitResult();
+	Pending->Stage = EShotStage::BarrelTraceDone;
+}
+
+void UHitscanSubsystem::DeliverShot(FPendingShot& Pending)
+{
+	FHitscanResult Result;
+	Result.BarrelTransform = Pending.Shot.BarrelTransform;
+	Result.Hit = Pending.BarrelHit;
+	Result.bBlockingHit = Result.Hit.bBlockingHit;
+	if (!Result.bBlockingHit) Result.Hit.Location = Pending.BeamEnd;
+
+	Pending.OnResolved.ExecuteIfBound(Result);
+}
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/WeaponFireScheduler.h"
+
+bool FWeaponFireScheduler::StartFiring(double Time, float Interval)
+{
+	if (IsCycling(Time)) return false;
+	NextShotTime = Time + ClampInterval(Interval);
+	bFiring = true;
+	return true;
+}
+
+int32 FWeaponFireScheduler::Advance(double Time, float Interval, bool bTriggerHeld, int32 MaxShots, double& OutFirstShotTime)
+{
+	OutFirstShotTime = NextShotTime;
+	if (!bTriggerHeld) bFiring = false;
+	if (!bFiring || MaxShots <= 0 || Time < NextShotTime) return 0;
+
+	//Every interval that has fully elapsed is a round, not just the first one
+	Interval = ClampInterval(Interval);
+	const int32 NumShots = FMath::Min(FMath::FloorToInt32((Time - NextShotTime) / Interval) + 1, MaxShots);
+	NextShotTime += NumShots * Interval;
+	return NumShots;
+}
+
+void FWeaponFireScheduler::StopFiring()
+{
+	bFiring = false;
+}
+
+void FWeaponFireScheduler::Reset()
+{
+	NextShotTime = 0.0;
+	bFiring = false;
+}
+
+float FWeaponFireScheduler::ClampInterval(float Interval)
+{
+	return FMath::Max(Interval, 0.001f);
+}
@@ -3,6 +3,10 @@
 
 #include "Enemy/Enemy.h"
 #include "Enemy/EnemyController.h"
+#include "Enemy/EnemySignificanceSubsystem.h"
+#include "Enemy/EnemyPerceptionSubsystem.h"
+#include "Enemy/EnemyCombatSubsystem.h"
+#include "Enemy/EnemyBehaviorTreeComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Kismet/GameplayStatics.h"
@@ -13,23 +17,35 @@
 #include "Components/CapsuleComponent.h"
 #include "Components/BoxComponent.h"
 #include "Characters/ArcoroxCharacter.h"
-
-AEnemy::AEnemy() :
+#include "HUD/ArcoroxPlayerController.h"
+#include "HUD/HitDamageComponent.h"
+#include "FX/FXSubsystem.h"
+#include "Combat/DamageQueueSubsystem.h"
+#include "Audio/GameplayAudioSubsystem.h"
+#include "Enemy/EnemyMeshComponent.h"
+
+AEnemy::AEnemy(const FObjectInitializer& ObjectInitializer) :
+	Super(ObjectInitializer.SetDefaultSubobjectClass<UEnemyMeshComponent>(ACharacter::MeshComponentName)),
 	Health(100.f),
 	MaxHealth(100.f),
 	HealthBarDisplayTime(5.f),
-	bCanHitReact(true),
 	MinHitReactTime(0.5f),
 	MaxHitReactTime(0.8f),
-	HitDamageDestroyTime(1.5f),
 	bStunned(false),
 	StunChance(0.5f),
 	bInAttackRange(false),
 	WeaponDamage(20.f),
 	LeftWeaponSocket(TEXT("FX_Trail_L_02")),
-	RightWeaponSocket(TEXT("FX_Trail_R_02"))
+	RightWeaponSocket(TEXT("FX_Trail_R_02")),
+	AggroTarget(nullptr),
+	PerceptionSphereCollision(ECollisionEnabled::QueryOnly),
+	CombatSubsystem(nullptr),
+	CombatSlot(INDEX_NONE),
+	SignificanceSubsystem(nullptr),
+	Significance(EEnemySignificance::Near)
 {
-	PrimaryActorTick.bCanEverTick = true;
+	//Nothing runs in the actor tick, movement, animation and the behavior tree tick on their own components
+	PrimaryActorTick.bCanEverTick = false;
 
 	AggroSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AggroSphere"));
 	AggroSphere->SetupAttachment(GetRootComponent());
@@ -41,6 +57,9 @@ AEnemy::AEnemy() :
 	LeftWeaponBox->SetupAttachment(GetMesh(), FName("LeftWeapon"));
 	RightWeaponBox = CreateDefaultSubobject<UBoxComponent>(TEXT("RightWeaponBox"));
 	RightWeaponBox->SetupAttachment(GetMesh(), FName("RightWeapon"));
+
+	//Significance from distance to the view decides which enemies the budget allocator updates less often
+	if (USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh())) BudgetedMesh->SetAutoCalculateSignificance(true);
 }
 
 void AEnemy::BeginPlay()
@@ -82,17 +101,57 @@ void AEnemy::BeginPlay()
 	const FVector WorldPatrolPoint2 = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint2);
 	if (EnemyController && EnemyController->GetBlackboardComponent() && BehaviorTree)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsVector(TEXT("PatrolPoint"), WorldPatrolPoint);
-		EnemyController->GetBlackboardComponent()->SetValueAsVector(TEXT("PatrolPoint2"), WorldPatrolPoint2);
+		EnemyController->SetPatrolPointKeys(WorldPatrolPoint, WorldPatrolPoint2);
 		EnemyController->RunBehaviorTree(BehaviorTree);
 	}
+	SignificanceSubsystem = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>();
+	if (SignificanceSubsystem) SignificanceSubsystem->RegisterEnemy(this);
+	CombatSubsystem = GetWorld()->GetSubsystem<UEnemyCombatSubsystem>();
+	if (CombatSubsystem) CombatSlot = CombatSubsystem->RegisterEnemy(this, Health, MaxHealth);
+	if (AggroSphere) PerceptionSphereCollision = AggroSphere->GetCollisionEnabled();
+	if (UEnemyPerceptionSubsystem* PerceptionSubsystem = GetWorld()->GetSubsystem<UEnemyPerceptionSubsystem>()) PerceptionSubsystem->RegisterEnemy(this);
 }
 
-void AEnemy::Tick(float DeltaTime)
+void AEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
+	if (SignificanceSubsystem) SignificanceSubsystem->UnregisterEnemy(this);
+	SignificanceSubsystem = nullptr;
+	if (UEnemyPerceptionSubsystem* PerceptionSubsystem = GetWorld()->GetSubsystem<UEnemyPerceptionSubsystem>()) PerceptionSubsystem->UnregisterEnemy(this);
+	if (CombatSubsystem) CombatSubsystem->UnregisterEnemy(CombatSlot);
+	CombatSlot = INDEX_NONE;
+
+	Super::EndPlay(EndPlayReason);
+}
 
-	UpdateHitDamages();
+void AEnemy::ApplySignificanceSettings(EEnemySignificance InSignificance, const FEnemySignificanceSettings& Settings)
+{
+	Significance = InSignificance;
+	UEnemyBehaviorTreeComponent* BehaviorTreeComponent = EnemyController ? Cast<UEnemyBehaviorTreeComponent>(EnemyController->GetBehaviorTreeComponent()) : nullptr;
+	if (BehaviorTreeComponent) BehaviorTreeComponent->SetThrottleInterval(Settings.BehaviorTreeTickInterval);
+	if (AggroSphere) AggroSphere->SetGenerateOverlapEvents(Settings.bOverlapsEnabled);
+	if (AttackRangeSphere) AttackRangeSphere->SetGenerateOverlapEvents(Settings.bOverlapsEnabled);
+}
+
+float AEnemy::GetOverlapRadius() const
+{
+	return FMath::Max(GetAggroRadius(), GetAttackRadius());
+}
+
+float AEnemy::GetAggroRadius() const
+{
+	return AggroSphere ? AggroSphere->GetScaledSphereRadius() : 0.f;
+}
+
+float AEnemy::GetAttackRadius() const
+{
+	return AttackRangeSphere ? AttackRangeSphere->GetScaledSphereRadius() : 0.f;
+}
+
+void AEnemy::SetPerceptionSpheresEnabled(bool bEnabled)
+{
+	const ECollisionEnabled::Type Collision = bEnabled ? PerceptionSphereCollision.GetValue() : ECollisionEnabled::NoCollision;
+	if (AggroSphere) AggroSphere->SetCollisionEnabled(Collision);
+	if (AttackRangeSphere) AttackRangeSphere->SetCollisionEnabled(Collision);
 }
 
 void AEnemy::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -103,45 +162,46 @@ void AEnemy::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 
 void AEnemy::StoreHitDamage(UUserWidget* Widget, FVector Location)
 {
-	HitDamages.Add(Widget, Location);
-	FTimerHandle HitDamageTimer;
-	FTimerDelegate HitDamageDelegate;
-	HitDamageDelegate.BindUFunction(this, FName("DestroyHitDamage"), Widget);
-	GetWorldTimerManager().SetTimer(HitDamageTimer, HitDamageDelegate, HitDamageDestroyTime, false);
+	if (Widget == nullptr) return;
+	APlayerController* OwningPlayer = Widget->GetOwningPlayer() ? Widget->GetOwningPlayer() : GetWorld()->GetFirstPlayerController();
+	AArcoroxPlayerController* PlayerController = Cast<AArcoroxPlayerController>(OwningPlayer);
+	if (PlayerController && PlayerController->GetHitDamageComponent()) PlayerController->GetHitDamageComponent()->TrackHitDamageWidget(Widget, Location);
+	else Widget->RemoveFromParent();
+}
+
+void AEnemy::DisplayHitDamage(AController* InstigatorController, int32 Damage, const FVector& HitLocation, bool bHeadshot)
+{
+	AArcoroxPlayerController* PlayerController = Cast<AArcoroxPlayerController>(InstigatorController);
+	UHitDamageComponent* HitDamageComponent = PlayerController ? PlayerController->GetHitDamageComponent() : nullptr;
+	if (HitDamageComponent && HitDamageComponent->ShowHitDamage(Damage, HitLocation, bHeadshot)) return;
+	ShowHitDamage(Damage, HitLocation, bHeadshot);
 }
 
 void AEnemy::SetStunned(bool Stunned)
 {
 	bStunned = Stunned;
-	if (EnemyController && EnemyController->GetBlackboardComponent())
-	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("Stunned"), bStunned);
-	}
+	if (CombatSlot != INDEX_NONE) CombatSubsystem->SetStunned(CombatSlot, bStunned);
+	if (EnemyController) EnemyController->SetStunnedKey(bStunned);
 }
 
 void AEnemy::SetInAttackRange(bool InRange)
 {
 	bInAttackRange = InRange;
-	if (EnemyController && EnemyController->GetBlackboardComponent())
-	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("InAttackRange"), bInAttackRange);
-	}
-}
-
-void AEnemy::DestroyHitDamage(UUserWidget* HitDamage)
-{
-	HitDamages.Remove(HitDamage);
-	HitDamage->RemoveFromParent();
+	if (CombatSlot != INDEX_NONE) CombatSubsystem->SetInAttackRange(CombatSlot, bInAttackRange);
+	if (EnemyController) EnemyController->SetInAttackRangeKey(bInAttackRange);
 }
 
 void AEnemy::AggroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
 	if (OtherActor == nullptr) return;
 	AArcoroxCharacter* ArcoroxCharacter = Cast<AArcoroxCharacter>(OtherActor);
-	if (ArcoroxCharacter && EnemyController && EnemyController->GetBlackboardComponent())
-	{
-		EnemyController->GetBlackboardComponent()->SetValueAsObject(TEXT("Target"), ArcoroxCharacter);
-	}
+	if (ArcoroxCharacter) SetAggroTarget(ArcoroxCharacter);
+}
+
+void AEnemy::SetAggroTarget(AArcoroxCharacter* Target)
+{
+	AggroTarget = Target;
+	if (EnemyController) EnemyController->SetTargetKey(AggroTarget);
 }
 
 void AEnemy::AttackRangeSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
@@ -167,7 +227,7 @@ void AEnemy::AttackRangeSphereEndOverlap(UPrimitiveComponent* OverlappedComponen
 void AEnemy::InflictDamage(AArcoroxCharacter* ArcoroxCharacter, const FName& WeaponSocket)
 {
 	if (ArcoroxCharacter == nullptr) return;
-	UGameplayStatics::ApplyDamage(ArcoroxCharacter, WeaponDamage, EnemyController, this, UDamageType::StaticClass());
+	UDamageQueueSubsystem::QueueDamage(this, ArcoroxCharacter, WeaponDamage, EnemyController, this, ArcoroxCharacter->GetActorLocation());
 	ArcoroxCharacter->PlayMeleeImpactSound();
 	ArcoroxCharacter->SpawnBloodParticles(GetMesh()->GetSocketTransform(WeaponSocket));
 }
@@ -188,45 +248,43 @@ void AEnemy::RightWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor
 
 void AEnemy::ShowHealthBar_Implementation()
 {
-	GetWorldTimerManager().ClearTimer(HealthBarDisplayTimer);
-	GetWorldTimerManager().SetTimer(HealthBarDisplayTimer, this, &AEnemy::HideHealthBar, HealthBarDisplayTime);
+	if (CombatSlot != INDEX_NONE) CombatSubsystem->ShowHealthBar(CombatSlot, HealthBarDisplayTime);
 }
 
-void AEnemy::Die()
+void AEnemy::OnHealthBarExpired()
 {
 	HideHealthBar();
 }
 
-void AEnemy::ResetHitReactTimer()
+bool AEnemy::IsInAttackRange() const
 {
-	bCanHitReact = true;
+	return CombatSlot != INDEX_NONE ? CombatSubsystem->IsInAttackRange(CombatSlot) : bInAttackRange;
 }
 
-void AEnemy::UpdateHitDamages()
+float AEnemy::GetHealth() const
 {
-	for (auto& HitPair : HitDamages)
-	{
-		UUserWidget* HitDamage = HitPair.Key;
-		const FVector HitLocation = HitPair.Value;
-		FVector2D ScreenPosition;
-		UGameplayStatics::ProjectWorldToScreen(GetWorld()->GetFirstPlayerController(), HitLocation, ScreenPosition);
-		HitDamage->SetPositionInViewport(ScreenPosition);
-	}
+	return CombatSlot != INDEX_NONE ? CombatSubsystem->GetHealth(CombatSlot) : Health;
+}
+
+void AEnemy::Die()
+{
+	if (CombatSlot != INDEX_NONE) CombatSubsystem->ClearHealthBar(CombatSlot);
+	HideHealthBar();
 }
 
 void AEnemy::PlayImpactSound()
 {
-	if (ImpactSound) UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
+	UGameplayAudioSubsystem::PlaySoundAtLocation(this, ImpactSound, GetActorLocation(), EGameplaySoundCategory::Impact);
 }
 
 void AEnemy::SpawnImpactParticles(FHitResult& HitResult)
 {
-	if (ImpactParticles) UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, HitResult.Location);
+	if (ImpactParticles) UFXSubsystem::SpawnEmitterAtLocation(this, ImpactParticles, HitResult.Location, EFXPriority::Budgeted);
 }
 
 void AEnemy::PlayHitMontage(FHitResult& HitResult, float PlayRate)
 {
-	if (!bCanHitReact) return;
+	if (CombatSlot == INDEX_NONE || !CombatSubsystem->TryStartHitReact(CombatSlot, FMath::FRandRange(MinHitReactTime, MaxHitReactTime))) return;
 	const FVector Forward = GetActorForwardVector();
 	const FVector Right = GetActorRightVector();
 	FVector Diff = HitResult.Location - GetActorLocation();
@@ -240,8 +298,6 @@ void AEnemy::PlayHitMontage(FHitResult& HitResult, float PlayRate)
 	else if (RightDotProduct >= 0.f && RightDotProduct <= 1.f) SectionName = FName("HitReactRight");
 	else if (RightDotProduct >= -1.f && RightDotProduct <= -0.f) SectionName = FName("HitReactLeft");
 	PlayMontageSection(HitMontage, SectionName, PlayRate);
-	bCanHitReact = false;
-	GetWorldTimerManager().SetTimer(HitReactTimer, this, &AEnemy::ResetHitReactTimer, FMath::FRandRange(MinHitReactTime, MaxHitReactTime));
 }
 
 void AEnemy::PlayAttackMontage(float PlayRate)
@@ -303,12 +359,9 @@ float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AC
 {
 	Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
 
-	if (Health - DamageAmount <= 0.f)
-	{
-		Health = 0.f;
-		Die();
-	}
-	else Health -= DamageAmount;
+	if (CombatSlot != INDEX_NONE) Health = CombatSubsystem->ApplyDamage(CombatSlot, DamageAmount);
+	else Health = FMath::Max(Health - DamageAmount, 0.f);
+	if (Health <= 0.f) Die();
 	return DamageAmount;
 }
 
@@ -4,7 +4,23 @@
 #include "Enemy/EnemyAnimInstance.h"
 #include "Enemy/Enemy.h"
 #include "GameFramework/CharacterMovementComponent.h"
-#include "Kismet/KismetMathLibrary.h"
+
+void FEnemyAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	const UEnemyAnimInstance* EnemyAnimInstance = CastChecked<UEnemyAnimInstance>(InAnimInstance);
+	bHasMovement = EnemyAnimInstance->Enemy && EnemyAnimInstance->EnemyCharacterMovement;
+	if (bHasMovement) Velocity = EnemyAnimInstance->EnemyCharacterMovement->Velocity;
+}
+
+void FEnemyAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	Super::Update(DeltaSeconds);
+
+	//Update runs before the graph is updated on this worker, so the graph reads this frame's Speed
+	if (bHasMovement) CastChecked<UEnemyAnimInstance>(GetAnimInstanceObject())->Speed = Velocity.Size2D();
+}
 
 UEnemyAnimInstance::UEnemyAnimInstance() :
 	Speed(0.f)
@@ -23,12 +39,12 @@ void UEnemyAnimInstance::NativeInitializeAnimation()
 	}
 }
 
-void UEnemyAnimInstance::NativeUpdateAnimation(float DeltaTime)
+FAnimInstanceProxy* UEnemyAnimInstance::CreateAnimInstanceProxy()
 {
-	Super::NativeUpdateAnimation(DeltaTime);
+	return new FEnemyAnimInstanceProxy(this);
+}
 
-	if (Enemy && EnemyCharacterMovement)
-	{
-		Speed = UKismetMathLibrary::VSizeXY(EnemyCharacterMovement->Velocity);
-	}
-}
\ No newline at end of file
+void UEnemyAnimInstance::DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy)
+{
+	delete InProxy;
+}
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyAnimationBudgetSubsystem.h"
+#include "IAnimationBudgetAllocator.h"
+#include "AnimationBudgetAllocatorParameters.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+static TAutoConsoleVariable<int32> CVarEnemyAnimBudgetEnabled(
+	TEXT("Arcorox.Enemy.AnimBudgetEnabled"),
+	1,
+	TEXT("1 lets the animation budget allocator throttle enemy mesh updates to stay within Arcorox.Enemy.AnimBudgetMs."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarEnemyAnimBudgetMs(
+	TEXT("Arcorox.Enemy.AnimBudgetMs"),
+	1.f,
+	TEXT("Game thread time in milliseconds that enemy animation updates may use per frame before distant enemies update less often."),
+	ECVF_Default);
+
+void UEnemyAnimationBudgetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	EnabledChangedHandle = CVarEnemyAnimBudgetEnabled->OnChangedDelegate().AddUObject(this, &UEnemyAnimationBudgetSubsystem::OnBudgetVariableChanged);
+	BudgetMsChangedHandle = CVarEnemyAnimBudgetMs->OnChangedDelegate().AddUObject(this, &UEnemyAnimationBudgetSubsystem::OnBudgetVariableChanged);
+}
+
+void UEnemyAnimationBudgetSubsystem::Deinitialize()
+{
+	CVarEnemyAnimBudgetEnabled->OnChangedDelegate().Remove(EnabledChangedHandle);
+	CVarEnemyAnimBudgetMs->OnChangedDelegate().Remove(BudgetMsChangedHandle);
+
+	Super::Deinitialize();
+}
+
+void UEnemyAnimationBudgetSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	ConfigureAnimationBudget();
+}
+
+bool UEnemyAnimationBudgetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	//The budget allocator only exists in game worlds
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemyAnimationBudgetSubsystem::ConfigureAnimationBudget()
+{
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(GetWorld());
+	if (Allocator == nullptr) return;
+	const bool bEnabled = CVarEnemyAnimBudgetEnabled.GetValueOnGameThread() != 0;
+	Allocator->SetEnabled(bEnabled);
+	if (!bEnabled) return;
+	FAnimationBudgetAllocatorParameters Parameters;
+	Parameters.BudgetInMs = FMath::Max(CVarEnemyAnimBudgetMs.GetValueOnGameThread(), 0.1f);
+	Allocator->SetParameters(Parameters);
+}
+
+void UEnemyAnimationBudgetSubsystem::OnBudgetVariableChanged(IConsoleVariable* Variable)
+{
+	//Changes made before play begins are picked up by OnWorldBeginPlay
+	if (GetWorld()->HasBegunPlay()) ConfigureAnimationBudget();
+}
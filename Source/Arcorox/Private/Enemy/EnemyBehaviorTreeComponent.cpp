@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyBehaviorTreeComponent.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemySignificanceSubsystem.h"
+#include "GameFramework/Controller.h"
+#include "Engine/World.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Behavior Tree Ticks Deferred"), STAT_BehaviorTreeTicksDeferred, STATGROUP_Arcorox);
+
+namespace
+{
+	/* Slack on the throttle interval so frame times summing to it are not deferred by float error */
+	constexpr double ThrottleTolerance = 1e-4;
+}
+
+void UEnemyBehaviorTreeComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	PendingDeltaTime += DeltaTime;
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double SinceLastTreeTick = Now - LastTreeTickTime;
+	if (SinceLastTreeTick + ThrottleTolerance < ThrottleInterval)
+	{
+		//The tree asked for this tick, throttled trees wait for the rest of the interval
+		INC_DWORD_STAT(STAT_BehaviorTreeTicksDeferred);
+		DeferTick(ThrottleInterval - SinceLastTreeTick);
+		return;
+	}
+
+	const float TreeDeltaTime = PendingDeltaTime;
+	PendingDeltaTime = 0.f;
+	LastTreeTickTime = Now;
+	{
+		const AController* Controller = Cast<AController>(GetOwner());
+		FScopedEnemyWorkTimer WorkTimer(Controller ? Cast<AEnemy>(Controller->GetPawn()) : nullptr, EEnemyWork::BehaviorTree);
+		Super::TickComponent(TreeDeltaTime, TickType, ThisTickFunction);
+	}
+	//The tree has scheduled its next tick from what its nodes need, which may be sooner than the throttle allows
+	DeferTick(ThrottleInterval);
+}
+
+void UEnemyBehaviorTreeComponent::SetThrottleInterval(float Interval)
+{
+	Interval = FMath::Max(Interval, 0.f);
+	const bool bShorter = Interval < ThrottleInterval;
+	ThrottleInterval = Interval;
+	if (!bShorter || !IsComponentTickEnabled() || GetWorld() == nullptr) return;
+
+	//A tick deferred by the old interval may be due sooner, the tree reschedules itself if it has nothing to do yet
+	const double Remaining = ThrottleInterval - (GetWorld()->GetTimeSeconds() - LastTreeTickTime);
+	if (GetComponentTickInterval() > Remaining) SetComponentTickIntervalAndCooldown(FMath::Max(static_cast<float>(Remaining), 0.f));
+}
+
+void UEnemyBehaviorTreeComponent::DeferTick(float Delay)
+{
+	if (Delay <= 0.f || !IsComponentTickEnabled() || GetComponentTickInterval() >= Delay) return;
+	SetComponentTickIntervalAndCooldown(Delay);
+}
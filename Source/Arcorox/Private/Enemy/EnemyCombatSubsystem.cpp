@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyCombatSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Engine/World.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Combat Records"), STAT_EnemyCombatRecords, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Health Bars Shown"), STAT_EnemyHealthBarsShown, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Enemy Combat Tick"), STAT_EnemyCombatTick, STATGROUP_Arcorox);
+
+void UEnemyCombatSubsystem::Deinitialize()
+{
+	Owners.Empty();
+	Health.Empty();
+	MaxHealth.Empty();
+	Stunned.Empty();
+	InAttackRange.Empty();
+	HitReactReadyTime.Empty();
+	HealthBarHideTime.Empty();
+	FreeSlots.Empty();
+	NumRecords = 0;
+	NumHealthBarsShown = 0;
+	SET_DWORD_STAT(STAT_EnemyCombatRecords, 0);
+	SET_DWORD_STAT(STAT_EnemyHealthBarsShown, 0);
+
+	Super::Deinitialize();
+}
+
+TStatId UEnemyCombatSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyCombatSubsystem, STATGROUP_Tickables);
+}
+
+int32 UEnemyCombatSubsystem::RegisterEnemy(AEnemy* Enemy, float InHealth, float InMaxHealth)
+{
+	int32 Slot;
+	if (FreeSlots.Num() > 0) Slot = FreeSlots.Pop(false);
+	else
+	{
+		Slot = Owners.AddDefaulted();
+		Health.AddDefaulted();
+		MaxHealth.AddDefaulted();
+		Stunned.AddDefaulted();
+		InAttackRange.AddDefaulted();
+		HitReactReadyTime.AddDefaulted();
+		HealthBarHideTime.AddDefaulted();
+	}
+	Owners[Slot] = Enemy;
+	Health[Slot] = InHealth;
+	MaxHealth[Slot] = InMaxHealth;
+	Stunned[Slot] = 0;
+	InAttackRange[Slot] = 0;
+	HitReactReadyTime[Slot] = 0.0;
+	HealthBarHideTime[Slot] = 0.0;
+	NumRecords++;
+	SET_DWORD_STAT(STAT_EnemyCombatRecords, NumRecords);
+	return Slot;
+}
+
+void UEnemyCombatSubsystem::UnregisterEnemy(int32 Slot)
+{
+	if (!Owners.IsValidIndex(Slot) || Owners[Slot] == nullptr) return;
+	ClearHealthBar(Slot);
+	Owners[Slot] = nullptr;
+	FreeSlots.Add(Slot);
+	NumRecords--;
+	SET_DWORD_STAT(STAT_EnemyCombatRecords, NumRecords);
+}
+
+void UEnemyCombatSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_EnemyCombatTick);
+	if (NumHealthBarsShown == 0) return;
+
+	//The Blueprint event may show the bar again or unregister the enemy, so the slot is cleared before raising it
+	const double Now = GetWorld()->GetTimeSeconds();
+	for (int32 Slot = 0; Slot < Owners.Num() && NumHealthBarsShown > 0; Slot++)
+	{
+		const double HideTime = HealthBarHideTime[Slot];
+		if (HideTime <= 0.0 || HideTime > Now) continue;
+		ClearHealthBar(Slot);
+		if (Owners[Slot]) Owners[Slot]->OnHealthBarExpired();
+	}
+}
+
+float UEnemyCombatSubsystem::ApplyDamage(int32 Slot, float DamageAmount)
+{
+	Health[Slot] = FMath::Max(Health[Slot] - DamageAmount, 0.f);
+	return Health[Slot];
+}
+
+bool UEnemyCombatSubsystem::CanHitReact(int32 Slot) const
+{
+	return HitReactReadyTime[Slot] <= GetWorld()->GetTimeSeconds();
+}
+
+bool UEnemyCombatSubsystem::TryStartHitReact(int32 Slot, float Cooldown)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (HitReactReadyTime[Slot] > Now) return false;
+	HitReactReadyTime[Slot] = Now + Cooldown;
+	return true;
+}
+
+void UEnemyCombatSubsystem::ShowHealthBar(int32 Slot, float Duration)
+{
+	if (HealthBarHideTime[Slot] <= 0.0) NumHealthBarsShown++;
+	HealthBarHideTime[Slot] = GetWorld()->GetTimeSeconds() + FMath::Max(Duration, KINDA_SMALL_NUMBER);
+	SET_DWORD_STAT(STAT_EnemyHealthBarsShown, NumHealthBarsShown);
+}
+
+void UEnemyCombatSubsystem::ClearHealthBar(int32 Slot)
+{
+	if (HealthBarHideTime[Slot] <= 0.0) return;
+	HealthBarHideTime[Slot] = 0.0;
+	NumHealthBarsShown--;
+	SET_DWORD_STAT(STAT_EnemyHealthBarsShown, NumHealthBarsShown);
+}
+
+void UEnemyCombatSubsystem::SetStunned(int32 Slot, bool bStunned)
+{
+	Stunned[Slot] = bStunned;
+}
+
+void UEnemyCombatSubsystem::SetInAttackRange(int32 Slot, bool bInAttackRange)
+{
+	InAttackRange[Slot] = bInAttackRange;
+}
@@ -2,15 +2,66 @@
 
 
 #include "Enemy/EnemyController.h"
+#include "Enemy/EnemyBehaviorTreeComponent.h"
 #include "BehaviorTree/BehaviorTree.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
 #include "Enemy/Enemy.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Blackboard Writes"), STAT_BlackboardWrites, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Blackboard Writes Skipped"), STAT_BlackboardWritesSkipped, STATGROUP_Arcorox);
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkBlackboardCommand(
+	TEXT("Arcorox.Enemy.BenchmarkBlackboard"),
+	TEXT("Arcorox.Enemy.BenchmarkBlackboard [Writes] - times InAttackRange writes on the first enemy controller by key name, by cached key ID, and by cached key ID with unchanged values skipped, and logs writes per second."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr) return;
+		AEnemyController* EnemyController = nullptr;
+		for (TActorIterator<AEnemyController> It(World); It; ++It)
+		{
+			if (It->GetBlackboardComponent() && It->GetBlackboardKeys().InAttackRange != FBlackboard::InvalidKey)
+			{
+				EnemyController = *It;
+				break;
+			}
+		}
+		if (EnemyController == nullptr) return;
+		const int32 Writes = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+		UBlackboardComponent* Blackboard = EnemyController->GetBlackboardComponent();
+		const FBlackboard::FKey Key = EnemyController->GetBlackboardKeys().InAttackRange;
+		const bool bOriginalValue = Blackboard->GetValue<UBlackboardKeyType_Bool>(Key);
+
+		//Every fourth write changes the value, like range checks that mostly report what they already did
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Writes; i++) Blackboard->SetValueAsBool(TEXT("InAttackRange"), (i / 4) % 2 == 0);
+		const double NameSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Writes; i++) Blackboard->SetValue<UBlackboardKeyType_Bool>(Key, (i / 4) % 2 == 0);
+		const double KeySeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Writes; i++) EnemyController->SetInAttackRangeKey((i / 4) % 2 == 0);
+		const double SkippedSeconds = FPlatformTime::Seconds() - StartTime;
+
+		EnemyController->SetInAttackRangeKey(bOriginalValue);
+		UE_LOG(LogArcorox, Log, TEXT("Blackboard writes, %d each: by name %.0f/s, by key %.0f/s, by key skipping unchanged %.0f/s"),
+			Writes, Writes / FMath::Max(NameSeconds, 1e-9), Writes / FMath::Max(KeySeconds, 1e-9), Writes / FMath::Max(SkippedSeconds, 1e-9));
+	}));
+
 AEnemyController::AEnemyController()
 {
 	BlackboardComponent = CreateDefaultSubobject<UBlackboardComponent>(TEXT("BlackboardComponent"));
-	BehaviorTreeComponent = CreateDefaultSubobject<UBehaviorTreeComponent>(TEXT("BehaviorTreeComponent"));
+	BehaviorTreeComponent = CreateDefaultSubobject<UEnemyBehaviorTreeComponent>(TEXT("BehaviorTreeComponent"));
+	//RunBehaviorTree starts the tree on the brain component, so it must be the throttled one
+	BrainComponent = BehaviorTreeComponent;
 	check(BlackboardComponent);
 	check(BehaviorTreeComponent);
 }
@@ -25,5 +76,51 @@ void AEnemyController::OnPossess(APawn* InPawn)
 	if (Enemy->GetBehaviorTree() && BlackboardComponent)
 	{
 		BlackboardComponent->InitializeBlackboard(*(Enemy->GetBehaviorTree()->BlackboardAsset));
+		ResolveBlackboardKeys();
+	}
+}
+
+void AEnemyController::ResolveBlackboardKeys()
+{
+	BlackboardKeys = FEnemyBlackboardKeys();
+	if (BlackboardComponent == nullptr) return;
+	BlackboardKeys.Target = BlackboardComponent->GetKeyID(TEXT("Target"));
+	BlackboardKeys.InAttackRange = BlackboardComponent->GetKeyID(TEXT("InAttackRange"));
+	BlackboardKeys.Stunned = BlackboardComponent->GetKeyID(TEXT("Stunned"));
+	BlackboardKeys.PatrolPoint = BlackboardComponent->GetKeyID(TEXT("PatrolPoint"));
+	BlackboardKeys.PatrolPoint2 = BlackboardComponent->GetKeyID(TEXT("PatrolPoint2"));
+}
+
+void AEnemyController::SetTargetKey(UObject* Target)
+{
+	SetBlackboardValue<UBlackboardKeyType_Object>(BlackboardKeys.Target, Target);
+}
+
+void AEnemyController::SetInAttackRangeKey(bool bInAttackRange)
+{
+	SetBlackboardValue<UBlackboardKeyType_Bool>(BlackboardKeys.InAttackRange, bInAttackRange);
+}
+
+void AEnemyController::SetStunnedKey(bool bStunned)
+{
+	SetBlackboardValue<UBlackboardKeyType_Bool>(BlackboardKeys.Stunned, bStunned);
+}
+
+void AEnemyController::SetPatrolPointKeys(const FVector& PatrolPoint, const FVector& PatrolPoint2)
+{
+	SetBlackboardValue<UBlackboardKeyType_Vector>(BlackboardKeys.PatrolPoint, PatrolPoint);
+	SetBlackboardValue<UBlackboardKeyType_Vector>(BlackboardKeys.PatrolPoint2, PatrolPoint2);
+}
+
+template<typename TDataClass>
+bool AEnemyController::SetBlackboardValue(FBlackboard::FKey Key, typename TDataClass::FDataType Value)
+{
+	if (BlackboardComponent == nullptr || Key == FBlackboard::InvalidKey) return false;
+	if (BlackboardComponent->GetValue<TDataClass>(Key) == Value)
+	{
+		INC_DWORD_STAT(STAT_BlackboardWritesSkipped);
+		return false;
 	}
+	INC_DWORD_STAT(STAT_BlackboardWrites);
+	return BlackboardComponent->SetValue<TDataClass>(Key, Value);
 }
@@ -0,0 +1,12 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyMeshComponent.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemySignificanceSubsystem.h"
+
+void UEnemyMeshComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	FScopedEnemyWorkTimer WorkTimer(Cast<AEnemy>(GetOwner()), EEnemyWork::Animation);
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+}
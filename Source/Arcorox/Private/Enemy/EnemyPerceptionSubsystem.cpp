@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyPerceptionSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Characters/ArcoroxCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Perception Hash Cells"), STAT_PerceptionHashCells, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Blackboard Writes"), STAT_PerceptionBlackboardWrites, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Perception Tick"), STAT_PerceptionTick, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<int32> CVarPerceptionUseSpatialHash(
+	TEXT("Arcorox.Enemy.Perception.UseSpatialHash"),
+	1,
+	TEXT("1 finds players in enemy aggro and attack range with a spatial hash, 0 uses the enemy overlap spheres."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarPerceptionCellSize(
+	TEXT("Arcorox.Enemy.Perception.CellSize"),
+	1000.f,
+	TEXT("Size of a spatial hash cell, around the largest aggro radius works best."),
+	ECVF_Default);
+
+void UEnemyPerceptionSubsystem::Deinitialize()
+{
+	Enemies.Empty();
+	Targets.Empty();
+	Cells.Empty();
+	SET_DWORD_STAT(STAT_PerceptionHashCells, 0);
+
+	Super::Deinitialize();
+}
+
+TStatId UEnemyPerceptionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyPerceptionSubsystem, STATGROUP_Tickables);
+}
+
+void UEnemyPerceptionSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || Enemies.Contains(Enemy)) return;
+	Enemies.Add(Enemy);
+	Enemy->SetPerceptionSpheresEnabled(!bUsingSpatialHash);
+}
+
+void UEnemyPerceptionSubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	Enemies.RemoveSingleSwap(Enemy, false);
+}
+
+void UEnemyPerceptionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_PerceptionTick);
+
+	const bool bUseSpatialHash = CVarPerceptionUseSpatialHash.GetValueOnGameThread() != 0;
+	if (bUseSpatialHash != bUsingSpatialHash) SetUsingSpatialHash(bUseSpatialHash);
+	if (!bUsingSpatialHash) return;
+	BuildHash();
+	UpdatePerception();
+}
+
+float UEnemyPerceptionSubsystem::GetDistanceToCapsule(const FVector& Location, const FVector& CapsuleCenter, float CapsuleRadius, float CapsuleHalfHeight)
+{
+	//Closest point on the capsule's vertical segment, then out by the capsule radius
+	const float SegmentHalfLength = FMath::Max(CapsuleHalfHeight - CapsuleRadius, 0.f);
+	const FVector SegmentPoint(CapsuleCenter.X, CapsuleCenter.Y, FMath::Clamp(Location.Z, CapsuleCenter.Z - SegmentHalfLength, CapsuleCenter.Z + SegmentHalfLength));
+	return FMath::Max(FVector::Dist(Location, SegmentPoint) - CapsuleRadius, 0.f);
+}
+
+void UEnemyPerceptionSubsystem::BuildHash()
+{
+	CellSize = FMath::Max(CVarPerceptionCellSize.GetValueOnGameThread(), 100.f);
+	for (TPair<FIntPoint, TArray<FHashEntry, TInlineAllocator<4>>>& Cell : Cells) Cell.Value.Reset();
+
+	Targets.Reset();
+	MaxTargetRadius = 0.f;
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		AArcoroxCharacter* Target = Iterator->IsValid() ? Cast<AArcoroxCharacter>(Iterator->Get()->GetPawn()) : nullptr;
+		if (Target == nullptr) continue;
+		const UCapsuleComponent* Capsule = Target->GetCapsuleComponent();
+		const FVector Location = Capsule ? Capsule->GetComponentLocation() : Target->GetActorLocation();
+		const float Radius = Capsule ? Capsule->GetScaledCapsuleRadius() : 0.f;
+		const float HalfHeight = Capsule ? Capsule->GetScaledCapsuleHalfHeight() : 0.f;
+		MaxTargetRadius = FMath::Max(MaxTargetRadius, Radius);
+		Cells.FindOrAdd(GetCell(Location)).Add(FHashEntry{ Location, Radius, HalfHeight, Targets.Add(Target) });
+	}
+	//Cells emptied by targets moving away are dropped once they pile up
+	if (Cells.Num() > Targets.Num() * 4) Cells = Cells.FilterByPredicate([](const TPair<FIntPoint, TArray<FHashEntry, TInlineAllocator<4>>>& Cell) { return Cell.Value.Num() > 0; });
+	SET_DWORD_STAT(STAT_PerceptionHashCells, Cells.Num());
+}
+
+void UEnemyPerceptionSubsystem::UpdatePerception()
+{
+	if (Targets.Num() == 0) return;
+	for (AEnemy* Enemy : Enemies)
+	{
+		if (Enemy == nullptr) continue;
+		const FVector Location = Enemy->GetActorLocation();
+		const float AggroRadius = Enemy->GetAggroRadius();
+		const float AttackRadius = Enemy->GetAttackRadius();
+		//Capsule centres up to the largest capsule radius outside aggro range can still touch the aggro sphere
+		const FIntPoint MinCell = GetCell(Location - FVector(AggroRadius + MaxTargetRadius));
+		const FIntPoint MaxCell = GetCell(Location + FVector(AggroRadius + MaxTargetRadius));
+
+		//Distances are to the target capsule surface, so targets are in range when the sphere would overlap their capsule
+		AArcoroxCharacter* ClosestTarget = nullptr;
+		float ClosestDistance = AggroRadius;
+		for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+			{
+				const TArray<FHashEntry, TInlineAllocator<4>>* Cell = Cells.Find(FIntPoint(X, Y));
+				if (Cell == nullptr) continue;
+				for (const FHashEntry& Entry : *Cell)
+				{
+					const float Distance = GetDistanceToCapsule(Location, Entry.Location, Entry.Radius, Entry.HalfHeight);
+					if (Distance > ClosestDistance) continue;
+					ClosestDistance = Distance;
+					ClosestTarget = Targets[Entry.Index];
+				}
+			}
+		}
+
+		//Like the aggro sphere, a target is acquired on entering aggro range and kept afterwards
+		if (ClosestTarget && Enemy->GetAggroTarget() == nullptr)
+		{
+			Enemy->SetAggroTarget(ClosestTarget);
+			INC_DWORD_STAT(STAT_PerceptionBlackboardWrites);
+		}
+		const bool bInAttackRange = ClosestTarget && ClosestDistance <= AttackRadius;
+		if (bInAttackRange != Enemy->IsInAttackRange())
+		{
+			Enemy->SetInAttackRange(bInAttackRange);
+			INC_DWORD_STAT(STAT_PerceptionBlackboardWrites);
+		}
+	}
+}
+
+void UEnemyPerceptionSubsystem::SetUsingSpatialHash(bool bUseSpatialHash)
+{
+	bUsingSpatialHash = bUseSpatialHash;
+	for (AEnemy* Enemy : Enemies)
+	{
+		if (Enemy) Enemy->SetPerceptionSpheresEnabled(!bUsingSpatialHash);
+	}
+	if (!bUsingSpatialHash)
+	{
+		Cells.Empty();
+		Targets.Empty();
+		SET_DWORD_STAT(STAT_PerceptionHashCells, 0);
+	}
+}
+
+FIntPoint UEnemyPerceptionSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
@@ -0,0 +1,232 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemySignificanceSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemies Near"), STAT_EnemiesNear, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemies Visible"), STAT_EnemiesVisible, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemies Distant"), STAT_EnemiesDistant, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemies Hidden"), STAT_EnemiesHidden, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Significance Changes"), STAT_EnemySignificanceChanges, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Enemy Significance Tick"), STAT_EnemySignificanceTick, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<int32> CVarEnemySignificanceEnabled(
+	TEXT("Arcorox.Enemy.Significance.Enabled"),
+	1,
+	TEXT("1 scales enemy update rates by significance, 0 keeps every enemy in the Near bucket."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarEnemySignificanceNearDistance(
+	TEXT("Arcorox.Enemy.Significance.NearDistance"),
+	1500.f,
+	TEXT("Enemies closer than this to the camera, or than their aggro radius plus a margin, are Near."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarEnemySignificanceVisibleDistance(
+	TEXT("Arcorox.Enemy.Significance.VisibleDistance"),
+	5000.f,
+	TEXT("Enemies in front of the camera closer than this are Visible, farther ones are Distant."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorldAndArgs DumpEnemySignificanceCommand(
+	TEXT("Arcorox.Enemy.DumpSignificance"),
+	TEXT("Arcorox.Enemy.DumpSignificance [Seconds=2] - times the animation and behavior tree ticks of each significance bucket for Seconds, then logs enemies, update rates and measured cost per bucket."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const float Seconds = Args.Num() > 0 ? FMath::Max(FCString::Atof(*Args[0]), 0.1f) : 2.f;
+		if (UEnemySignificanceSubsystem* Subsystem = World ? World->GetSubsystem<UEnemySignificanceSubsystem>() : nullptr) Subsystem->BeginCostCapture(Seconds);
+	}));
+
+namespace
+{
+	const FEnemySignificanceSettings BucketSettings[] =
+	{
+		/* Near */ { 0.f, true },
+		/* Visible */ { 0.1f, true },
+		/* Distant */ { 0.25f, true },
+		/* Hidden */ { 0.5f, false },
+	};
+	static_assert(UE_ARRAY_COUNT(BucketSettings) == static_cast<int32>(EEnemySignificance::MAX), "Every significance bucket needs settings");
+
+	/* Cosine of the half angle in front of the camera counted as in view, a little wider than the field of view */
+	constexpr float ViewConeCos = 0.5f;
+
+	/* Extra distance on top of the aggro radius within which an enemy is always Near */
+	constexpr float OverlapRadiusMargin = 500.f;
+}
+
+void UEnemySignificanceSubsystem::Deinitialize()
+{
+	Enemies.Empty();
+	Significances.Empty();
+	bCapturingCost = false;
+	SET_DWORD_STAT(STAT_EnemiesNear, 0);
+	SET_DWORD_STAT(STAT_EnemiesVisible, 0);
+	SET_DWORD_STAT(STAT_EnemiesDistant, 0);
+	SET_DWORD_STAT(STAT_EnemiesHidden, 0);
+
+	Super::Deinitialize();
+}
+
+TStatId UEnemySignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UEnemySignificanceSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || Enemies.Contains(Enemy)) return;
+	Enemies.Add(Enemy);
+	Significances.Add(EEnemySignificance::Near);
+	Enemy->ApplySignificanceSettings(EEnemySignificance::Near, GetSettings(EEnemySignificance::Near));
+}
+
+void UEnemySignificanceSubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	const int32 Index = Enemies.Find(Enemy);
+	if (Index == INDEX_NONE) return;
+	Enemies.RemoveAtSwap(Index, 1, false);
+	Significances.RemoveAtSwap(Index, 1, false);
+}
+
+void UEnemySignificanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_EnemySignificanceTick);
+	const double StartTime = FPlatformTime::Seconds();
+	if (bCapturingCost)
+	{
+		CaptureFrames++;
+		if (StartTime >= CaptureEndTime)
+		{
+			bCapturingCost = false;
+			CaptureSeconds = StartTime - CaptureStartTime;
+			DumpBuckets();
+		}
+	}
+
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (PlayerController == nullptr || PlayerController->PlayerCameraManager == nullptr) return;
+	const FVector CameraLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+	const FVector CameraDirection = PlayerController->PlayerCameraManager->GetCameraRotation().Vector();
+	const bool bEnabled = CVarEnemySignificanceEnabled.GetValueOnGameThread() != 0;
+
+	int32 BucketCounts[static_cast<int32>(EEnemySignificance::MAX)] = {};
+	for (int32 Index = 0; Index < Enemies.Num(); Index++)
+	{
+		AEnemy* Enemy = Enemies[Index];
+		if (Enemy == nullptr) continue;
+		const EEnemySignificance Significance = bEnabled ? CalculateSignificance(Enemy, CameraLocation, CameraDirection) : EEnemySignificance::Near;
+		BucketCounts[static_cast<int32>(Significance)]++;
+		if (Significance == Significances[Index]) continue;
+		Significances[Index] = Significance;
+		Enemy->ApplySignificanceSettings(Significance, GetSettings(Significance));
+		INC_DWORD_STAT(STAT_EnemySignificanceChanges);
+	}
+	SET_DWORD_STAT(STAT_EnemiesNear, BucketCounts[static_cast<int32>(EEnemySignificance::Near)]);
+	SET_DWORD_STAT(STAT_EnemiesVisible, BucketCounts[static_cast<int32>(EEnemySignificance::Visible)]);
+	SET_DWORD_STAT(STAT_EnemiesDistant, BucketCounts[static_cast<int32>(EEnemySignificance::Distant)]);
+	SET_DWORD_STAT(STAT_EnemiesHidden, BucketCounts[static_cast<int32>(EEnemySignificance::Hidden)]);
+	LastBucketingSeconds = FPlatformTime::Seconds() - StartTime;
+}
+
+EEnemySignificance UEnemySignificanceSubsystem::CalculateSignificance(const AEnemy* Enemy, const FVector& CameraLocation, const FVector& CameraDirection) const
+{
+	const FVector ToEnemy = Enemy->GetActorLocation() - CameraLocation;
+	const float DistanceSquared = ToEnemy.SizeSquared();
+	//Never throttle an enemy the player could already be overlapping
+	const float NearDistance = FMath::Max(CVarEnemySignificanceNearDistance.GetValueOnGameThread(), Enemy->GetOverlapRadius() + OverlapRadiusMargin);
+	if (DistanceSquared <= FMath::Square(NearDistance)) return EEnemySignificance::Near;
+	const bool bInView = FVector::DotProduct(ToEnemy, CameraDirection) >= ViewConeCos * FMath::Sqrt(DistanceSquared);
+	if (!bInView) return EEnemySignificance::Hidden;
+	if (DistanceSquared <= FMath::Square(CVarEnemySignificanceVisibleDistance.GetValueOnGameThread())) return EEnemySignificance::Visible;
+	return EEnemySignificance::Distant;
+}
+
+void UEnemySignificanceSubsystem::BeginCostCapture(float Seconds)
+{
+	FMemory::Memzero(WorkSeconds);
+	FMemory::Memzero(WorkUpdates);
+	bCapturingCost = true;
+	CaptureStartTime = FPlatformTime::Seconds();
+	CaptureEndTime = CaptureStartTime + Seconds;
+	CaptureSeconds = 0.0;
+	CaptureFrames = 0;
+	UE_LOG(LogArcorox, Log, TEXT("Enemy significance: measuring bucket cost for %.1f s"), Seconds);
+}
+
+void UEnemySignificanceSubsystem::AddWorkTime(EEnemySignificance Significance, EEnemyWork Work, double Seconds)
+{
+	const int32 BucketIndex = static_cast<int32>(Significance);
+	const int32 WorkIndex = static_cast<int32>(Work);
+	if (BucketIndex >= static_cast<int32>(EEnemySignificance::MAX) || WorkIndex >= static_cast<int32>(EEnemyWork::MAX)) return;
+	WorkSeconds[BucketIndex][WorkIndex] += Seconds;
+	WorkUpdates[BucketIndex][WorkIndex]++;
+}
+
+void UEnemySignificanceSubsystem::DumpBuckets() const
+{
+	int32 BucketCounts[static_cast<int32>(EEnemySignificance::MAX)] = {};
+	for (const EEnemySignificance Significance : Significances) BucketCounts[static_cast<int32>(Significance)]++;
+	//Enemies can change bucket during the capture, so the costs cover the bucket and not the enemies counted at the end
+	const double Seconds = FMath::Max(CaptureSeconds, 1e-6);
+	const int32 Frames = FMath::Max(CaptureFrames, 1);
+
+	UE_LOG(LogArcorox, Log, TEXT("Enemy significance: %d enemies, bucketing took %.4f ms, measured over %.2f s and %d frames"), Enemies.Num(), LastBucketingSeconds * 1000.0, CaptureSeconds, CaptureFrames);
+	for (int32 Index = 0; Index < static_cast<int32>(EEnemySignificance::MAX); Index++)
+	{
+		const EEnemySignificance Significance = static_cast<EEnemySignificance>(Index);
+		const FEnemySignificanceSettings& Settings = GetSettings(Significance);
+		const int32 Animation = static_cast<int32>(EEnemyWork::Animation);
+		const int32 BehaviorTree = static_cast<int32>(EEnemyWork::BehaviorTree);
+		UE_LOG(LogArcorox, Log, TEXT("  %-8s %4d enemies | behavior tree %.2fs, overlaps %s | anim %.0f/s %.4f ms/frame, behavior tree %.0f/s %.4f ms/frame"),
+			GetSignificanceName(Significance), BucketCounts[Index], Settings.BehaviorTreeTickInterval, Settings.bOverlapsEnabled ? TEXT("on") : TEXT("off"),
+			WorkUpdates[Index][Animation] / Seconds, WorkSeconds[Index][Animation] * 1000.0 / Frames,
+			WorkUpdates[Index][BehaviorTree] / Seconds, WorkSeconds[Index][BehaviorTree] * 1000.0 / Frames);
+	}
+}
+
+const FEnemySignificanceSettings& UEnemySignificanceSubsystem::GetSettings(EEnemySignificance Significance)
+{
+	return BucketSettings[FMath::Min(static_cast<int32>(Significance), static_cast<int32>(EEnemySignificance::MAX) - 1)];
+}
+
+const TCHAR* UEnemySignificanceSubsystem::GetSignificanceName(EEnemySignificance Significance)
+{
+	switch (Significance)
+	{
+	case EEnemySignificance::Near:
+		return TEXT("Near");
+	case EEnemySignificance::Visible:
+		return TEXT("Visible");
+	case EEnemySignificance::Distant:
+		return TEXT("Distant");
+	case EEnemySignificance::Hidden:
+		return TEXT("Hidden");
+	default:
+		return TEXT("Unknown");
+	}
+}
+
+FScopedEnemyWorkTimer::FScopedEnemyWorkTimer(const AEnemy* Enemy, EEnemyWork InWork) :
+	Subsystem(Enemy ? Enemy->GetSignificanceSubsystem() : nullptr),
+	Significance(EEnemySignificance::Near),
+	Work(InWork),
+	StartTime(0.0)
+{
+	if (Subsystem && !Subsystem->IsCapturingCost()) Subsystem = nullptr;
+	if (Subsystem == nullptr) return;
+	Significance = Enemy->GetSignificance();
+	StartTime = FPlatformTime::Seconds();
+}
+
+FScopedEnemyWorkTimer::~FScopedEnemyWorkTimer()
+{
+	if (Subsystem) Subsystem->AddWorkTime(Significance, Work, FPlatformTime::Seconds() - StartTime);
+}
@@ -4,8 +4,12 @@
 #include "Explosive/Explosive.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Kismet/GameplayStatics.h"
+#include "Pooling/ActorPoolSubsystem.h"
+#include "FX/FXSubsystem.h"
+#include "Audio/GameplayAudioSubsystem.h"
 
-AExplosive::AExplosive()
+AExplosive::AExplosive() :
+	bExploded(false)
 {
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -25,18 +29,37 @@ void AExplosive::Tick(float DeltaTime)
 
 void AExplosive::SpawnExplosionParticles(FHitResult& HitResult)
 {
-	if (ExplosionParticles) UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionParticles, HitResult.Location);
+	if (ExplosionParticles) UFXSubsystem::SpawnEmitterAtLocation(this, ExplosionParticles, HitResult.Location, EFXPriority::Critical);
 }
 
 void AExplosive::PlayExplosionSound()
 {
-	if (ExplosionSound) UGameplayStatics::PlaySoundAtLocation(this, ExplosionSound, GetActorLocation());
+	UGameplayAudioSubsystem::PlaySoundAtLocation(this, ExplosionSound, GetActorLocation(), EGameplaySoundCategory::Explosion);
 }
 
 void AExplosive::Hit_Implementation(FHitResult HitResult)
 {
+	if (bExploded) return;
+	bExploded = true;
 	PlayExplosionSound();
 	SpawnExplosionParticles(HitResult);
-	Destroy();
+	UActorPoolSubsystem::ReleaseOrDestroy(this);
 }
 
+void AExplosive::OnAcquiredFromPool()
+{
+	bExploded = false;
+	//Particle components of the Blueprint start over as if spawned
+	TInlineComponentArray<UParticleSystemComponent*> ParticleComponents(this);
+	for (UParticleSystemComponent* ParticleComponent : ParticleComponents)
+	{
+		if (ParticleComponent->bAutoActivate) ParticleComponent->Activate(true);
+	}
+}
+
+void AExplosive::OnReleasedToPool()
+{
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	TInlineComponentArray<UParticleSystemComponent*> ParticleComponents(this);
+	for (UParticleSystemComponent* ParticleComponent : ParticleComponents) ParticleComponent->DeactivateImmediate();
+}
@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FX/FXSubsystem.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("FX Spawn Requests"), STAT_FXSpawnRequests, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FX Spawned"), STAT_FXSpawned, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FX Coalesced"), STAT_FXCoalesced, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FX Culled By Frame Budget"), STAT_FXCulledByFrameBudget, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FX Culled By Distance"), STAT_FXCulledByDistance, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<int32> CVarFXMaxBudgetedSpawnsPerFrame(
+	TEXT("Arcorox.FX.MaxBudgetedSpawnsPerFrame"),
+	16,
+	TEXT("Maximum number of budgeted effects (impacts, blood, beams) spawned per frame, 0 for no limit."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarFXMaxBudgetedDistance(
+	TEXT("Arcorox.FX.MaxBudgetedDistance"),
+	10000.f,
+	TEXT("Budgeted effects farther than this from the camera are not spawned, 0 for no limit."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarFXCoalesceRadius(
+	TEXT("Arcorox.FX.CoalesceRadius"),
+	25.f,
+	TEXT("Budgeted effects of the same template spawned within this distance of each other in one frame share an emitter, 0 disables coalescing."),
+	ECVF_Default);
+
+void UFXSubsystem::Deinitialize()
+{
+	FrameSpawns.Empty();
+
+	Super::Deinitialize();
+}
+
+UParticleSystemComponent* UFXSubsystem::SpawnEmitter(UParticleSystem* Template, const FTransform& Transform, EFXPriority Priority, bool bAllowCoalesce)
+{
+	if (Template == nullptr) return nullptr;
+	INC_DWORD_STAT(STAT_FXSpawnRequests);
+	BeginFrameIfNeeded();
+
+	const FVector Location = Transform.GetLocation();
+	if (Priority == EFXPriority::Budgeted)
+	{
+		const float CoalesceRadius = CVarFXCoalesceRadius.GetValueOnGameThread();
+		if (bAllowCoalesce && CoalesceRadius > 0.f)
+		{
+			for (const FFrameSpawn& Spawn : FrameSpawns)
+			{
+				if (Spawn.Template == Template && FVector::DistSquared(Spawn.Location, Location) <= FMath::Square(CoalesceRadius))
+				{
+					INC_DWORD_STAT(STAT_FXCoalesced);
+					return Spawn.Component;
+				}
+			}
+		}
+		const int32 MaxSpawnsPerFrame = CVarFXMaxBudgetedSpawnsPerFrame.GetValueOnGameThread();
+		if (MaxSpawnsPerFrame > 0 && NumBudgetedSpawns >= MaxSpawnsPerFrame)
+		{
+			INC_DWORD_STAT(STAT_FXCulledByFrameBudget);
+			return nullptr;
+		}
+		const float MaxDistance = CVarFXMaxBudgetedDistance.GetValueOnGameThread();
+		if (MaxDistance > 0.f && bHasCameraLocation && FVector::DistSquared(CameraLocation, Location) > FMath::Square(MaxDistance))
+		{
+			INC_DWORD_STAT(STAT_FXCulledByDistance);
+			return nullptr;
+		}
+	}
+
+	//The world particle pool reuses finished components of the same template
+	UParticleSystemComponent* Component = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), Template, Transform, false, EPSCPoolMethod::AutoRelease);
+	if (Component) INC_DWORD_STAT(STAT_FXSpawned);
+	if (Component && Priority == EFXPriority::Budgeted)
+	{
+		NumBudgetedSpawns++;
+		if (bAllowCoalesce) FrameSpawns.Add(FFrameSpawn{ Template, Location, Component });
+	}
+	return Component;
+}
+
+UParticleSystemComponent* UFXSubsystem::SpawnEmitterAtLocation(const UObject* WorldContextObject, UParticleSystem* Template, const FTransform& Transform, EFXPriority Priority, bool bAllowCoalesce)
+{
+	if (WorldContextObject == nullptr || Template == nullptr) return nullptr;
+	UWorld* World = WorldContextObject->GetWorld();
+	if (World == nullptr) return nullptr;
+	if (UFXSubsystem* FXSubsystem = World->GetSubsystem<UFXSubsystem>()) return FXSubsystem->SpawnEmitter(Template, Transform, Priority, bAllowCoalesce);
+	return UGameplayStatics::SpawnEmitterAtLocation(World, Template, Transform, false, EPSCPoolMethod::AutoRelease);
+}
+
+UParticleSystemComponent* UFXSubsystem::SpawnEmitterAtLocation(const UObject* WorldContextObject, UParticleSystem* Template, const FVector& Location, EFXPriority Priority, bool bAllowCoalesce)
+{
+	return SpawnEmitterAtLocation(WorldContextObject, Template, FTransform(Location), Priority, bAllowCoalesce);
+}
+
+void UFXSubsystem::BeginFrameIfNeeded()
+{
+	if (BudgetFrame == GFrameCounter) return;
+	BudgetFrame = GFrameCounter;
+	NumBudgetedSpawns = 0;
+	FrameSpawns.Reset();
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	bHasCameraLocation = PlayerController && PlayerController->PlayerCameraManager;
+	if (bHasCameraLocation) CameraLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+}
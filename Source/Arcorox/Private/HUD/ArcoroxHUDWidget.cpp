@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HUD/ArcoroxHUDWidget.h"
+#include "HUD/ArcoroxPlayerController.h"
+#include "Engine/World.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("HUD Widget Pull"), STAT_HUDWidgetPull, STATGROUP_Arcorox);
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkHUDWidgetsCommand(
+	TEXT("Arcorox.HUD.BenchmarkWidgets"),
+	TEXT("Arcorox.HUD.BenchmarkWidgets [NumWidgets] [NumFrames] - adds the HUD overlay to the viewport NumWidgets times and logs Slate tick and paint time per frame, refreshed every frame and on a new snapshot. Use stat slate for the tick/paint split."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 NumWidgets = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 20;
+		const int32 NumFrames = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 300;
+		const AArcoroxPlayerController* PlayerController = World ? Cast<AArcoroxPlayerController>(World->GetFirstPlayerController()) : nullptr;
+		//The shipped overlay is what players pay for, the native base class stands in when there is none
+		TSubclassOf<UUserWidget> WidgetClass = PlayerController && PlayerController->GetHUDOverlayClass() ? PlayerController->GetHUDOverlayClass() : TSubclassOf<UUserWidget>(UArcoroxHUDWidget::StaticClass());
+		UArcoroxHUDWidget::BenchmarkUpdates(World, WidgetClass, NumWidgets, NumFrames);
+	}));
+
+void UArcoroxHUDWidget::SetDataSource(UHUDDataComponent* InDataSource)
+{
+	DataSource = InDataSource;
+	SeenVersion = 0;
+}
+
+void UArcoroxHUDWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+{
+	Super::NativeTick(MyGeometry, InDeltaTime);
+	PullSnapshot();
+}
+
+bool UArcoroxHUDWidget::PullSnapshot(bool bForce)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HUDWidgetPull);
+	if (DataSource == nullptr)
+	{
+		const AArcoroxPlayerController* PlayerController = Cast<AArcoroxPlayerController>(GetOwningPlayer());
+		if (PlayerController) DataSource = PlayerController->GetHUDDataComponent();
+	}
+	if (DataSource == nullptr || (!bForce && DataSource->GetVersion() == SeenVersion)) return false;
+	SeenVersion = DataSource->GetVersion();
+	OnHUDSnapshotChanged(DataSource->GetSnapshot());
+	return true;
+}
+
+void UArcoroxHUDWidget::BenchmarkUpdates(UWorld* World, TSubclassOf<UUserWidget> WidgetClass, int32 NumWidgets, int32 NumFrames)
+{
+	if (World == nullptr || WidgetClass == nullptr) return;
+	if (!FSlateApplication::IsInitialized() || World->GetGameViewport() == nullptr)
+	{
+		UE_LOG(LogArcorox, Warning, TEXT("HUD widget benchmark needs Slate and a game viewport, run it in a game or PIE session"));
+		return;
+	}
+	const bool bArcoroxHUD = WidgetClass->IsChildOf<UArcoroxHUDWidget>();
+	if (!bArcoroxHUD) UE_LOG(LogArcorox, Warning, TEXT("%s is not a UArcoroxHUDWidget, timing it with its own property bindings only"), *WidgetClass->GetName());
+	UHUDDataComponent* DataModel = NewObject<UHUDDataComponent>(GetTransientPackage());
+	FSlateApplication& SlateApplication = FSlateApplication::Get();
+
+	//The displayed values change on one frame in ten, as ammo and spread do during normal play
+	auto RunPass = [&](bool bRefreshEveryFrame, const TCHAR* Description)
+	{
+		TArray<UUserWidget*> Widgets;
+		Widgets.Reserve(NumWidgets);
+		for (int32 i = 0; i < NumWidgets; i++)
+		{
+			UUserWidget* Widget = CreateWidget<UUserWidget>(World, WidgetClass);
+			if (Widget == nullptr) continue;
+			if (UArcoroxHUDWidget* ArcoroxHUD = Cast<UArcoroxHUDWidget>(Widget)) ArcoroxHUD->SetDataSource(DataModel);
+			Widget->AddToViewport();
+			Widgets.Add(Widget);
+		}
+		//First tick builds and lays out the new widgets and is not part of the steady state
+		SlateApplication.Tick();
+
+		FHUDSnapshot Snapshot = DataModel->GetSnapshot();
+		double RefreshSeconds = 0.0;
+		double SlateSeconds = 0.0;
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			if (Frame % 10 == 0)
+			{
+				Snapshot.MagazineAmmo = Frame % 30;
+				Snapshot.CrosshairSpread = (Frame % 20) * 0.1f;
+				DataModel->Publish(Snapshot);
+			}
+			double StartTime = FPlatformTime::Seconds();
+			if (bRefreshEveryFrame)
+			{
+				for (UUserWidget* Widget : Widgets)
+				{
+					if (UArcoroxHUDWidget* ArcoroxHUD = Cast<UArcoroxHUDWidget>(Widget)) ArcoroxHUD->PullSnapshot(true);
+				}
+			}
+			RefreshSeconds += FPlatformTime::Seconds() - StartTime;
+			//Ticks every widget, where bindings are polled and changed snapshots are pulled, then prepasses and paints the windows
+			StartTime = FPlatformTime::Seconds();
+			SlateApplication.Tick();
+			SlateSeconds += FPlatformTime::Seconds() - StartTime;
+		}
+		UE_LOG(LogArcorox, Log, TEXT("HUD widgets %s: %d x %s, %d frames, forced refresh %.3f ms/frame, Slate tick and paint %.3f ms/frame"),
+			Description, Widgets.Num(), *WidgetClass->GetName(), NumFrames, RefreshSeconds * 1000.0 / NumFrames, SlateSeconds * 1000.0 / NumFrames);
+
+		for (UUserWidget* Widget : Widgets) Widget->RemoveFromParent();
+		SlateApplication.Tick();
+	};
+	if (bArcoroxHUD)
+	{
+		RunPass(true, TEXT("refreshed every frame"));
+		RunPass(false, TEXT("refreshed on change"));
+	}
+	else RunPass(false, TEXT("with property bindings"));
+}
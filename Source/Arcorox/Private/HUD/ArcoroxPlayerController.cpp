@@ -3,10 +3,16 @@
 
 #include "HUD/ArcoroxPlayerController.h"
 #include "Blueprint/UserWidget.h"
+#include "HUD/HitDamageComponent.h"
+#include "HUD/HUDDataComponent.h"
+#include "HUD/ArcoroxHUDWidget.h"
+#include "Arcorox/Arcorox.h"
 
-AArcoroxPlayerController::AArcoroxPlayerController()
+AArcoroxPlayerController::AArcoroxPlayerController() :
+	OverlaySnapshotFunction(nullptr)
 {
-
+	HitDamageComponent = CreateDefaultSubobject<UHitDamageComponent>(TEXT("HitDamageComponent"));
+	HUDDataComponent = CreateDefaultSubobject<UHUDDataComponent>(TEXT("HUDDataComponent"));
 }
 
 void AArcoroxPlayerController::BeginPlay()
@@ -20,6 +26,39 @@ void AArcoroxPlayerController::BeginPlay()
 		{
 			HUDOverlay->AddToViewport();
 			HUDOverlay->SetVisibility(ESlateVisibility::Visible);
+			if (UArcoroxHUDWidget* ArcoroxHUD = Cast<UArcoroxHUDWidget>(HUDOverlay)) ArcoroxHUD->SetDataSource(HUDDataComponent);
+			else BindOverlaySnapshotFallback();
 		}
 	}
 }
+
+void AArcoroxPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (HUDDataComponent) HUDDataComponent->OnSnapshotPublished.Remove(OverlaySnapshotHandle);
+	OverlaySnapshotHandle.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AArcoroxPlayerController::BindOverlaySnapshotFallback()
+{
+	//Overlays made before UArcoroxHUDWidget keep their property bindings until reparented, but still get snapshots if they declare the event themselves
+	UFunction* Function = HUDOverlay->FindFunction(TEXT("OnHUDSnapshotChanged"));
+	const FStructProperty* SnapshotParam = Function && Function->NumParms == 1 ? CastField<FStructProperty>(Function->PropertyLink) : nullptr;
+	if (SnapshotParam == nullptr || SnapshotParam->Struct != FHUDSnapshot::StaticStruct() || Function->ParmsSize != sizeof(FHUDSnapshot))
+	{
+		UE_LOG(LogArcorox, Warning, TEXT("HUD overlay %s is not a UArcoroxHUDWidget and has no OnHUDSnapshotChanged(FHUDSnapshot), so it keeps polling its bindings every frame. Reparent it to ArcoroxHUDWidget."), *HUDOverlayClass->GetName());
+		return;
+	}
+	OverlaySnapshotFunction = Function;
+	OverlaySnapshotHandle = HUDDataComponent->OnSnapshotPublished.AddUObject(this, &AArcoroxPlayerController::ForwardSnapshotToOverlay);
+	ForwardSnapshotToOverlay(HUDDataComponent->GetSnapshot());
+}
+
+void AArcoroxPlayerController::ForwardSnapshotToOverlay(const FHUDSnapshot& Snapshot)
+{
+	if (HUDOverlay == nullptr || OverlaySnapshotFunction == nullptr) return;
+	//The snapshot is the only parameter, so a copy of it is the parameter buffer
+	FHUDSnapshot Params = Snapshot;
+	HUDOverlay->ProcessEvent(OverlaySnapshotFunction, &Params);
+}
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HUD/HUDDataComponent.h"
+#include "Characters/ArcoroxCharacter.h"
+#include "Items/Weapon.h"
+#include "Items/InventoryComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("HUD Snapshots Published"), STAT_HUDSnapshotsPublished, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("HUD Snapshots Unchanged"), STAT_HUDSnapshotsUnchanged, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<float> CVarHUDSpreadEpsilon(
+	TEXT("Arcorox.HUD.SpreadEpsilon"),
+	0.005f,
+	TEXT("Smallest crosshair spread change that publishes a new HUD snapshot."),
+	ECVF_Default);
+
+namespace
+{
+	int32 FieldBit(EHUDField Field)
+	{
+		return 1 << static_cast<int32>(Field);
+	}
+}
+
+UHUDDataComponent::UHUDDataComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	//Sample after the character has finished its frame
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+	Snapshot.CarriedAmmo.Init(0, static_cast<int32>(EAmmoType::EAT_MAX));
+}
+
+void UHUDDataComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	if (PlayerController) UpdateFromCharacter(Cast<AArcoroxCharacter>(PlayerController->GetPawn()));
+}
+
+bool UHUDDataComponent::UpdateFromCharacter(const AArcoroxCharacter* Character)
+{
+	if (Character == nullptr) return false;
+	Sampled.CarriedAmmo.SetNumZeroed(static_cast<int32>(EAmmoType::EAT_MAX), false);
+	if (const UInventoryComponent* Inventory = Character->GetInventoryComponent())
+	{
+		for (int32 i = 0; i < Sampled.CarriedAmmo.Num(); i++) Sampled.CarriedAmmo[i] = Inventory->GetAmmo(static_cast<EAmmoType>(i));
+	}
+	const AWeapon* Weapon = Character->GetEquippedWeapon();
+	Sampled.MagazineAmmo = Weapon ? Weapon->GetAmmo() : 0;
+	Sampled.EquippedAmmoType = Weapon ? Weapon->GetAmmoType() : EAmmoType::EAT_MAX;
+	Sampled.CrosshairSpread = Character->GetCrosshairSpreadMultiplier();
+	Sampled.CombatState = Character->GetCombatState();
+	return Publish(Sampled);
+}
+
+bool UHUDDataComponent::Publish(const FHUDSnapshot& InSnapshot)
+{
+	int32 ChangedFields = 0;
+	if (InSnapshot.MagazineAmmo != Snapshot.MagazineAmmo || InSnapshot.EquippedAmmoType != Snapshot.EquippedAmmoType) ChangedFields |= FieldBit(EHUDField::EHF_MagazineAmmo);
+	if (InSnapshot.CarriedAmmo != Snapshot.CarriedAmmo) ChangedFields |= FieldBit(EHUDField::EHF_CarriedAmmo);
+	if (FMath::Abs(InSnapshot.CrosshairSpread - Snapshot.CrosshairSpread) > CVarHUDSpreadEpsilon.GetValueOnGameThread()) ChangedFields |= FieldBit(EHUDField::EHF_CrosshairSpread);
+	if (InSnapshot.CombatState != Snapshot.CombatState) ChangedFields |= FieldBit(EHUDField::EHF_CombatState);
+	if (ChangedFields == 0)
+	{
+		INC_DWORD_STAT(STAT_HUDSnapshotsUnchanged);
+		return false;
+	}
+
+	//Spread below the epsilon keeps its published value so small drifts cannot accumulate unseen
+	const float PublishedSpread = Snapshot.CrosshairSpread;
+	const int32 Version = Snapshot.Version;
+	Snapshot = InSnapshot;
+	if ((ChangedFields & FieldBit(EHUDField::EHF_CrosshairSpread)) == 0) Snapshot.CrosshairSpread = PublishedSpread;
+	Snapshot.Version = Version + 1;
+	Snapshot.ChangedFields = ChangedFields;
+	INC_DWORD_STAT(STAT_HUDSnapshotsPublished);
+	OnSnapshotPublished.Broadcast(Snapshot);
+	return true;
+}
+
+bool UHUDDataComponent::HasFieldChanged(const FHUDSnapshot& InSnapshot, EHUDField Field)
+{
+	return Field < EHUDField::EHF_MAX && (InSnapshot.ChangedFields & FieldBit(Field)) != 0;
+}
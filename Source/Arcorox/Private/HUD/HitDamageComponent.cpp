@@ -0,0 +1,221 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HUD/HitDamageComponent.h"
+#include "HUD/HitDamageWidget.h"
+#include "Animation/WidgetAnimation.h"
+#include "UObject/ConstructorHelpers.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hit Damage Widgets Pooled"), STAT_HitDamageWidgetsPooled, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hit Damage Widgets Active"), STAT_HitDamageWidgetsActive, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Damage Widget Allocations"), STAT_HitDamageWidgetAllocations, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Damage Widget Allocations Avoided"), STAT_HitDamageWidgetAllocationsAvoided, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Hit Damage Update"), STAT_HitDamageUpdate, STATGROUP_Arcorox);
+
+UHitDamageComponent::UHitDamageComponent() :
+	HitDamageLifetime(1.5f),
+	MaxActiveHitDamages(64),
+	HitDamageProperty(nullptr),
+	HeadshotProperty(nullptr),
+	HitDamageAnimationProperty(nullptr),
+	ActiveHead(0),
+	NumActive(0)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	//Only ticks while there are numbers on screen
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	//The widget the enemies created per hit, so numbers are pooled without the controller Blueprint setting a class
+	static ConstructorHelpers::FClassFinder<UUserWidget> HitDamageWidgetClassFinder(TEXT("/Game/Dynamic/Blueprints/HUD/WBP_HitDamage"));
+	if (HitDamageWidgetClassFinder.Succeeded()) HitDamageWidgetClass = HitDamageWidgetClassFinder.Class;
+}
+
+void UHitDamageComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	DEC_DWORD_STAT_BY(STAT_HitDamageWidgetsPooled, PooledWidgets.Num());
+	DEC_DWORD_STAT_BY(STAT_HitDamageWidgetsActive, NumActive);
+	ActiveHitDamages.Empty();
+	ActiveLocations.Empty();
+	ScreenPositions.Empty();
+	OnScreen.Empty();
+	PooledWidgets.Empty();
+	FreeWidgets.Empty();
+	TrackedWidgets.Empty();
+	ActiveHead = 0;
+	NumActive = 0;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UHitDamageComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	SCOPE_CYCLE_COUNTER(STAT_HitDamageUpdate);
+
+	//Numbers expire in the order they were added, so only the head needs checking
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+	while (NumActive > 0 && ActiveHitDamages[ActiveHead].ExpireTime <= CurrentTime)
+	{
+		RetireHitDamage(ActiveHitDamages[ActiveHead]);
+		ActiveHead = (ActiveHead + 1) % ActiveHitDamages.Num();
+		NumActive--;
+		DEC_DWORD_STAT(STAT_HitDamageWidgetsActive);
+	}
+
+	if (NumActive == 0)
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+	UpdateScreenPositions();
+}
+
+bool UHitDamageComponent::ShowHitDamage(int32 Damage, const FVector& HitLocation, bool bHeadshot)
+{
+	if (HitDamageWidgetClass == nullptr) return false;
+	UUserWidget* Widget = AcquireWidget();
+	if (Widget == nullptr) return false;
+	Widget->SetVisibility(ESlateVisibility::HitTestInvisible);
+	SetWidgetHitDamage(Widget, Damage, bHeadshot);
+	AddActiveHitDamage(Widget, HitLocation, true);
+	return true;
+}
+
+void UHitDamageComponent::TrackHitDamageWidget(UUserWidget* Widget, const FVector& Location)
+{
+	if (Widget == nullptr) return;
+	TrackedWidgets.Add(Widget);
+	AddActiveHitDamage(Widget, Location, false);
+}
+
+void UHitDamageComponent::AddActiveHitDamage(UUserWidget* Widget, const FVector& Location, bool bPooled)
+{
+	if (ActiveHitDamages.Num() != MaxActiveHitDamages)
+	{
+		//Capacity changed or first use, retire everything and resize the ring
+		for (int32 i = 0; i < NumActive; i++) RetireHitDamage(ActiveHitDamages[(ActiveHead + i) % ActiveHitDamages.Num()]);
+		DEC_DWORD_STAT_BY(STAT_HitDamageWidgetsActive, NumActive);
+		ActiveHitDamages.SetNum(FMath::Max(MaxActiveHitDamages, 1));
+		MaxActiveHitDamages = ActiveHitDamages.Num();
+		ActiveLocations.SetNumZeroed(MaxActiveHitDamages);
+		ScreenPositions.SetNumZeroed(MaxActiveHitDamages);
+		OnScreen.SetNumZeroed(MaxActiveHitDamages);
+		ActiveHead = 0;
+		NumActive = 0;
+	}
+	if (NumActive == ActiveHitDamages.Num())
+	{
+		//Buffer full, the oldest number makes room
+		RetireHitDamage(ActiveHitDamages[ActiveHead]);
+		ActiveHead = (ActiveHead + 1) % ActiveHitDamages.Num();
+		NumActive--;
+		DEC_DWORD_STAT(STAT_HitDamageWidgetsActive);
+	}
+
+	const int32 Index = (ActiveHead + NumActive) % ActiveHitDamages.Num();
+	FActiveHitDamage& HitDamage = ActiveHitDamages[Index];
+	ActiveLocations[Index] = Location;
+	HitDamage.Widget = Widget;
+	HitDamage.ExpireTime = GetWorld()->GetTimeSeconds() + HitDamageLifetime;
+	HitDamage.bPooled = bPooled;
+	NumActive++;
+	INC_DWORD_STAT(STAT_HitDamageWidgetsActive);
+
+	SetComponentTickEnabled(true);
+	//Position the new number right away, the rest are updated on tick
+	FVector2D ScreenPosition;
+	if (ScreenProjection.CaptureForFrame(GetOwningPlayerController()) && ScreenProjection.Project(Location, ScreenPosition)) Widget->SetPositionInViewport(ScreenPosition);
+}
+
+void UHitDamageComponent::RetireHitDamage(const FActiveHitDamage& HitDamage)
+{
+	if (HitDamage.Widget == nullptr) return;
+	if (HitDamage.bPooled)
+	{
+		HitDamage.Widget->SetVisibility(ESlateVisibility::Collapsed);
+		FreeWidgets.Add(HitDamage.Widget);
+	}
+	else
+	{
+		HitDamage.Widget->RemoveFromParent();
+		TrackedWidgets.RemoveSingleSwap(HitDamage.Widget, false);
+	}
+}
+
+UUserWidget* UHitDamageComponent::AcquireWidget()
+{
+	if (FreeWidgets.Num() > 0)
+	{
+		INC_DWORD_STAT(STAT_HitDamageWidgetAllocationsAvoided);
+		return FreeWidgets.Pop(false);
+	}
+
+	APlayerController* PlayerController = GetOwningPlayerController();
+	if (PlayerController == nullptr) return nullptr;
+	UUserWidget* Widget = CreateWidget<UUserWidget>(PlayerController, HitDamageWidgetClass);
+	if (Widget == nullptr) return nullptr;
+	//Pooled widgets stay in the viewport and are collapsed while free
+	Widget->AddToViewport();
+	PooledWidgets.Add(Widget);
+	INC_DWORD_STAT(STAT_HitDamageWidgetAllocations);
+	INC_DWORD_STAT(STAT_HitDamageWidgetsPooled);
+	return Widget;
+}
+
+void UHitDamageComponent::SetWidgetHitDamage(UUserWidget* Widget, int32 Damage, bool bHeadshot)
+{
+	if (UHitDamageWidget* HitDamageWidget = Cast<UHitDamageWidget>(Widget))
+	{
+		HitDamageWidget->SetHitDamage(Damage, bHeadshot);
+		return;
+	}
+
+	if (WidgetVariablesClass.Get() != Widget->GetClass()) CacheWidgetVariables(Widget->GetClass());
+	if (HitDamageProperty)
+	{
+		void* HitDamageValue = HitDamageProperty->ContainerPtrToValuePtr<void>(Widget);
+		if (HitDamageProperty->IsInteger()) HitDamageProperty->SetIntPropertyValue(HitDamageValue, static_cast<int64>(Damage));
+		else HitDamageProperty->SetFloatingPointPropertyValue(HitDamageValue, static_cast<double>(Damage));
+	}
+	if (HeadshotProperty) HeadshotProperty->SetPropertyValue_InContainer(Widget, bHeadshot);
+	//The animation played on Construct when the widget was created per hit, replay it for every reuse
+	if (HitDamageAnimationProperty)
+	{
+		if (UWidgetAnimation* HitDamageAnimation = Cast<UWidgetAnimation>(HitDamageAnimationProperty->GetObjectPropertyValue_InContainer(Widget))) Widget->PlayAnimation(HitDamageAnimation);
+	}
+}
+
+void UHitDamageComponent::CacheWidgetVariables(UClass* WidgetClass)
+{
+	WidgetVariablesClass = WidgetClass;
+	HitDamageProperty = CastField<FNumericProperty>(WidgetClass->FindPropertyByName(TEXT("HitDamage")));
+	HeadshotProperty = CastField<FBoolProperty>(WidgetClass->FindPropertyByName(TEXT("Headshot")));
+	HitDamageAnimationProperty = CastField<FObjectProperty>(WidgetClass->FindPropertyByName(TEXT("HitDamageAnimation")));
+}
+
+void UHitDamageComponent::UpdateScreenPositions()
+{
+	if (!ScreenProjection.CaptureForFrame(GetOwningPlayerController())) return;
+
+	//The live range of the ring is at most two contiguous runs
+	const int32 Capacity = ActiveHitDamages.Num();
+	const int32 FirstRun = FMath::Min(NumActive, Capacity - ActiveHead);
+	const int32 SecondRun = NumActive - FirstRun;
+	ScreenProjection.ProjectPoints(MakeArrayView(ActiveLocations).Slice(ActiveHead, FirstRun), MakeArrayView(ScreenPositions).Slice(ActiveHead, FirstRun), MakeArrayView(OnScreen).Slice(ActiveHead, FirstRun));
+	if (SecondRun > 0) ScreenProjection.ProjectPoints(MakeArrayView(ActiveLocations).Slice(0, SecondRun), MakeArrayView(ScreenPositions).Slice(0, SecondRun), MakeArrayView(OnScreen).Slice(0, SecondRun));
+
+	for (int32 i = 0; i < NumActive; i++)
+	{
+		const int32 Index = (ActiveHead + i) % Capacity;
+		UUserWidget* Widget = ActiveHitDamages[Index].Widget;
+		if (Widget && OnScreen[Index]) Widget->SetPositionInViewport(ScreenPositions[Index]);
+	}
+}
+
+APlayerController* UHitDamageComponent::GetOwningPlayerController() const
+{
+	return Cast<APlayerController>(GetOwner());
+}
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HUD/InventoryBarWidget.h"
+#include "Characters/ArcoroxCharacter.h"
+#include "GameFramework/PlayerController.h"
+
+bool UInventoryBarWidget::IsSlotChanged(const FInventoryViewState& State, int32 Slot)
+{
+	return Slot >= 0 && Slot < 32 && (State.ChangedSlotMask & (1 << Slot)) != 0;
+}
+
+bool UInventoryBarWidget::IsAmmoChanged(const FInventoryViewState& State, EAmmoType AmmoType)
+{
+	return AmmoType < EAmmoType::EAT_MAX && (State.ChangedAmmoMask & (1 << static_cast<int32>(AmmoType))) != 0;
+}
+
+void UInventoryBarWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+{
+	Super::NativeTick(MyGeometry, InDeltaTime);
+
+	if (ViewModel == nullptr) ViewModel = FindViewModel();
+	if (ViewModel == nullptr || ViewModel->GetVersion() == SeenVersion) return;
+	SeenVersion = ViewModel->GetVersion();
+	OnInventoryUpdated(ViewModel->GetState());
+}
+
+UInventoryViewModel* UInventoryBarWidget::FindViewModel() const
+{
+	const APlayerController* PlayerController = GetOwningPlayer();
+	const AArcoroxCharacter* Character = PlayerController ? Cast<AArcoroxCharacter>(PlayerController->GetPawn()) : nullptr;
+	return Character ? Character->GetInventoryViewModel() : nullptr;
+}
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HUD/InventoryViewModel.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Inventory Events"), STAT_InventoryEvents, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Inventory Notifications Sent"), STAT_InventoryNotificationsSent, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Inventory Notifications Coalesced"), STAT_InventoryNotificationsCoalesced, STATGROUP_Arcorox);
+
+void UInventoryViewModel::MarkSlotChanged(int32 Slot)
+{
+	if (Slot < 0 || Slot >= 32) return;
+	PendingSlotMask |= 1 << Slot;
+	NoteEvent();
+}
+
+void UInventoryViewModel::MarkAmmoChanged(EAmmoType AmmoType)
+{
+	if (AmmoType >= EAmmoType::EAT_MAX) return;
+	PendingAmmoMask |= 1 << static_cast<int32>(AmmoType);
+	NoteEvent();
+}
+
+void UInventoryViewModel::SetEquippedSlot(int32 Slot)
+{
+	PendingEquippedSlot = Slot;
+	NoteEvent();
+}
+
+void UInventoryViewModel::SetHighlightedSlot(int32 Slot)
+{
+	PendingHighlightedSlot = Slot;
+	NoteEvent();
+}
+
+void UInventoryViewModel::NoteEvent()
+{
+	INC_DWORD_STAT(STAT_InventoryEvents);
+	NumPendingEvents++;
+}
+
+bool UInventoryViewModel::Flush()
+{
+	if (NumPendingEvents == 0) return false;
+	const bool bChanged = PendingSlotMask != 0 || PendingAmmoMask != 0 || PendingEquippedSlot != State.EquippedSlot || PendingHighlightedSlot != State.HighlightedSlot;
+	//Every event beyond the one notification, or all of them if they cancelled out, was coalesced
+	INC_DWORD_STAT_BY(STAT_InventoryNotificationsCoalesced, bChanged ? NumPendingEvents - 1 : NumPendingEvents);
+	NumPendingEvents = 0;
+	if (!bChanged) return false;
+
+	State.PreviousEquippedSlot = State.EquippedSlot;
+	State.EquippedSlot = PendingEquippedSlot;
+	State.PreviousHighlightedSlot = State.HighlightedSlot;
+	State.HighlightedSlot = PendingHighlightedSlot;
+	State.ChangedSlotMask = PendingSlotMask;
+	State.ChangedAmmoMask = PendingAmmoMask;
+	State.Version++;
+	PendingSlotMask = 0;
+	PendingAmmoMask = 0;
+	INC_DWORD_STAT(STAT_InventoryNotificationsSent);
+	return true;
+}
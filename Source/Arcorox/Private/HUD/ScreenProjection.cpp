@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HUD/ScreenProjection.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "Kismet/GameplayStatics.h"
+#include "SceneView.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Screen Projection Captures"), STAT_ScreenProjectionCaptures, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Screen Projection Points"), STAT_ScreenProjectionPoints, STATGROUP_Arcorox);
+
+bool FScreenProjection::Capture(const APlayerController* PlayerController)
+{
+	bValid = false;
+	CaptureFrame = GFrameCounter;
+	const ULocalPlayer* LocalPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+	if (LocalPlayer == nullptr || LocalPlayer->ViewportClient == nullptr) return false;
+	FSceneViewProjectionData ProjectionData;
+	if (!LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, ProjectionData)) return false;
+	Capture(ProjectionData);
+	return true;
+}
+
+void FScreenProjection::Capture(const FSceneViewProjectionData& ProjectionData)
+{
+	INC_DWORD_STAT(STAT_ScreenProjectionCaptures);
+	CaptureFrame = GFrameCounter;
+	const FMatrix ViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix();
+	ClipX = FVector4(ViewProjectionMatrix.M[0][0], ViewProjectionMatrix.M[1][0], ViewProjectionMatrix.M[2][0], ViewProjectionMatrix.M[3][0]);
+	ClipY = FVector4(ViewProjectionMatrix.M[0][1], ViewProjectionMatrix.M[1][1], ViewProjectionMatrix.M[2][1], ViewProjectionMatrix.M[3][1]);
+	ClipW = FVector4(ViewProjectionMatrix.M[0][3], ViewProjectionMatrix.M[1][3], ViewProjectionMatrix.M[2][3], ViewProjectionMatrix.M[3][3]);
+	const FIntRect ViewRect = ProjectionData.GetConstrainedViewRect();
+	ViewMin = FVector2D(ViewRect.Min.X, ViewRect.Min.Y);
+	ViewSize = FVector2D(ViewRect.Width(), ViewRect.Height());
+	bValid = true;
+}
+
+bool FScreenProjection::CaptureForFrame(const APlayerController* PlayerController)
+{
+	if (bValid && CaptureFrame == GFrameCounter) return true;
+	return Capture(PlayerController);
+}
+
+bool FScreenProjection::Project(const FVector& WorldLocation, FVector2D& OutScreenPosition) const
+{
+	bool bOnScreen = false;
+	ProjectPoints(MakeArrayView(&WorldLocation, 1), MakeArrayView(&OutScreenPosition, 1), MakeArrayView(&bOnScreen, 1));
+	return bOnScreen;
+}
+
+void FScreenProjection::ProjectPoints(TArrayView<const FVector> WorldLocations, TArrayView<FVector2D> OutScreenPositions, TArrayView<bool> OutOnScreen) const
+{
+	check(OutScreenPositions.Num() == WorldLocations.Num() && OutOnScreen.Num() == WorldLocations.Num());
+	INC_DWORD_STAT_BY(STAT_ScreenProjectionPoints, WorldLocations.Num());
+	if (!bValid)
+	{
+		for (bool& bOnScreen : OutOnScreen) bOnScreen = false;
+		return;
+	}
+
+	//Same math as FSceneView::ProjectWorldToScreen with the matrix unpacked into the three columns that matter,
+	//a branch-free loop the compiler can vectorize
+	const FVector2D HalfSize = ViewSize * 0.5;
+	const FVector2D Center = ViewMin + HalfSize;
+	for (int32 i = 0; i < WorldLocations.Num(); i++)
+	{
+		const FVector& P = WorldLocations[i];
+		const double X = P.X * ClipX.X + P.Y * ClipX.Y + P.Z * ClipX.Z + ClipX.W;
+		const double Y = P.X * ClipY.X + P.Y * ClipY.Y + P.Z * ClipY.Z + ClipY.W;
+		const double W = P.X * ClipW.X + P.Y * ClipW.Y + P.Z * ClipW.Z + ClipW.W;
+		const bool bInFront = W > 0.0;
+		const double RHW = bInFront ? 1.0 / W : 0.0;
+		OutScreenPositions[i] = FVector2D(Center.X + X * RHW * HalfSize.X, Center.Y - Y * RHW * HalfSize.Y);
+		OutOnScreen[i] = bInFront;
+	}
+}
+
+/* Projects 1, 100 and 10,000 points in front of the camera per point through UGameplayStatics and in one FScreenProjection pass, and logs the timings */
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkScreenProjectionCommand(
+	TEXT("Arcorox.HUD.BenchmarkProjection"),
+	TEXT("Arcorox.HUD.BenchmarkProjection [Iterations] - projects 1, 100 and 10000 world points with UGameplayStatics::ProjectWorldToScreen and with FScreenProjection, and logs the time per point. Correctness is covered by the Arcorox.HUD.ScreenProjection automation test."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+		if (PlayerController == nullptr) return;
+		const int32 Iterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		FRandomStream Random(1234);
+
+		for (const int32 NumPoints : { 1, 100, 10000 })
+		{
+			TArray<FVector> Points;
+			Points.SetNumUninitialized(NumPoints);
+			for (FVector& Point : Points) Point = ViewLocation + ViewRotation.RotateVector(FVector(Random.FRandRange(100.f, 5000.f), Random.FRandRange(-2000.f, 2000.f), Random.FRandRange(-1000.f, 1000.f)));
+			FVector2D ReferencePosition;
+			TArray<FVector2D> BatchPositions;
+			BatchPositions.SetNumZeroed(NumPoints);
+			TArray<bool> OnScreen;
+			OnScreen.SetNumZeroed(NumPoints);
+
+			double StartTime = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+			{
+				for (int32 i = 0; i < NumPoints; i++) UGameplayStatics::ProjectWorldToScreen(PlayerController, Points[i], ReferencePosition);
+			}
+			const double ReferenceMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+			{
+				FScreenProjection Projection;
+				Projection.Capture(PlayerController);
+				Projection.ProjectPoints(Points, BatchPositions, OnScreen);
+			}
+			const double BatchMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+			const double PointCount = static_cast<double>(NumPoints) * Iterations;
+			UE_LOG(LogArcorox, Display, TEXT("%5d points: per point %.1f ns/point, batched %.1f ns/point (%.1fx)"),
+				NumPoints, ReferenceMs * 1.0e6 / PointCount, BatchMs * 1.0e6 / PointCount, ReferenceMs / FMath::Max(BatchMs, 1.0e-6));
+		}
+	}));
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/InventoryComponent.h"
+#include "Items/Item.h"
+
+UInventoryComponent::UInventoryComponent() :
+	Capacity(6),
+	FreeSlotMask(0)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	bWantsInitializeComponent = true;
+	FMemory::Memzero(AmmoCounts);
+}
+
+void UInventoryComponent::InitializeComponent()
+{
+	Super::InitializeComponent();
+	//The free slot mask is not saved, so every inventory starts out empty at Capacity
+	SetCapacity(Capacity);
+}
+
+void UInventoryComponent::SetCapacity(int32 NewCapacity)
+{
+	Capacity = FMath::Clamp(NewCapacity, 1, MaxCapacity);
+	Slots.Init(nullptr, Capacity);
+	FreeSlotMask = Capacity == MaxCapacity ? MAX_uint32 : (1u << Capacity) - 1u;
+}
+
+int32 UInventoryComponent::AddItem(AItem* Item)
+{
+	if (Item == nullptr) return INDEX_NONE;
+	const int32 Slot = GetEmptySlot();
+	if (Slot == INDEX_NONE) return INDEX_NONE;
+	Slots[Slot] = Item;
+	MarkSlot(Slot, true);
+	Item->SetInventorySlotIndex(Slot);
+	return Slot;
+}
+
+AItem* UInventoryComponent::SetItemAt(int32 Slot, AItem* Item)
+{
+	if (!IsValidSlot(Slot)) return nullptr;
+	AItem* PreviousItem = Slots[Slot];
+	Slots[Slot] = Item;
+	MarkSlot(Slot, Item != nullptr);
+	if (Item) Item->SetInventorySlotIndex(Slot);
+	return PreviousItem;
+}
+
+AItem* UInventoryComponent::RemoveItemAt(int32 Slot)
+{
+	return SetItemAt(Slot, nullptr);
+}
+
+void UInventoryComponent::ClearItems()
+{
+	SetCapacity(Capacity);
+}
+
+void UInventoryComponent::AddAmmo(EAmmoType AmmoType, int32 Amount)
+{
+	const int32 Index = GetAmmoIndex(AmmoType);
+	if (Index != INDEX_NONE) AmmoCounts[Index] = FMath::Max(AmmoCounts[Index] + Amount, 0);
+}
+
+void UInventoryComponent::SetAmmo(EAmmoType AmmoType, int32 Amount)
+{
+	const int32 Index = GetAmmoIndex(AmmoType);
+	if (Index != INDEX_NONE) AmmoCounts[Index] = FMath::Max(Amount, 0);
+}
+
+int32 UInventoryComponent::TakeAmmo(EAmmoType AmmoType, int32 Amount)
+{
+	const int32 Index = GetAmmoIndex(AmmoType);
+	if (Index == INDEX_NONE) return 0;
+	const int32 Taken = FMath::Clamp(Amount, 0, AmmoCounts[Index]);
+	AmmoCounts[Index] -= Taken;
+	return Taken;
+}
+
+AItem* UInventoryComponent::GetItemAt(int32 Slot) const
+{
+	return IsValidSlot(Slot) ? Slots[Slot] : nullptr;
+}
+
+int32 UInventoryComponent::GetEmptySlot() const
+{
+	return FreeSlotMask != 0 ? static_cast<int32>(FMath::CountTrailingZeros(FreeSlotMask)) : INDEX_NONE;
+}
+
+int32 UInventoryComponent::GetAmmo(EAmmoType AmmoType) const
+{
+	const int32 Index = GetAmmoIndex(AmmoType);
+	return Index != INDEX_NONE ? AmmoCounts[Index] : 0;
+}
+
+int32 UInventoryComponent::GetAmmoIndex(EAmmoType AmmoType)
+{
+	const int32 Index = static_cast<int32>(AmmoType);
+	return Index < static_cast<int32>(EAmmoType::EAT_MAX) ? Index : INDEX_NONE;
+}
+
+void UInventoryComponent::MarkSlot(int32 Slot, bool bOccupied)
+{
+	if (bOccupied) FreeSlotMask &= ~(1u << Slot);
+	else FreeSlotMask |= 1u << Slot;
+}
@@ -9,6 +9,13 @@
 #include "Camera/CameraComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Curves/CurveVector.h"
+#include "Items/ItemDataSubsystem.h"
+#include "Items/LootSubsystem.h"
+#include "Audio/GameplayAudioSubsystem.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Item Rarity Data Table Lookup"), STAT_ItemRarityDataTableLookup, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Items Ticking"), STAT_ItemsTicking, STATGROUP_Arcorox);
 
 AItem::AItem() :
 	ItemName(FString("Item")),
@@ -25,6 +32,11 @@ AItem::AItem() :
 	InterpLocationIndex(1),
 	MaterialIndex(0),
 	bCanChangeCustomDepth(true),
+	bRegisteredAsPickup(false),
+	bCountedAsTicking(false),
+	GlowAmountParameterIndex(INDEX_NONE),
+	FresnelExponentParameterIndex(INDEX_NONE),
+	FresnelReflectFractionParameterIndex(INDEX_NONE),
 	MaterialPulseCurveTime(5.f),
 	GlowAmount(150.f),
 	FresnelExponent(3.f),
@@ -33,6 +45,8 @@ AItem::AItem() :
 	bCharacterInventoryFull(false)
 {
 	PrimaryActorTick.bCanEverTick = true;
+	//Items only tick while they have work to do, see ShouldTick()
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	ItemMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("ItemMesh"));
 	ItemMesh->SetSimulatePhysics(false);
@@ -73,8 +87,44 @@ void AItem::BeginPlay()
 	OverlapSphere->OnComponentEndOverlap.AddDynamic(this, &AItem::OnSphereEndOverlap);
 
 	SetItemProperties(ItemState);
+	UpdateLootRegistration();
 	InitializeCustomDepth();
-	StartMaterialPulseTimer();
+}
+
+void AItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (ArcoroxCharacter) ArcoroxCharacter->RemoveOverlappingItem(this);
+	if (bRegisteredAsPickup)
+	{
+		if (ULootSubsystem* LootSubsystem = GetWorld()->GetSubsystem<ULootSubsystem>()) LootSubsystem->UnregisterPickupItem(this);
+		bRegisteredAsPickup = false;
+	}
+	if (bCountedAsTicking)
+	{
+		DEC_DWORD_STAT(STAT_ItemsTicking);
+		bCountedAsTicking = false;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AItem::OnAcquiredFromPool()
+{
+	EnableGlowMaterial();
+	SetItemState(EItemState::EIS_Pickup);
+}
+
+void AItem::OnReleasedToPool()
+{
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	if (ArcoroxCharacter) ArcoroxCharacter->RemoveOverlappingItem(this);
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	bIsInterpolating = false;
+	RefreshTickEnabled();
+	SetActorScale3D(FVector(1.f));
+	bCanChangeCustomDepth = true;
+	DisableCustomDepth();
+	SetItemState(EItemState::EIS_PickedUp);
 }
 
 void AItem::OnConstruction(const FTransform& Transform)
@@ -90,6 +140,10 @@ void AItem::InitializeDynamicMaterialInstance()
 	{
 		DynamicMaterialInstance = UMaterialInstanceDynamic::Create(MaterialInstance, this);
 		DynamicMaterialInstance->SetVectorParameterValue(TEXT("FresnelColor"), GlowColor);
+		//Cache parameter indices so per-frame pulse updates skip the name lookups
+		if (!DynamicMaterialInstance->InitializeScalarParameterAndGetIndex(TEXT("GlowAmount"), 0.f, GlowAmountParameterIndex)) GlowAmountParameterIndex = INDEX_NONE;
+		if (!DynamicMaterialInstance->InitializeScalarParameterAndGetIndex(TEXT("FresnelExponent"), 0.f, FresnelExponentParameterIndex)) FresnelExponentParameterIndex = INDEX_NONE;
+		if (!DynamicMaterialInstance->InitializeScalarParameterAndGetIndex(TEXT("FresnelReflectFraction"), 0.f, FresnelReflectFractionParameterIndex)) FresnelReflectFractionParameterIndex = INDEX_NONE;
 		ItemMesh->SetMaterial(MaterialIndex, DynamicMaterialInstance);
 		EnableGlowMaterial();
 	}
@@ -97,38 +151,24 @@ void AItem::InitializeDynamicMaterialInstance()
 
 void AItem::GetItemRarityDataTableInfo()
 {
-	FString ItemRarityDataTablePath(TEXT("/Script/Engine.DataTable'/Game/Dynamic/Blueprints/DataTables/ItemRarityDataTable.ItemRarityDataTable'"));
-	UDataTable* ItemRarityDataTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *ItemRarityDataTablePath));
-	if (ItemRarityDataTableObject)
+	SCOPE_CYCLE_COUNTER(STAT_ItemRarityDataTableLookup);
+	const FItemRarityTable* RarityRow = nullptr;
+	if (const UItemDataSubsystem* ItemData = UItemDataSubsystem::GetRowCache(this))
 	{
-		FItemRarityTable* RarityRow = nullptr;
-		switch (ItemRarity)
-		{
-		case EItemRarity::EIR_Damaged:
-			RarityRow = ItemRarityDataTableObject->FindRow<FItemRarityTable>(FName("Damaged"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Common:
-			RarityRow = ItemRarityDataTableObject->FindRow<FItemRarityTable>(FName("Common"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Uncommon:
-			RarityRow = ItemRarityDataTableObject->FindRow<FItemRarityTable>(FName("Uncommon"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Rare:
-			RarityRow = ItemRarityDataTableObject->FindRow<FItemRarityTable>(FName("Rare"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Legendary:
-			RarityRow = ItemRarityDataTableObject->FindRow<FItemRarityTable>(FName("Legendary"), TEXT(""));
-			break;
-		}
-		if (RarityRow)
-		{
-			GlowColor = RarityRow->GlowColor;
-			LightColor = RarityRow->LightColor;
-			DarkColor = RarityRow->DarkColor;
-			NumStars = RarityRow->NumStars;
-			BackgroundIcon = RarityRow->IconBackground;
-			if (GetItemMesh()) GetItemMesh()->SetCustomDepthStencilValue(RarityRow->CustomDepthStencil);
-		}
+		RarityRow = ItemData->GetItemRarityRow(ItemRarity);
+	}
+	else if (UDataTable* ItemRarityDataTableObject = UItemDataSubsystem::LoadItemRarityDataTable())
+	{
+		RarityRow = ItemRarityDataTableObject->FindRow<FItemRarityTable>(UItemDataSubsystem::GetItemRarityRowName(ItemRarity), TEXT(""));
+	}
+	if (RarityRow)
+	{
+		GlowColor = RarityRow->GlowColor;
+		LightColor = RarityRow->LightColor;
+		DarkColor = RarityRow->DarkColor;
+		NumStars = RarityRow->NumStars;
+		BackgroundIcon = RarityRow->IconBackground;
+		if (GetItemMesh()) GetItemMesh()->SetCustomDepthStencilValue(RarityRow->CustomDepthStencil);
 	}
 }
 
@@ -137,7 +177,7 @@ void AItem::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* Ot
 	if (OtherActor)
 	{
 		ArcoroxCharacter = Cast<AArcoroxCharacter>(OtherActor);
-		if (ArcoroxCharacter)ArcoroxCharacter->IncrementOverlappedItemCount(1);
+		if (ArcoroxCharacter) ArcoroxCharacter->AddOverlappingItem(this);
 	}
 }
 
@@ -148,7 +188,7 @@ void AItem::OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor*
 		ArcoroxCharacter = Cast<AArcoroxCharacter>(OtherActor);
 		if (ArcoroxCharacter)
 		{
-			ArcoroxCharacter->IncrementOverlappedItemCount(-1);
+			ArcoroxCharacter->RemoveOverlappingItem(this);
 			ArcoroxCharacter->UnhighlightInventorySlot();
 		}
 	}
@@ -279,6 +319,7 @@ void AItem::ItemInterpolation(float DeltaTime)
 void AItem::FinishInterpolating()
 {
 	bIsInterpolating = false;
+	RefreshTickEnabled();
 	if (ArcoroxCharacter)
 	{
 		ArcoroxCharacter->DecrementInterpLocationItemCount(InterpLocationIndex);
@@ -303,23 +344,19 @@ FVector AItem::GetInterpLocation()
 }
 
 void AItem::UpdateMaterialPulse()
+{
+	//Pickup state pulse is driven by the loot subsystem
+	if (ItemState != EItemState::EIS_EquipInterpolating || MaterialPulseInterpCurve == nullptr) return;
+	const float ElapsedTime = GetWorldTimerManager().GetTimerElapsed(ItemInterpolationTimer);
+	ApplyMaterialPulse(MaterialPulseInterpCurve->GetVectorValue(ElapsedTime));
+}
+
+void AItem::ApplyMaterialPulse(const FVector& CurveValue)
 {
 	if (DynamicMaterialInstance == nullptr) return;
-	float ElapsedTime;
-	FVector CurveValue;
-	if (ItemState == EItemState::EIS_Pickup && MaterialPulseCurve)
-	{
-		ElapsedTime = GetWorldTimerManager().GetTimerElapsed(MaterialPulseTimer);
-		CurveValue = MaterialPulseCurve->GetVectorValue(ElapsedTime);
-	}
-	else if (ItemState == EItemState::EIS_EquipInterpolating && MaterialPulseInterpCurve)
-	{
-		ElapsedTime = GetWorldTimerManager().GetTimerElapsed(ItemInterpolationTimer);
-		CurveValue = MaterialPulseInterpCurve->GetVectorValue(ElapsedTime);
-	}
-	DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowAmount"), CurveValue.X * GlowAmount);
-	DynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelExponent"), CurveValue.Y * FresnelExponent);
-	DynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelReflectFraction"), CurveValue.Z * FresnelReflectFraction);
+	if (GlowAmountParameterIndex != INDEX_NONE) DynamicMaterialInstance->SetScalarParameterByIndex(GlowAmountParameterIndex, CurveValue.X * GlowAmount);
+	if (FresnelExponentParameterIndex != INDEX_NONE) DynamicMaterialInstance->SetScalarParameterByIndex(FresnelExponentParameterIndex, CurveValue.Y * FresnelExponent);
+	if (FresnelReflectFractionParameterIndex != INDEX_NONE) DynamicMaterialInstance->SetScalarParameterByIndex(FresnelReflectFractionParameterIndex, CurveValue.Z * FresnelReflectFraction);
 }
 
 void AItem::EnableGlowMaterial()
@@ -388,6 +425,34 @@ void AItem::SetItemState(EItemState State)
 {
 	ItemState = State;
 	SetItemProperties(ItemState);
+	UpdateLootRegistration();
+}
+
+bool AItem::ShouldTick() const
+{
+	return bIsInterpolating;
+}
+
+void AItem::RefreshTickEnabled()
+{
+	const bool bShouldTick = ShouldTick();
+	if (bShouldTick == bCountedAsTicking) return;
+	bCountedAsTicking = bShouldTick;
+	if (bShouldTick) INC_DWORD_STAT(STAT_ItemsTicking);
+	else DEC_DWORD_STAT(STAT_ItemsTicking);
+	SetActorTickEnabled(bShouldTick);
+}
+
+void AItem::UpdateLootRegistration()
+{
+	if (!HasActorBegunPlay() && !IsActorBeginningPlay()) return;
+	const bool bShouldRegister = ItemState == EItemState::EIS_Pickup;
+	if (bShouldRegister == bRegisteredAsPickup) return;
+	ULootSubsystem* LootSubsystem = GetWorld()->GetSubsystem<ULootSubsystem>();
+	if (LootSubsystem == nullptr) return;
+	bRegisteredAsPickup = bShouldRegister;
+	if (bShouldRegister) LootSubsystem->RegisterPickupItem(this);
+	else LootSubsystem->UnregisterPickupItem(this);
 }
 
 void AItem::StartItemCurve(AArcoroxCharacter* Character)
@@ -401,8 +466,8 @@ void AItem::StartItemCurve(AArcoroxCharacter* Character)
 	const float ItemYaw = GetActorRotation().Yaw;
 	InterpInitialYawOffset = ItemYaw - CameraYaw;
 	bIsInterpolating = true;
+	RefreshTickEnabled();
 	SetItemState(EItemState::EIS_EquipInterpolating);
-	GetWorldTimerManager().ClearTimer(MaterialPulseTimer);
 	PlayPickupSound();
 	bCanChangeCustomDepth = false;
 	GetWorldTimerManager().SetTimer(ItemInterpolationTimer, this, &AItem::FinishInterpolating, ZCurveTime);
@@ -410,36 +475,18 @@ void AItem::StartItemCurve(AArcoroxCharacter* Character)
 
 void AItem::PlayPickupSound()
 {
-	if (ArcoroxCharacter == nullptr || PickupSound == nullptr) return;
-	if (ArcoroxCharacter->ShouldPlayPickupSound())
-	{
-		UGameplayStatics::PlaySound2D(this, PickupSound);
-		ArcoroxCharacter->StartPickupSoundTimer();
-	}
+	if (ArcoroxCharacter == nullptr) return;
+	UGameplayAudioSubsystem::PlaySound2D(this, PickupSound, EGameplaySoundCategory::Pickup, ArcoroxCharacter);
 }
 
 void AItem::PlayEquipSound()
 {
-	if (ArcoroxCharacter == nullptr || EquipSound == nullptr) return;
-	if (ArcoroxCharacter->ShouldPlayEquipSound())
-	{
-		UGameplayStatics::PlaySound2D(this, EquipSound);
-		ArcoroxCharacter->StartEquipSoundTimer();
-	}
+	if (ArcoroxCharacter == nullptr) return;
+	UGameplayAudioSubsystem::PlaySound2D(this, EquipSound, EGameplaySoundCategory::Equip, ArcoroxCharacter);
 }
 
 void AItem::ForcePlayEquipSound()
 {
-	if (ArcoroxCharacter == nullptr || EquipSound == nullptr) return;
-	UGameplayStatics::PlaySound2D(this, EquipSound);
-}
-
-void AItem::StartMaterialPulseTimer()
-{
-	if (ItemState == EItemState::EIS_Pickup) GetWorldTimerManager().SetTimer(MaterialPulseTimer, this, &AItem::ResetMaterialPulseTimer, MaterialPulseCurveTime);
-}
-
-void AItem::ResetMaterialPulseTimer()
-{
-	StartMaterialPulseTimer();
+	if (ArcoroxCharacter == nullptr) return;
+	UGameplayAudioSubsystem::PlaySound2D(this, EquipSound, EGameplaySoundCategory::Equip, ArcoroxCharacter, true);
 }
\ No newline at end of file
@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/ItemDataSubsystem.h"
+#include "Items/Item.h"
+#include "Items/Weapon.h"
+#include "Items/Ammo.h"
+#include "Engine/DataTable.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+static TAutoConsoleVariable<bool> CVarUseItemDataCache(
+	TEXT("Arcorox.Items.UseDataCache"),
+	true,
+	TEXT("Use the cached Data Table rows of UItemDataSubsystem when constructing items instead of loading the tables and looking rows up by name."),
+	ECVF_Default);
+
+static const TCHAR* ItemRarityDataTablePath = TEXT("/Script/Engine.DataTable'/Game/Dynamic/Blueprints/DataTables/ItemRarityDataTable.ItemRarityDataTable'");
+static const TCHAR* WeaponTypeDataTablePath = TEXT("/Script/Engine.DataTable'/Game/Dynamic/Blueprints/DataTables/WeaponTypeDataTable.WeaponTypeDataTable'");
+
+void UItemDataSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	ItemRarityDataTable = LoadItemRarityDataTable();
+	ItemRarityRows.Init(nullptr, static_cast<int32>(EItemRarity::EIR_MAX));
+	if (ItemRarityDataTable)
+	{
+		for (int32 i = 0; i < ItemRarityRows.Num(); i++)
+		{
+			ItemRarityRows[i] = ItemRarityDataTable->FindRow<FItemRarityTable>(GetItemRarityRowName(static_cast<EItemRarity>(i)), TEXT("UItemDataSubsystem"));
+		}
+	}
+
+	//Weapon assets are soft references streamed in by UWeaponAssetSubsystem, so this is the whole startup cost of the table
+	const double WeaponTypeLoadStartTime = FPlatformTime::Seconds();
+	WeaponTypeDataTable = LoadWeaponTypeDataTable();
+	UE_LOG(LogArcorox, Log, TEXT("Weapon Type Data Table loaded in %.2f ms"), (FPlatformTime::Seconds() - WeaponTypeLoadStartTime) * 1000.0);
+	WeaponTypeRows.Init(nullptr, static_cast<int32>(EWeaponType::EWT_MAX));
+	CrosshairSpreads.Init(FBakedCrosshairSpread::GetDefault(), static_cast<int32>(EWeaponType::EWT_MAX));
+	if (WeaponTypeDataTable)
+	{
+		for (int32 i = 0; i < WeaponTypeRows.Num(); i++)
+		{
+			WeaponTypeRows[i] = WeaponTypeDataTable->FindRow<FWeaponTypeTable>(GetWeaponTypeRowName(static_cast<EWeaponType>(i)), TEXT("UItemDataSubsystem"));
+			if (WeaponTypeRows[i]) CrosshairSpreads[i].Bake(WeaponTypeRows[i]->CrosshairSpreadProfile);
+		}
+	}
+}
+
+void UItemDataSubsystem::Deinitialize()
+{
+	ItemRarityRows.Empty();
+	WeaponTypeRows.Empty();
+	CrosshairSpreads.Empty();
+	ItemRarityDataTable = nullptr;
+	WeaponTypeDataTable = nullptr;
+
+	Super::Deinitialize();
+}
+
+const UItemDataSubsystem* UItemDataSubsystem::GetRowCache(const UObject* WorldContextObject)
+{
+	if (!CVarUseItemDataCache.GetValueOnGameThread() || WorldContextObject == nullptr) return nullptr;
+	const UWorld* World = WorldContextObject->GetWorld();
+	if (World == nullptr || !World->IsGameWorld()) return nullptr;
+	return UGameInstance::GetSubsystem<UItemDataSubsystem>(World->GetGameInstance());
+}
+
+UDataTable* UItemDataSubsystem::LoadItemRarityDataTable()
+{
+	return Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, ItemRarityDataTablePath));
+}
+
+UDataTable* UItemDataSubsystem::LoadWeaponTypeDataTable()
+{
+	return Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, WeaponTypeDataTablePath));
+}
+
+FName UItemDataSubsystem::GetItemRarityRowName(EItemRarity Rarity)
+{
+	switch (Rarity)
+	{
+	case EItemRarity::EIR_Damaged:
+		return FName("Damaged");
+	case EItemRarity::EIR_Common:
+		return FName("Common");
+	case EItemRarity::EIR_Uncommon:
+		return FName("Uncommon");
+	case EItemRarity::EIR_Rare:
+		return FName("Rare");
+	case EItemRarity::EIR_Legendary:
+		return FName("Legendary");
+	default:
+		break;
+	}
+	return NAME_None;
+}
+
+FName UItemDataSubsystem::GetWeaponTypeRowName(EWeaponType Type)
+{
+	switch (Type)
+	{
+	case EWeaponType::EWT_SubmachineGun:
+		return FName("SubmachineGun");
+	case EWeaponType::EWT_AssaultRifle:
+		return FName("AssaultRifle");
+	case EWeaponType::EWT_Pistol:
+		return FName("Pistol");
+	default:
+		break;
+	}
+	return NAME_None;
+}
+
+const FItemRarityTable* UItemDataSubsystem::GetItemRarityRow(EItemRarity Rarity) const
+{
+	const int32 Index = static_cast<int32>(Rarity);
+	return ItemRarityRows.IsValidIndex(Index) ? ItemRarityRows[Index] : nullptr;
+}
+
+const FWeaponTypeTable* UItemDataSubsystem::GetWeaponTypeRow(EWeaponType Type) const
+{
+	const int32 Index = static_cast<int32>(Type);
+	return WeaponTypeRows.IsValidIndex(Index) ? WeaponTypeRows[Index] : nullptr;
+}
+
+const FBakedCrosshairSpread* UItemDataSubsystem::GetCrosshairSpread(EWeaponType Type) const
+{
+	const int32 Index = static_cast<int32>(Type);
+	return CrosshairSpreads.IsValidIndex(Index) ? &CrosshairSpreads[Index] : nullptr;
+}
+
+/* Spawns Count weapons and Count ammo boxes with and without the row cache and logs the construction time of each pass */
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkItemSpawnCommand(
+	TEXT("Arcorox.Items.BenchmarkSpawn"),
+	TEXT("Arcorox.Items.BenchmarkSpawn [Count] - spawns Count AWeapon and Count AAmmo actors with the Data Table row cache off and on, and logs the time each pass took. Run with -nullrhi for headless numbers."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr || !World->IsGameWorld()) return;
+		const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 2000;
+		const bool bPreviousUseCache = CVarUseItemDataCache.GetValueOnGameThread();
+
+		auto RunPass = [World, Count](bool bUseCache)
+		{
+			CVarUseItemDataCache->Set(bUseCache, ECVF_SetByConsole);
+			TArray<AActor*> Spawned;
+			Spawned.Reserve(Count * 2);
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Count; i++)
+			{
+				const FTransform Transform(FVector(i * 10.f, 0.f, -100000.f));
+				Spawned.Add(World->SpawnActor<AWeapon>(AWeapon::StaticClass(), Transform, SpawnParams));
+				Spawned.Add(World->SpawnActor<AAmmo>(AAmmo::StaticClass(), Transform, SpawnParams));
+			}
+			const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+			for (AActor* Actor : Spawned) if (Actor) Actor->Destroy();
+			UE_LOG(LogArcorox, Display, TEXT("Spawned %d items with row cache %s in %.2f ms (%.3f us per item)"),
+				Count * 2, bUseCache ? TEXT("on") : TEXT("off"), ElapsedMs, ElapsedMs * 1000.0 / FMath::Max(Count * 2, 1));
+		};
+
+		RunPass(false);
+		RunPass(true);
+		CVarUseItemDataCache->Set(bPreviousUseCache, ECVF_SetByConsole);
+	}));
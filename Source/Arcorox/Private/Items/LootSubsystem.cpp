@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/LootSubsystem.h"
+#include "Items/Item.h"
+#include "Curves/CurveVector.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pickup Items"), STAT_PickupItems, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pickup Items Pulsing"), STAT_PickupItemsPulsing, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pulse Curve Evaluations"), STAT_PulseCurveEvaluations, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Loot Tick"), STAT_LootTick, STATGROUP_Arcorox);
+
+void ULootSubsystem::Deinitialize()
+{
+	PickupItems.Empty();
+	EvaluatedPulses.Empty();
+	SET_DWORD_STAT(STAT_PickupItems, 0);
+	SET_DWORD_STAT(STAT_PickupItemsPulsing, 0);
+
+	Super::Deinitialize();
+}
+
+TStatId ULootSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULootSubsystem, STATGROUP_Tickables);
+}
+
+void ULootSubsystem::RegisterPickupItem(AItem* Item)
+{
+	if (Item == nullptr) return;
+	PickupItems.AddUnique(Item);
+	SET_DWORD_STAT(STAT_PickupItems, PickupItems.Num());
+}
+
+void ULootSubsystem::UnregisterPickupItem(AItem* Item)
+{
+	PickupItems.RemoveSingleSwap(Item, false);
+	SET_DWORD_STAT(STAT_PickupItems, PickupItems.Num());
+}
+
+void ULootSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_LootTick);
+
+	PulseClock += DeltaTime;
+	EvaluatedPulses.Reset();
+
+	int32 NumPulsing = 0;
+	for (AItem* Item : PickupItems)
+	{
+		if (Item == nullptr || Item->GetMaterialPulseCurve() == nullptr) continue;
+		if (!Item->WasRecentlyRendered(PulseVisibilityTolerance)) continue;
+		Item->ApplyMaterialPulse(EvaluatePulse(Item->GetMaterialPulseCurve(), Item->GetMaterialPulseCurveTime()));
+		NumPulsing++;
+	}
+	SET_DWORD_STAT(STAT_PickupItemsPulsing, NumPulsing);
+}
+
+const FVector& ULootSubsystem::EvaluatePulse(const UCurveVector* Curve, float Period)
+{
+	for (const FEvaluatedPulse& Evaluated : EvaluatedPulses)
+	{
+		if (Evaluated.Curve == Curve && Evaluated.Period == Period) return Evaluated.Value;
+	}
+	INC_DWORD_STAT(STAT_PulseCurveEvaluations);
+	const float CurveTime = Period > 0.f ? static_cast<float>(FMath::Fmod(PulseClock, static_cast<double>(Period))) : 0.f;
+	FEvaluatedPulse& Evaluated = EvaluatedPulses.AddDefaulted_GetRef();
+	Evaluated.Curve = Curve;
+	Evaluated.Period = Period;
+	Evaluated.Value = Curve->GetVectorValue(CurveTime);
+	return Evaluated.Value;
+}
@@ -2,7 +2,33 @@
 
 
 #include "Items/Weapon.h"
-#include "Items/Weapon.h"
+#include "Items/ItemDataSubsystem.h"
+#include "Items/WeaponAssetSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Weapon Type Data Table Lookup"), STAT_WeaponTypeDataTableLookup, STATGROUP_Arcorox);
+
+void FWeaponTypeTable::GetAssetPaths(TArray<FSoftObjectPath>& OutPaths) const
+{
+	auto AddPath = [&OutPaths](const FSoftObjectPath& Path) { if (!Path.IsNull()) OutPaths.Add(Path); };
+	AddPath(PickupSound.ToSoftObjectPath());
+	AddPath(EquipSound.ToSoftObjectPath());
+	AddPath(WeaponMesh.ToSoftObjectPath());
+	AddPath(InventoryIcon.ToSoftObjectPath());
+	AddPath(AmmoIcon.ToSoftObjectPath());
+	AddPath(MaterialInstance.ToSoftObjectPath());
+	AddPath(AnimationBlueprint.ToSoftObjectPath());
+	AddPath(TopCrosshair.ToSoftObjectPath());
+	AddPath(BottomCrosshair.ToSoftObjectPath());
+	AddPath(MidCrosshair.ToSoftObjectPath());
+	AddPath(LeftCrosshair.ToSoftObjectPath());
+	AddPath(RightCrosshair.ToSoftObjectPath());
+	AddPath(MuzzleFlash.ToSoftObjectPath());
+	AddPath(FireSound.ToSoftObjectPath());
+	AddPath(FireLoopSound.ToSoftObjectPath());
+	AddPath(FireLoopTailSound.ToSoftObjectPath());
+}
 
 AWeapon::AWeapon():
 	ThrowWeaponTime(0.7f),
@@ -19,7 +45,13 @@ AWeapon::AWeapon():
 	PistolSlideDistance(4.f),
 	TargetPistolRecoilRotation(20.f),
 	PistolRecoilRotation(0.f),
-	bAutomaticWeapon(true)
+	PistolSlideStartTime(0.0),
+	bAutomaticWeapon(true),
+	HeldAssetType(EWeaponType::EWT_SubmachineGun),
+	bHoldingWeaponAssets(false),
+	bWeaponAssetsApplied(true),
+	bMaterialRebuildPending(false),
+	CrosshairSpread(FBakedCrosshairSpread::GetDefault())
 {
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -48,6 +80,12 @@ void AWeapon::BeginPlay()
 	if (BoneToHide != FName()) GetItemMesh()->HideBoneByName(BoneToHide, EPhysBodyOp::PBO_None);
 }
 
+void AWeapon::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ReleaseWeaponAssets();
+	Super::EndPlay(EndPlayReason);
+}
+
 void AWeapon::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
@@ -57,28 +95,23 @@ void AWeapon::OnConstruction(const FTransform& Transform)
 
 void AWeapon::GetWeaponTypeDataTableInfo()
 {
-	const FString WeaponTypeDataTablePath(TEXT("/Script/Engine.DataTable'/Game/Dynamic/Blueprints/DataTables/WeaponTypeDataTable.WeaponTypeDataTable'"));
-	UDataTable* WeaponTypeDataTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *WeaponTypeDataTablePath));
-	if (WeaponTypeDataTableObject)
+	SCOPE_CYCLE_COUNTER(STAT_WeaponTypeDataTableLookup);
+	const FWeaponTypeTable* WeaponTypeRow = nullptr;
+	if (const UItemDataSubsystem* ItemData = UItemDataSubsystem::GetRowCache(this))
+	{
+		WeaponTypeRow = ItemData->GetWeaponTypeRow(WeaponType);
+		if (const FBakedCrosshairSpread* BakedSpread = ItemData->GetCrosshairSpread(WeaponType)) CrosshairSpread = *BakedSpread;
+	}
+	else if (UDataTable* WeaponTypeDataTableObject = UItemDataSubsystem::LoadWeaponTypeDataTable())
 	{
-		FWeaponTypeTable* WeaponTypeRow = nullptr;
-		switch (WeaponType)
-		{
-		case EWeaponType::EWT_SubmachineGun:
-			WeaponTypeRow = WeaponTypeDataTableObject->FindRow<FWeaponTypeTable>(FName("SubmachineGun"), TEXT(""));
-			break;
-		case EWeaponType::EWT_AssaultRifle:
-			WeaponTypeRow = WeaponTypeDataTableObject->FindRow<FWeaponTypeTable>(FName("AssaultRifle"), TEXT(""));
-			break;
-		case EWeaponType::EWT_Pistol:
-			WeaponTypeRow = WeaponTypeDataTableObject->FindRow<FWeaponTypeTable>(FName("Pistol"), TEXT(""));
-			break;
-		}
-		SetDataTableProperties(WeaponTypeRow);
+		WeaponTypeRow = WeaponTypeDataTableObject->FindRow<FWeaponTypeTable>(UItemDataSubsystem::GetWeaponTypeRowName(WeaponType), TEXT(""));
+		if (WeaponTypeRow) CrosshairSpread.Bake(WeaponTypeRow->CrosshairSpreadProfile);
 	}
+	SetDataTableProperties(WeaponTypeRow);
+	if (WeaponTypeRow) RequestWeaponAssets();
 }
 
-void AWeapon::SetDataTableProperties(FWeaponTypeTable* WeaponTypeRow)
+void AWeapon::SetDataTableProperties(const FWeaponTypeTable* WeaponTypeRow)
 {
 	if (WeaponTypeRow)
 	{
@@ -87,35 +120,116 @@ void AWeapon::SetDataTableProperties(FWeaponTypeTable* WeaponTypeRow)
 		MagazineCapacity = WeaponTypeRow->MagazineCapacity;
 		ClipBoneName = WeaponTypeRow->ClipBoneName;
 		ReloadMontageSection = WeaponTypeRow->ReloadMontageSection;
-		TopCrosshair = WeaponTypeRow->TopCrosshair;
-		BottomCrosshair = WeaponTypeRow->BottomCrosshair;
-		MidCrosshair = WeaponTypeRow->MidCrosshair;
-		LeftCrosshair = WeaponTypeRow->LeftCrosshair;
-		RightCrosshair = WeaponTypeRow->RightCrosshair;
 		FireRate = WeaponTypeRow->FireRate;
-		MuzzleFlash = WeaponTypeRow->MuzzleFlash;
-		FireSound = WeaponTypeRow->FireSound;
 		BoneToHide = WeaponTypeRow->BoneToHide;
 		bAutomaticWeapon = WeaponTypeRow->bAutomaticWeapon;
 		Damage = WeaponTypeRow->Damage;
 		HeadshotMultiplier = WeaponTypeRow->HeadshotMultiplier;
-		SetPickupSound(WeaponTypeRow->PickupSound);
-		SetEquipSound(WeaponTypeRow->EquipSound);
-		GetItemMesh()->SetSkeletalMesh(WeaponTypeRow->WeaponMesh);
 		SetItemName(WeaponTypeRow->WeaponName);
-		SetItemIcon(WeaponTypeRow->InventoryIcon);
-		SetAmmoIcon(WeaponTypeRow->AmmoIcon);
-		SetMaterialInstance(WeaponTypeRow->MaterialInstance);
-		PreviousMaterialIndex = GetMaterialIndex();
-		if (GetItemMesh())
-		{
-			GetItemMesh()->SetAnimInstanceClass(WeaponTypeRow->AnimationBlueprint);
-			GetItemMesh()->SetMaterial(PreviousMaterialIndex, nullptr);
-		}
-		SetMaterialIndex(WeaponTypeRow->MaterialIndex);
 	}
 }
 
+const FWeaponTypeTable* AWeapon::FindWeaponTypeRow() const
+{
+	if (const UItemDataSubsystem* ItemData = UItemDataSubsystem::GetRowCache(this)) return ItemData->GetWeaponTypeRow(WeaponType);
+	if (UDataTable* WeaponTypeDataTableObject = UItemDataSubsystem::LoadWeaponTypeDataTable())
+	{
+		return WeaponTypeDataTableObject->FindRow<FWeaponTypeTable>(UItemDataSubsystem::GetWeaponTypeRowName(WeaponType), TEXT(""));
+	}
+	return nullptr;
+}
+
+void AWeapon::RequestWeaponAssets()
+{
+	UWeaponAssetSubsystem* WeaponAssets = UWeaponAssetSubsystem::Get(this);
+	if (WeaponAssets == nullptr)
+	{
+		ApplyWeaponAssets(false);
+		return;
+	}
+	if (bHoldingWeaponAssets && HeldAssetType == WeaponType) return;
+	ReleaseWeaponAssets();
+	bHoldingWeaponAssets = true;
+	HeldAssetType = WeaponType;
+	bWeaponAssetsApplied = false;
+	WeaponAssets->RequestAssets(this);
+}
+
+void AWeapon::ReleaseWeaponAssets()
+{
+	if (!bHoldingWeaponAssets) return;
+	bHoldingWeaponAssets = false;
+	//Not through UWeaponAssetSubsystem::Get so the request is still returned if streaming was turned off since
+	if (UGameInstance* GameInstance = GetGameInstance())
+	{
+		if (UWeaponAssetSubsystem* WeaponAssets = GameInstance->GetSubsystem<UWeaponAssetSubsystem>()) WeaponAssets->ReleaseAssets(this, HeldAssetType);
+	}
+}
+
+void AWeapon::ApplyWeaponAssets(bool bStreamedIn)
+{
+	const FWeaponTypeTable* WeaponTypeRow = FindWeaponTypeRow();
+	if (WeaponTypeRow == nullptr) return;
+	//Streamed bundles are resident by the time this is called, otherwise load in place as the table used to
+	const bool bLoadSynchronous = !bHoldingWeaponAssets;
+	auto Resolve = [bLoadSynchronous](const auto& SoftPtr) { return bLoadSynchronous ? SoftPtr.LoadSynchronous() : SoftPtr.Get(); };
+
+	TopCrosshair = Resolve(WeaponTypeRow->TopCrosshair);
+	BottomCrosshair = Resolve(WeaponTypeRow->BottomCrosshair);
+	MidCrosshair = Resolve(WeaponTypeRow->MidCrosshair);
+	LeftCrosshair = Resolve(WeaponTypeRow->LeftCrosshair);
+	RightCrosshair = Resolve(WeaponTypeRow->RightCrosshair);
+	MuzzleFlash = Resolve(WeaponTypeRow->MuzzleFlash);
+	FireSound = Resolve(WeaponTypeRow->FireSound);
+	FireLoopSound = Resolve(WeaponTypeRow->FireLoopSound);
+	FireLoopTailSound = Resolve(WeaponTypeRow->FireLoopTailSound);
+	SetPickupSound(Resolve(WeaponTypeRow->PickupSound));
+	SetEquipSound(Resolve(WeaponTypeRow->EquipSound));
+	GetItemMesh()->SetSkeletalMesh(Resolve(WeaponTypeRow->WeaponMesh));
+	SetItemIcon(Resolve(WeaponTypeRow->InventoryIcon));
+	SetAmmoIcon(Resolve(WeaponTypeRow->AmmoIcon));
+	SetMaterialInstance(Resolve(WeaponTypeRow->MaterialInstance));
+	if (GetItemMesh()) GetItemMesh()->SetAnimInstanceClass(Resolve(WeaponTypeRow->AnimationBlueprint));
+	bWeaponAssetsApplied = true;
+
+	//Construction sets up the material and BeginPlay hides the bone, afterwards (streamed in or re-acquired from the pool) redo both here
+	const bool bAfterConstruction = bStreamedIn || HasActorBegunPlay();
+	if (bAfterConstruction && BoneToHide != FName()) GetItemMesh()->HideBoneByName(BoneToHide, EPhysBodyOp::PBO_None);
+	//Rebuilding the material lights the glow, so a weapon in hand or in the inventory waits until it is dropped
+	const bool bHeld = GetItemState() == EItemState::EIS_Equipped || GetItemState() == EItemState::EIS_PickedUp;
+	if (bAfterConstruction && bHeld)
+	{
+		bMaterialRebuildPending = true;
+		return;
+	}
+	SwapMaterialSlot(WeaponTypeRow->MaterialIndex);
+	if (bAfterConstruction) InitializeDynamicMaterialInstance();
+}
+
+void AWeapon::SwapMaterialSlot(int32 NewMaterialIndex)
+{
+	PreviousMaterialIndex = GetMaterialIndex();
+	if (GetItemMesh()) GetItemMesh()->SetMaterial(PreviousMaterialIndex, nullptr);
+	SetMaterialIndex(NewMaterialIndex);
+}
+
+void AWeapon::OnAcquiredFromPool()
+{
+	//Restore ammo and the other Data Table properties used up by the previous owner
+	GetWeaponTypeDataTableInfo();
+	Super::OnAcquiredFromPool();
+}
+
+void AWeapon::OnReleasedToPool()
+{
+	bIsFalling = false;
+	bDisplacingPistolSlide = false;
+	bMovingClip = false;
+	Super::OnReleasedToPool();
+	//Pooled weapons let go of their bundle so unused weapon types can unload, acquiring requests it again
+	ReleaseWeaponAssets();
+}
+
 void AWeapon::ThrowWeapon()
 {
 	FRotator Rotation{ 0.f, GetItemMesh()->GetComponentRotation().Yaw, 0.f };
@@ -128,6 +242,13 @@ void AWeapon::ThrowWeapon()
 	ImpulseVector *= 10000.f;
 	GetItemMesh()->AddImpulse(ImpulseVector);
 	bIsFalling = true;
+	RefreshTickEnabled();
+	if (bMaterialRebuildPending)
+	{
+		bMaterialRebuildPending = false;
+		if (const FWeaponTypeTable* WeaponTypeRow = FindWeaponTypeRow()) SwapMaterialSlot(WeaponTypeRow->MaterialIndex);
+		InitializeDynamicMaterialInstance();
+	}
 	EnableGlowMaterial();
 	GetWorldTimerManager().SetTimer(ThrowWeaponTimer, this, &AWeapon::StopFalling, ThrowWeaponTime);
 }
@@ -149,29 +270,40 @@ bool AWeapon::FullMagazine()
 	return Ammo == MagazineCapacity;
 }
 
-void AWeapon::StartPistolSlideTimer()
+void AWeapon::StartPistolSlide(double StartTime)
 {
+	PistolSlideStartTime = StartTime;
 	bDisplacingPistolSlide = true;
-	GetWorldTimerManager().SetTimer(PistolSlideTimer, this, &AWeapon::FinishPistolSlideDisplacement, PistolSlideTime);
+	RefreshTickEnabled();
 }
 
 void AWeapon::StopFalling()
 {
 	bIsFalling = false;
+	RefreshTickEnabled();
 	SetItemState(EItemState::EIS_Pickup);
-	StartMaterialPulseTimer();
 }
 
 void AWeapon::FinishPistolSlideDisplacement()
 {
 	bDisplacingPistolSlide = false;
+	RefreshTickEnabled();
+}
+
+bool AWeapon::ShouldTick() const
+{
+	return Super::ShouldTick() || bIsFalling || bDisplacingPistolSlide;
 }
 
 void AWeapon::UpdatePistolSlideDisplacement()
 {
-	if (!bDisplacingPistolSlide || PistolSlideCurve == nullptr) return;
-	const float ElapsedTime = GetWorldTimerManager().GetTimerElapsed(PistolSlideTimer);
-	const float CurveValue = PistolSlideCurve->GetFloatValue(ElapsedTime);
-	PistolSlideDisplacement = CurveValue * PistolSlideDistance;
-	PistolRecoilRotation = CurveValue * TargetPistolRecoilRotation;
+	if (!bDisplacingPistolSlide) return;
+	const float ElapsedTime = GetWorld()->GetTimeSeconds() - PistolSlideStartTime;
+	if (PistolSlideCurve)
+	{
+		const float CurveValue = PistolSlideCurve->GetFloatValue(FMath::Min(ElapsedTime, PistolSlideTime));
+		PistolSlideDisplacement = CurveValue * PistolSlideDistance;
+		PistolRecoilRotation = CurveValue * TargetPistolRecoilRotation;
+	}
+	if (ElapsedTime >= PistolSlideTime) FinishPistolSlideDisplacement();
 }
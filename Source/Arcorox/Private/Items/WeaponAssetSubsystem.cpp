@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/WeaponAssetSubsystem.h"
+#include "Items/Weapon.h"
+#include "Items/ItemDataSubsystem.h"
+#include "Engine/DataTable.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon Asset Bundles Resident"), STAT_WeaponAssetBundlesResident, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon Asset Bundle Loads"), STAT_WeaponAssetBundleLoads, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<bool> CVarStreamWeaponAssets(
+	TEXT("Arcorox.Items.StreamWeaponAssets"),
+	true,
+	TEXT("Load weapon meshes, sounds and icons asynchronously per weapon type while weapons of that type exist, 0 loads them synchronously on construction."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorld ReportWeaponAssetsCommand(
+	TEXT("Arcorox.Items.ReportWeaponAssets"),
+	TEXT("Arcorox.Items.ReportWeaponAssets - logs which weapon asset bundles are resident, how long they took to load and the resident memory of the process. Compare runs with Arcorox.Items.StreamWeaponAssets 0 and 1."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UWeaponAssetSubsystem* WeaponAssets = UWeaponAssetSubsystem::Get(World)) WeaponAssets->LogReport();
+		else UE_LOG(LogArcorox, Log, TEXT("Weapon asset streaming is off, resident memory %.1f MB"), FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0));
+	}));
+
+void UWeaponAssetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Bundles.SetNum(static_cast<int32>(EWeaponType::EWT_MAX));
+}
+
+void UWeaponAssetSubsystem::Deinitialize()
+{
+	for (FWeaponAssetBundle& Bundle : Bundles)
+	{
+		if (Bundle.Handle.IsValid()) Bundle.Handle->CancelHandle();
+		if (Bundle.bLoaded) DEC_DWORD_STAT(STAT_WeaponAssetBundlesResident);
+	}
+	Bundles.Empty();
+
+	Super::Deinitialize();
+}
+
+UWeaponAssetSubsystem* UWeaponAssetSubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!CVarStreamWeaponAssets.GetValueOnGameThread() || WorldContextObject == nullptr) return nullptr;
+	const UWorld* World = WorldContextObject->GetWorld();
+	if (World == nullptr || !World->IsGameWorld()) return nullptr;
+	return UGameInstance::GetSubsystem<UWeaponAssetSubsystem>(World->GetGameInstance());
+}
+
+void UWeaponAssetSubsystem::RequestAssets(AWeapon* Weapon)
+{
+	if (Weapon == nullptr) return;
+	const EWeaponType Type = Weapon->GetWeaponType();
+	if (!Bundles.IsValidIndex(static_cast<int32>(Type))) return;
+	FWeaponAssetBundle& Bundle = Bundles[static_cast<int32>(Type)];
+	Bundle.NumRequests++;
+	if (Bundle.bLoaded)
+	{
+		Weapon->ApplyWeaponAssets(false);
+		return;
+	}
+	Bundle.Waiting.Add(Weapon);
+	if (Bundle.Handle.IsValid()) return;
+
+	const FWeaponTypeTable* WeaponTypeRow = nullptr;
+	if (const UItemDataSubsystem* ItemData = UItemDataSubsystem::GetRowCache(Weapon))
+	{
+		WeaponTypeRow = ItemData->GetWeaponTypeRow(Type);
+	}
+	else if (UDataTable* WeaponTypeDataTable = UItemDataSubsystem::LoadWeaponTypeDataTable())
+	{
+		WeaponTypeRow = WeaponTypeDataTable->FindRow<FWeaponTypeTable>(UItemDataSubsystem::GetWeaponTypeRowName(Type), TEXT(""));
+	}
+	TArray<FSoftObjectPath> AssetPaths;
+	if (WeaponTypeRow) WeaponTypeRow->GetAssetPaths(AssetPaths);
+	Bundle.NumAssets = AssetPaths.Num();
+	Bundle.RequestTime = FPlatformTime::Seconds();
+	INC_DWORD_STAT(STAT_WeaponAssetBundleLoads);
+	Bundle.Handle = StreamableManager.RequestAsyncLoad(AssetPaths, FStreamableDelegate::CreateUObject(this, &UWeaponAssetSubsystem::OnBundleLoaded, Type));
+	//No handle means there was nothing to load, and a handle already complete means everything was resident
+	if (!Bundle.Handle.IsValid() || Bundle.Handle->HasLoadCompleted()) OnBundleLoaded(Type);
+}
+
+void UWeaponAssetSubsystem::ReleaseAssets(AWeapon* Weapon, EWeaponType Type)
+{
+	if (!Bundles.IsValidIndex(static_cast<int32>(Type))) return;
+	FWeaponAssetBundle& Bundle = Bundles[static_cast<int32>(Type)];
+	if (Bundle.NumRequests == 0) return;
+	Bundle.Waiting.Remove(Weapon);
+	if (--Bundle.NumRequests > 0) return;
+
+	//The assets stay resident until the garbage collector finds nothing else referencing them
+	if (Bundle.Handle.IsValid()) Bundle.Handle->CancelHandle();
+	Bundle.Handle.Reset();
+	Bundle.Waiting.Reset();
+	if (Bundle.bLoaded) DEC_DWORD_STAT(STAT_WeaponAssetBundlesResident);
+	Bundle.bLoaded = false;
+}
+
+int32 UWeaponAssetSubsystem::GetNumRequests(EWeaponType Type) const
+{
+	return Bundles.IsValidIndex(static_cast<int32>(Type)) ? Bundles[static_cast<int32>(Type)].NumRequests : 0;
+}
+
+bool UWeaponAssetSubsystem::IsResident(EWeaponType Type) const
+{
+	return Bundles.IsValidIndex(static_cast<int32>(Type)) && Bundles[static_cast<int32>(Type)].bLoaded;
+}
+
+void UWeaponAssetSubsystem::OnBundleLoaded(EWeaponType Type)
+{
+	if (!Bundles.IsValidIndex(static_cast<int32>(Type))) return;
+	FWeaponAssetBundle& Bundle = Bundles[static_cast<int32>(Type)];
+	if (Bundle.bLoaded || Bundle.NumRequests == 0) return;
+	Bundle.bLoaded = true;
+	Bundle.LoadTime = FPlatformTime::Seconds() - Bundle.RequestTime;
+	INC_DWORD_STAT(STAT_WeaponAssetBundlesResident);
+	UE_LOG(LogArcorox, Verbose, TEXT("Weapon assets for %s loaded in %.2f ms (%d assets)"),
+		*UItemDataSubsystem::GetWeaponTypeRowName(Type).ToString(), Bundle.LoadTime * 1000.0, Bundle.NumAssets);
+
+	TArray<TWeakObjectPtr<AWeapon>> Waiting = MoveTemp(Bundle.Waiting);
+	for (const TWeakObjectPtr<AWeapon>& Weapon : Waiting)
+	{
+		if (Weapon.IsValid()) Weapon->ApplyWeaponAssets(true);
+	}
+}
+
+void UWeaponAssetSubsystem::LogReport() const
+{
+	for (int32 i = 0; i < Bundles.Num(); i++)
+	{
+		const FWeaponAssetBundle& Bundle = Bundles[i];
+		UE_LOG(LogArcorox, Log, TEXT("Weapon assets %s: %s, %d weapons holding, %d assets, last load %.2f ms"),
+			*UItemDataSubsystem::GetWeaponTypeRowName(static_cast<EWeaponType>(i)).ToString(),
+			Bundle.bLoaded ? TEXT("resident") : (Bundle.Handle.IsValid() ? TEXT("loading") : TEXT("unloaded")), Bundle.NumRequests, Bundle.NumAssets, Bundle.LoadTime * 1000.0);
+	}
+	UE_LOG(LogArcorox, Log, TEXT("Resident memory %.1f MB"), FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0));
+}
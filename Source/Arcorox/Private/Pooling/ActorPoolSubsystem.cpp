@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Pooling/ActorPoolSubsystem.h"
+#include "Interfaces/PoolableInterface.h"
+#include "Items/Ammo.h"
+#include "Explosive/Explosive.h"
+#include "Characters/ArcoroxCharacter.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Actor Pool Hits"), STAT_ActorPoolHits, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Actor Pool Misses"), STAT_ActorPoolMisses, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Actor Pool Releases"), STAT_ActorPoolReleases, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Actor Pool Free Actors"), STAT_ActorPoolFreeActors, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<bool> CVarActorPoolEnabled(
+	TEXT("Arcorox.Pool.Enabled"),
+	true,
+	TEXT("Recycle poolable actors (items, explosives) instead of spawning and destroying them."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarActorPoolMaxPerClass(
+	TEXT("Arcorox.Pool.MaxPerClass"),
+	256,
+	TEXT("Maximum number of free actors kept per class, released actors beyond this are destroyed."),
+	ECVF_Default);
+
+void UActorPoolSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_ActorPoolFreeActors, GetNumFreeActors());
+	FreeActors.Empty();
+	AcquiredClasses.Empty();
+
+	Super::Deinitialize();
+}
+
+AActor* UActorPoolSubsystem::AcquireActor(UClass* Class, const FTransform& Transform)
+{
+	if (Class == nullptr) return nullptr;
+	AcquiredClasses.Add(Class);
+	if (FActorPoolList* Pool = FreeActors.Find(Class))
+	{
+		while (Pool->Actors.Num() > 0)
+		{
+			AActor* Actor = Pool->Actors.Pop(false);
+			DEC_DWORD_STAT(STAT_ActorPoolFreeActors);
+			if (!IsValid(Actor)) continue;
+			INC_DWORD_STAT(STAT_ActorPoolHits);
+			Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+			Actor->SetActorHiddenInGame(false);
+			Actor->SetActorEnableCollision(true);
+			Actor->SetActorTickEnabled(Actor->PrimaryActorTick.bStartWithTickEnabled);
+			if (IPoolableInterface* Poolable = Cast<IPoolableInterface>(Actor)) Poolable->OnAcquiredFromPool();
+			return Actor;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_ActorPoolMisses);
+	return GetWorld()->SpawnActor<AActor>(Class, Transform);
+}
+
+void UActorPoolSubsystem::ReleaseActor(AActor* Actor)
+{
+	if (!IsValid(Actor)) return;
+	IPoolableInterface* Poolable = Cast<IPoolableInterface>(Actor);
+	if (Poolable == nullptr || !AcquiredClasses.Contains(Actor->GetClass()))
+	{
+		Actor->Destroy();
+		return;
+	}
+	FActorPoolList& Pool = FreeActors.FindOrAdd(Actor->GetClass());
+	if (Pool.Actors.Num() >= CVarActorPoolMaxPerClass.GetValueOnGameThread())
+	{
+		Actor->Destroy();
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_ActorPoolReleases);
+	Poolable->OnReleasedToPool();
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+	Pool.Actors.Add(Actor);
+	INC_DWORD_STAT(STAT_ActorPoolFreeActors);
+}
+
+AActor* UActorPoolSubsystem::AcquireOrSpawn(UWorld* World, UClass* Class, const FTransform& Transform)
+{
+	if (World == nullptr || Class == nullptr) return nullptr;
+	UActorPoolSubsystem* ActorPool = World->GetSubsystem<UActorPoolSubsystem>();
+	if (ActorPool && CVarActorPoolEnabled.GetValueOnGameThread()) return ActorPool->AcquireActor(Class, Transform);
+	return World->SpawnActor<AActor>(Class, Transform);
+}
+
+void UActorPoolSubsystem::ReleaseOrDestroy(AActor* Actor)
+{
+	if (!IsValid(Actor)) return;
+	UActorPoolSubsystem* ActorPool = Actor->GetWorld() ? Actor->GetWorld()->GetSubsystem<UActorPoolSubsystem>() : nullptr;
+	if (ActorPool && CVarActorPoolEnabled.GetValueOnGameThread()) ActorPool->ReleaseActor(Actor);
+	else Actor->Destroy();
+}
+
+AActor* UActorPoolSubsystem::AcquirePooledActor(const UObject* WorldContextObject, TSubclassOf<AActor> Class, const FTransform& Transform)
+{
+	return AcquireOrSpawn(WorldContextObject ? WorldContextObject->GetWorld() : nullptr, *Class, Transform);
+}
+
+void UActorPoolSubsystem::ReleasePooledActor(AActor* Actor)
+{
+	ReleaseOrDestroy(Actor);
+}
+
+int32 UActorPoolSubsystem::GetNumFreeActors() const
+{
+	int32 NumFree = 0;
+	for (const TPair<UClass*, FActorPoolList>& Pool : FreeActors) NumFree += Pool.Value.Actors.Num();
+	return NumFree;
+}
+
+/* Spawns Count ammo boxes and explosives in batches held alive at once and releases them through the gameplay paths, with pooling off and on, and logs the time spent and in garbage collection */
+static FAutoConsoleCommandWithWorldAndArgs ActorPoolSoakCommand(
+	TEXT("Arcorox.Pool.Soak"),
+	TEXT("Arcorox.Pool.Soak [Count] [BatchSize] - acquires Count AAmmo and AExplosive actors in batches of BatchSize alive at once (default Arcorox.Pool.MaxPerClass), then has the player character pick up each ammo box and hits each explosive, which release them, and collects garbage, with Arcorox.Pool.Enabled off and on. Logs total and garbage collection time."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr || !World->IsGameWorld()) return;
+		AArcoroxCharacter* Character = Cast<AArcoroxCharacter>(UGameplayStatics::GetPlayerCharacter(World, 0));
+		if (Character == nullptr)
+		{
+			UE_LOG(LogArcorox, Warning, TEXT("Arcorox.Pool.Soak needs a player character to pick up the ammo"));
+			return;
+		}
+		const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+		const int32 BatchSize = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : FMath::Max(CVarActorPoolMaxPerClass.GetValueOnGameThread(), 1);
+		const bool bPreviousEnabled = CVarActorPoolEnabled.GetValueOnGameThread();
+
+		auto RunPass = [World, Character, Count, BatchSize](bool bPooling)
+		{
+			CVarActorPoolEnabled->Set(bPooling, ECVF_SetByConsole);
+			double GCSeconds = 0.0;
+			double MaxGCSeconds = 0.0;
+			TArray<AAmmo*> AmmoBatch;
+			TArray<AExplosive*> ExplosiveBatch;
+			AmmoBatch.Reserve(BatchSize);
+			ExplosiveBatch.Reserve(BatchSize);
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Spawned = 0; Spawned < Count; Spawned += BatchSize)
+			{
+				const int32 NumInBatch = FMath::Min(BatchSize, Count - Spawned);
+				//The whole batch is alive at once so the pool has to grow to the batch size
+				for (int32 i = 0; i < NumInBatch; i++)
+				{
+					const FTransform Transform(FVector(i * 10.f, 0.f, -100000.f));
+					AmmoBatch.Add(UActorPoolSubsystem::AcquireOrSpawn<AAmmo>(World, AAmmo::StaticClass(), Transform));
+					ExplosiveBatch.Add(UActorPoolSubsystem::AcquireOrSpawn<AExplosive>(World, AExplosive::StaticClass(), Transform));
+				}
+				//The native classes hold no rounds, sounds or particles, so only the pickup and explosion bookkeeping runs
+				for (AAmmo* Ammo : AmmoBatch) Character->GetPickupItem(Ammo);
+				for (AExplosive* Explosive : ExplosiveBatch)
+				{
+					if (Explosive) IHitInterface::Execute_Hit(Explosive, FHitResult());
+				}
+				AmmoBatch.Reset();
+				ExplosiveBatch.Reset();
+				const double GCStartTime = FPlatformTime::Seconds();
+				CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+				const double BatchGCSeconds = FPlatformTime::Seconds() - GCStartTime;
+				GCSeconds += BatchGCSeconds;
+				MaxGCSeconds = FMath::Max(MaxGCSeconds, BatchGCSeconds);
+			}
+			const double TotalMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+			UE_LOG(LogArcorox, Display, TEXT("Soaked %d ammo boxes and explosives with pooling %s: %.2f ms total, %.2f ms in garbage collection (worst batch %.2f ms)"),
+				Count, bPooling ? TEXT("on") : TEXT("off"), TotalMs, GCSeconds * 1000.0, MaxGCSeconds * 1000.0);
+		};
+
+		RunPass(false);
+		RunPass(true);
+		CVarActorPoolEnabled->Set(bPreviousEnabled, ECVF_SetByConsole);
+	}));
@@ -0,0 +1,218 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Characters/ArcoroxAnimInstance.h"
+#include "Async/ParallelFor.h"
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	/* Snapshot of a character standing still, facing Yaw */
+	FArcoroxAnimSnapshot MakeStandingSnapshot(float Yaw)
+	{
+		FArcoroxAnimSnapshot Snapshot;
+		Snapshot.bValid = true;
+		Snapshot.AimRotation = FRotator(0.f, Yaw, 0.f);
+		Snapshot.ActorRotation = FRotator(0.f, Yaw, 0.f);
+		return Snapshot;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FArcoroxAnimThreadSafeUpdateTest, "Arcorox.Anim.ThreadSafeUpdate",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FArcoroxAnimThreadSafeUpdateTest::RunTest(const FString& Parameters)
+{
+	//Same snapshots updated serially on the game thread and with ParallelFor on the workers must leave identical animation properties
+	const int32 NumCharacters = 64;
+	const int32 NumFrames = 120;
+	const float DeltaTime = 1.f / 60.f;
+	TArray<UArcoroxAnimInstance*> GameThreadInstances;
+	TArray<UArcoroxAnimInstance*> WorkerInstances;
+	FRandomStream Random(1234);
+	for (int32 i = 0; i < NumCharacters; i++)
+	{
+		FArcoroxAnimSnapshot Snapshot;
+		Snapshot.bValid = true;
+		//Every other character stands still so turning in place runs too
+		Snapshot.Velocity = i % 2 ? FVector(Random.FRandRange(-600.f, 600.f), Random.FRandRange(-600.f, 600.f), 0.f) : FVector::ZeroVector;
+		Snapshot.bIsAccelerating = Random.FRand() > 0.5f;
+		Snapshot.bAiming = Random.FRand() > 0.5f;
+		Snapshot.bCrouching = Random.FRand() > 0.5f;
+		Snapshot.bReloading = Random.FRand() > 0.8f;
+		Snapshot.bHasEquippedWeapon = true;
+		Snapshot.EquippedWeaponType = Random.FRand() > 0.5f ? EWeaponType::EWT_AssaultRifle : EWeaponType::EWT_SubmachineGun;
+		for (TArray<UArcoroxAnimInstance*>* Instances : { &GameThreadInstances, &WorkerInstances })
+		{
+			UArcoroxAnimInstance* Instance = NewObject<UArcoroxAnimInstance>(GetTransientPackage());
+			Instance->AddToRoot();
+			Instance->Snapshot = Snapshot;
+			Instances->Add(Instance);
+		}
+	}
+
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		for (int32 i = 0; i < NumCharacters; i++)
+		{
+			for (UArcoroxAnimInstance* Instance : { GameThreadInstances[i], WorkerInstances[i] })
+			{
+				FArcoroxAnimSnapshot& Snapshot = Instance->Snapshot;
+				Snapshot.AimRotation = FRotator(FMath::Sin(Frame * 0.1f) * 30.f, Frame * (2.f + i), 0.f);
+				Snapshot.ActorRotation = FRotator(0.f, Frame * (2.f + i), 0.f);
+				Snapshot.TurningCurve = (Frame / 10) % 2 ? 1.f : 0.f;
+				Snapshot.RotationCurve = Frame * 1.5f;
+			}
+		}
+		for (UArcoroxAnimInstance* Instance : GameThreadInstances) Instance->UpdateFromSnapshot(DeltaTime);
+		ParallelFor(WorkerInstances.Num(), [&WorkerInstances, DeltaTime](int32 Index) { WorkerInstances[Index]->UpdateFromSnapshot(DeltaTime); });
+	}
+
+	for (int32 i = 0; i < NumCharacters; i++)
+	{
+		for (TFieldIterator<FProperty> It(UArcoroxAnimInstance::StaticClass(), EFieldIteratorFlags::ExcludeSuper); It; ++It)
+		{
+			TestTrue(FString::Printf(TEXT("Character %d %s"), i, *It->GetName()), It->Identical_InContainer(GameThreadInstances[i], WorkerInstances[i]));
+		}
+	}
+
+	for (UArcoroxAnimInstance* Instance : GameThreadInstances) Instance->RemoveFromRoot();
+	for (UArcoroxAnimInstance* Instance : WorkerInstances) Instance->RemoveFromRoot();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FArcoroxAnimKnownValuesTest, "Arcorox.Anim.KnownValues",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FArcoroxAnimKnownValuesTest::RunTest(const FString& Parameters)
+{
+	//Expected values follow the rules NativeUpdateAnimation applied before the update moved to the snapshot
+	const float DeltaTime = 1.f / 60.f;
+	UArcoroxAnimInstance* Instance = NewObject<UArcoroxAnimInstance>(GetTransientPackage());
+	Instance->AddToRoot();
+
+	//Recoil scale for every combination of turning in place, crouching, aiming, reloading and equipping
+	struct FRecoilCase
+	{
+		bool bTurningInPlace;
+		bool bCrouching;
+		bool bAiming;
+		bool bReloading;
+		bool bEquipping;
+		float RecoilScale;
+	};
+	const FRecoilCase RecoilCases[] =
+	{
+		{ true, false, false, false, false, 0.f },
+		{ true, true, true, false, false, 0.f },
+		{ true, false, false, true, false, 1.f },
+		{ true, false, false, false, true, 1.f },
+		{ false, true, false, false, false, 0.1f },
+		{ false, true, true, false, false, 0.1f },
+		{ false, true, false, true, false, 1.f },
+		{ false, true, false, false, true, 1.f },
+		{ false, false, false, false, false, 0.5f },
+		{ false, false, true, false, false, 1.f },
+		{ false, false, false, true, false, 1.f },
+		{ false, false, false, false, true, 1.f },
+	};
+	for (const FRecoilCase& Case : RecoilCases)
+	{
+		Instance->Snapshot = MakeStandingSnapshot(0.f);
+		Instance->Snapshot.bCrouching = Case.bCrouching;
+		Instance->Snapshot.bAiming = Case.bAiming;
+		Instance->Snapshot.bReloading = Case.bReloading;
+		Instance->Snapshot.bEquipping = Case.bEquipping;
+		Instance->Snapshot.TurningCurve = Case.bTurningInPlace ? 1.f : 0.f;
+		Instance->UpdateFromSnapshot(DeltaTime);
+		TestEqual(FString::Printf(TEXT("Recoil scale, turning %d crouching %d aiming %d reloading %d equipping %d"), Case.bTurningInPlace, Case.bCrouching, Case.bAiming, Case.bReloading, Case.bEquipping),
+			Instance->RecoilScale, Case.RecoilScale);
+	}
+
+	//Offset state priority is reloading, then in air, then aiming, then hip
+	struct FOffsetCase
+	{
+		bool bReloading;
+		bool bIsFalling;
+		bool bAiming;
+		EOffsetState OffsetState;
+	};
+	const FOffsetCase OffsetCases[] =
+	{
+		{ true, true, true, EOffsetState::EOS_Reloading },
+		{ false, true, true, EOffsetState::EOS_InAir },
+		{ false, false, true, EOffsetState::EOS_Aiming },
+		{ false, false, false, EOffsetState::EOS_Hip },
+	};
+	for (const FOffsetCase& Case : OffsetCases)
+	{
+		Instance->Snapshot = MakeStandingSnapshot(0.f);
+		Instance->Snapshot.bReloading = Case.bReloading;
+		Instance->Snapshot.bIsFalling = Case.bIsFalling;
+		Instance->Snapshot.bAiming = Case.bAiming;
+		Instance->UpdateFromSnapshot(DeltaTime);
+		TestTrue(FString::Printf(TEXT("Offset state, reloading %d falling %d aiming %d"), Case.bReloading, Case.bIsFalling, Case.bAiming), Instance->OffsetState == Case.OffsetState);
+	}
+
+	//Speed is horizontal only, the movement offset is relative to the aim and remembered once the character stops
+	Instance->Snapshot = MakeStandingSnapshot(0.f);
+	Instance->Snapshot.Velocity = FVector(0.f, 300.f, 50.f);
+	Instance->UpdateFromSnapshot(DeltaTime);
+	TestEqual(TEXT("Speed"), Instance->Speed, 300.f, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Movement offset yaw"), Instance->MovementOffsetYaw, 90.f, KINDA_SMALL_NUMBER);
+	Instance->Snapshot.Velocity = FVector::ZeroVector;
+	Instance->UpdateFromSnapshot(DeltaTime);
+	TestEqual(TEXT("Movement offset yaw when stopped"), Instance->MovementOffsetYaw, 0.f, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Last movement offset yaw kept"), Instance->LastMovementOffsetYaw, 90.f, KINDA_SMALL_NUMBER);
+
+	//Turning in place: the root counters the turn, the rotation curve unwinds it and the offset is capped at 90 degrees
+	Instance->Snapshot = MakeStandingSnapshot(0.f);
+	Instance->Snapshot.Velocity = FVector(100.f, 0.f, 0.f);
+	Instance->UpdateFromSnapshot(DeltaTime);
+	TestEqual(TEXT("Moving clears the root yaw offset"), Instance->RootYawOffset, 0.f);
+	Instance->Snapshot = MakeStandingSnapshot(0.f);
+	Instance->UpdateFromSnapshot(DeltaTime);
+	Instance->Snapshot = MakeStandingSnapshot(30.f);
+	Instance->UpdateFromSnapshot(DeltaTime);
+	TestEqual(TEXT("Root yaw offset counters the turn"), Instance->RootYawOffset, -30.f, KINDA_SMALL_NUMBER);
+	TestFalse(TEXT("Not turning in place without the curve"), Instance->bTurningInPlace);
+	Instance->Snapshot.TurningCurve = 1.f;
+	Instance->Snapshot.RotationCurve = 10.f;
+	Instance->UpdateFromSnapshot(DeltaTime);
+	TestTrue(TEXT("Turning in place with the curve"), Instance->bTurningInPlace);
+	TestEqual(TEXT("Rotation curve unwinds the offset"), Instance->RootYawOffset, -20.f, KINDA_SMALL_NUMBER);
+	Instance->Snapshot.ActorRotation.Yaw = 150.f;
+	Instance->UpdateFromSnapshot(DeltaTime);
+	TestEqual(TEXT("Root yaw offset capped"), Instance->RootYawOffset, -90.f, KINDA_SMALL_NUMBER);
+	Instance->Snapshot.bIsFalling = true;
+	Instance->UpdateFromSnapshot(DeltaTime);
+	TestEqual(TEXT("Falling clears the root yaw offset"), Instance->RootYawOffset, 0.f);
+
+	//Lean eases toward the yaw rate at speed 1, so after one second of turning it covers 1 - (1 - 1/60)^60 of the rate, and is clamped at 85
+	auto TurnFor = [Instance, DeltaTime](float DegreesPerSecond, int32 Frames)
+	{
+		for (int32 Frame = 0; Frame < Frames; Frame++)
+		{
+			Instance->Snapshot.ActorRotation.Yaw = FRotator::NormalizeAxis(Instance->Snapshot.ActorRotation.Yaw + DegreesPerSecond * DeltaTime);
+			Instance->UpdateFromSnapshot(DeltaTime);
+		}
+	};
+	Instance->Snapshot = MakeStandingSnapshot(0.f);
+	TurnFor(0.f, 900);
+	TestEqual(TEXT("No lean while not turning"), Instance->DeltaYaw, 0.f, 0.01f);
+	TurnFor(30.f, 60);
+	const float ExpectedLean = 30.f * (1.f - FMath::Pow(1.f - DeltaTime, 60.f));
+	TestEqual(TEXT("Lean after one second of turning"), Instance->DeltaYaw, ExpectedLean, 0.5f);
+	TurnFor(-600.f, 120);
+	TestEqual(TEXT("Lean clamped"), Instance->DeltaYaw, -85.f, KINDA_SMALL_NUMBER);
+
+	Instance->RemoveFromRoot();
+	return true;
+}
+
+#endif
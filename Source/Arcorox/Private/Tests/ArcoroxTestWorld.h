@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+/**
+ * Empty game world with its own standalone game instance, created for the duration of an automation test.
+ * Game instance and world subsystems are initialized and BeginPlay has run.
+ */
+class FArcoroxTestWorld
+{
+public:
+	FArcoroxTestWorld()
+	{
+		GameInstance = NewObject<UGameInstance>(GEngine);
+		GameInstance->AddToRoot();
+		GameInstance->InitializeStandalone(TEXT("ArcoroxTestWorld"));
+		World = GameInstance->GetWorld();
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+	}
+
+	~FArcoroxTestWorld()
+	{
+		GameInstance->Shutdown();
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		GameInstance->RemoveFromRoot();
+	}
+
+	FArcoroxTestWorld(const FArcoroxTestWorld&) = delete;
+	FArcoroxTestWorld& operator=(const FArcoroxTestWorld&) = delete;
+
+	/* Ticks the world, running tickable world subsystems and finishing async traces */
+	void Tick(float DeltaTime = 1.f / 60.f)
+	{
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+
+	UWorld* Get() const { return World; }
+	UGameInstance* GetGameInstance() const { return GameInstance; }
+
+private:
+	UGameInstance* GameInstance;
+	UWorld* World;
+};
+
+#endif
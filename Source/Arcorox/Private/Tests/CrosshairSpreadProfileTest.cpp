@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ArcoroxTestWorld.h"
+#include "Combat/CrosshairSpreadProfile.h"
+#include "Items/ItemDataSubsystem.h"
+#include "Items/Weapon.h"
+#include "Curves/CurveFloat.h"
+#include "Engine/DataTable.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCrosshairSpreadProfileBakeTest, "Arcorox.Combat.SpreadProfile.Bake",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FCrosshairSpreadProfileBakeTest::RunTest(const FString& Parameters)
+{
+	//The baked table must follow the profile within this much spread at every speed
+	const float Tolerance = 0.01f;
+	auto TestBake = [this, Tolerance](const FCrosshairSpreadProfile& Profile, const FString& Name)
+	{
+		FBakedCrosshairSpread Baked;
+		Baked.Bake(Profile);
+		const float MaxError = Baked.MeasureMaxError(Profile);
+		AddInfo(FString::Printf(TEXT("Crosshair spread profile %s: max error %.5f"), *Name, MaxError));
+		TestTrue(FString::Printf(TEXT("%s baked within %.3f"), *Name, Tolerance), MaxError <= Tolerance);
+		TestEqual(FString::Printf(TEXT("%s base spread"), *Name), Baked.BaseSpread, Profile.BaseSpread);
+		TestEqual(FString::Printf(TEXT("%s shoot spread"), *Name), Baked.ShootSpread, Profile.ShootSpread);
+	};
+
+	TestBake(FCrosshairSpreadProfile(), TEXT("Default"));
+
+	//An eased curve is the shape the linear table approximates worst
+	UCurveFloat* VelocityCurve = NewObject<UCurveFloat>(GetTransientPackage());
+	VelocityCurve->FloatCurve.AddKey(0.f, 0.f);
+	VelocityCurve->FloatCurve.AddKey(0.5f, 0.2f);
+	VelocityCurve->FloatCurve.AddKey(1.f, 1.f);
+	for (FRichCurveKey& Key : VelocityCurve->FloatCurve.Keys) Key.InterpMode = RCIM_Cubic;
+	VelocityCurve->FloatCurve.AutoSetTangents();
+	FCrosshairSpreadProfile CurveProfile;
+	CurveProfile.VelocityCurve = VelocityCurve;
+	TestBake(CurveProfile, TEXT("Curve"));
+
+	UDataTable* WeaponTypeDataTable = UItemDataSubsystem::LoadWeaponTypeDataTable();
+	if (!TestNotNull(TEXT("Weapon Type Data Table"), WeaponTypeDataTable)) return false;
+	for (int32 i = 0; i < static_cast<int32>(EWeaponType::EWT_MAX); i++)
+	{
+		const FName RowName = UItemDataSubsystem::GetWeaponTypeRowName(static_cast<EWeaponType>(i));
+		const FWeaponTypeTable* Row = WeaponTypeDataTable->FindRow<FWeaponTypeTable>(RowName, TEXT(""));
+		if (TestNotNull(FString::Printf(TEXT("Weapon type row %s"), *RowName.ToString()), Row)) TestBake(Row->CrosshairSpreadProfile, RowName.ToString());
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCrosshairSpreadWeaponDefaultTest, "Arcorox.Combat.SpreadProfile.WeaponDefault",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FCrosshairSpreadWeaponDefaultTest::RunTest(const FString& Parameters)
+{
+	FArcoroxTestWorld TestWorld;
+	const FBakedCrosshairSpread& Default = FBakedCrosshairSpread::GetDefault();
+
+	//Before construction reads the Weapon Type Data Table the weapon must already hold the default profile, not zeros
+	AWeapon* Weapon = TestWorld.Get()->SpawnActorDeferred<AWeapon>(AWeapon::StaticClass(), FTransform::Identity, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!TestNotNull(TEXT("Weapon spawned"), Weapon)) return false;
+	const FBakedCrosshairSpread& Spread = Weapon->GetCrosshairSpread();
+	TestEqual(TEXT("Base spread"), Spread.BaseSpread, Default.BaseSpread);
+	TestEqual(TEXT("In air spread"), Spread.InAirSpread, Default.InAirSpread);
+	TestEqual(TEXT("Aim spread"), Spread.AimSpread, Default.AimSpread);
+	TestEqual(TEXT("Shoot spread"), Spread.ShootSpread, Default.ShootSpread);
+	for (const float Speed : { 0.f, 150.f, 300.f, 600.f, 900.f })
+	{
+		TestEqual(FString::Printf(TEXT("Velocity factor at %.0f"), Speed), Spread.SampleVelocityFactor(Speed), Default.SampleVelocityFactor(Speed));
+	}
+	Weapon->FinishSpawning(FTransform::Identity);
+	return true;
+}
+
+#endif
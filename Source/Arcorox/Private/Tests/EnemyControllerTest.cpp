@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ArcoroxTestWorld.h"
+#include "Enemy/EnemyController.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+namespace
+{
+	template<typename TKeyType>
+	void AddBlackboardKey(UBlackboardData* BlackboardData, const FName& Name)
+	{
+		FBlackboardEntry Entry;
+		Entry.EntryName = Name;
+		Entry.KeyType = NewObject<TKeyType>(BlackboardData);
+		BlackboardData->Keys.Add(Entry);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnemyBlackboardKeysTest, "Arcorox.Enemy.BlackboardKeys",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FEnemyBlackboardKeysTest::RunTest(const FString& Parameters)
+{
+	//Same keys as the enemy blackboard asset, minus Stunned to cover a missing key
+	UBlackboardData* BlackboardData = NewObject<UBlackboardData>(GetTransientPackage());
+	AddBlackboardKey<UBlackboardKeyType_Object>(BlackboardData, TEXT("Target"));
+	AddBlackboardKey<UBlackboardKeyType_Bool>(BlackboardData, TEXT("InAttackRange"));
+	AddBlackboardKey<UBlackboardKeyType_Vector>(BlackboardData, TEXT("PatrolPoint"));
+	AddBlackboardKey<UBlackboardKeyType_Vector>(BlackboardData, TEXT("PatrolPoint2"));
+	BlackboardData->UpdateKeyIDs();
+
+	FArcoroxTestWorld TestWorld;
+	AEnemyController* EnemyController = TestWorld.Get()->SpawnActor<AEnemyController>();
+	if (!TestNotNull(TEXT("Enemy controller"), EnemyController)) return false;
+	UBlackboardComponent* Blackboard = EnemyController->GetBlackboardComponent();
+	if (!TestTrue(TEXT("Blackboard initialized"), Blackboard && Blackboard->InitializeBlackboard(*BlackboardData))) return false;
+	EnemyController->ResolveBlackboardKeys();
+
+	const FEnemyBlackboardKeys& Keys = EnemyController->GetBlackboardKeys();
+	TestEqual(TEXT("Target key"), Keys.Target, Blackboard->GetKeyID(TEXT("Target")));
+	TestEqual(TEXT("InAttackRange key"), Keys.InAttackRange, Blackboard->GetKeyID(TEXT("InAttackRange")));
+	TestEqual(TEXT("PatrolPoint key"), Keys.PatrolPoint, Blackboard->GetKeyID(TEXT("PatrolPoint")));
+	TestEqual(TEXT("PatrolPoint2 key"), Keys.PatrolPoint2, Blackboard->GetKeyID(TEXT("PatrolPoint2")));
+	TestEqual(TEXT("Missing Stunned key"), Keys.Stunned, FBlackboard::InvalidKey);
+
+	//Observers are what re-evaluate the behavior tree, so they count the writes that went through
+	TMap<FBlackboard::FKey, int32> Notifications;
+	for (const FBlackboard::FKey Key : { Keys.Target, Keys.InAttackRange, Keys.PatrolPoint, Keys.PatrolPoint2 })
+	{
+		Blackboard->RegisterObserver(Key, EnemyController, FOnBlackboardChangeNotification::CreateLambda([&Notifications](const UBlackboardComponent&, FBlackboard::FKey ChangedKey)
+		{
+			Notifications.FindOrAdd(ChangedKey)++;
+			return EBlackboardNotificationResult::ContinueObserving;
+		}));
+	}
+
+	EnemyController->SetInAttackRangeKey(true);
+	EnemyController->SetInAttackRangeKey(true);
+	TestTrue(TEXT("InAttackRange written"), Blackboard->GetValueAsBool(TEXT("InAttackRange")));
+	EnemyController->SetInAttackRangeKey(false);
+	TestFalse(TEXT("InAttackRange cleared"), Blackboard->GetValueAsBool(TEXT("InAttackRange")));
+	TestEqual(TEXT("InAttackRange notifications"), Notifications.FindRef(Keys.InAttackRange), 2);
+
+	EnemyController->SetTargetKey(EnemyController);
+	EnemyController->SetTargetKey(EnemyController);
+	TestTrue(TEXT("Target written"), Blackboard->GetValueAsObject(TEXT("Target")) == EnemyController);
+	TestEqual(TEXT("Target notifications"), Notifications.FindRef(Keys.Target), 1);
+
+	const FVector PatrolPoint(100.f, 200.f, 0.f);
+	const FVector PatrolPoint2(-100.f, 50.f, 0.f);
+	EnemyController->SetPatrolPointKeys(PatrolPoint, PatrolPoint2);
+	EnemyController->SetPatrolPointKeys(PatrolPoint, PatrolPoint2);
+	TestEqual(TEXT("PatrolPoint written"), Blackboard->GetValueAsVector(TEXT("PatrolPoint")), PatrolPoint);
+	TestEqual(TEXT("PatrolPoint2 written"), Blackboard->GetValueAsVector(TEXT("PatrolPoint2")), PatrolPoint2);
+	TestEqual(TEXT("PatrolPoint notifications"), Notifications.FindRef(Keys.PatrolPoint), 1);
+	TestEqual(TEXT("PatrolPoint2 notifications"), Notifications.FindRef(Keys.PatrolPoint2), 1);
+
+	//A key missing from the asset is ignored
+	EnemyController->SetStunnedKey(true);
+	Blackboard->UnregisterObserversFrom(EnemyController);
+	return true;
+}
+
+#endif
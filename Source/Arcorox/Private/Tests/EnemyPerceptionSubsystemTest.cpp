@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ArcoroxTestWorld.h"
+#include "Enemy/EnemyPerceptionSubsystem.h"
+#include "Components/CapsuleComponent.h"
+#include "CollisionShape.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnemyPerceptionCapsuleRangeTest, "Arcorox.Enemy.Perception.CapsuleRange",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FEnemyPerceptionCapsuleRangeTest::RunTest(const FString& Parameters)
+{
+	//The spatial hash must call a target in range exactly when the enemy's range sphere would overlap the target capsule
+	FArcoroxTestWorld TestWorld;
+	UWorld* World = TestWorld.Get();
+	const FVector CapsuleCenter(0.f, 0.f, 100.f);
+	const float CapsuleRadius = 42.f;
+	const float CapsuleHalfHeight = 96.f;
+	AActor* Target = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(CapsuleCenter));
+	UCapsuleComponent* Capsule = NewObject<UCapsuleComponent>(Target);
+	Capsule->SetCapsuleSize(CapsuleRadius, CapsuleHalfHeight);
+	Capsule->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	Capsule->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Block);
+	Target->SetRootComponent(Capsule);
+	Capsule->RegisterComponent();
+	Target->SetActorLocation(CapsuleCenter);
+
+	FRandomStream Random(1234);
+	int32 NumInRange = 0;
+	for (int32 i = 0; i < 2000; i++)
+	{
+		const float SphereRadius = Random.FRandRange(50.f, 600.f);
+		const FVector Location = CapsuleCenter + FVector(Random.FRandRange(-800.f, 800.f), Random.FRandRange(-800.f, 800.f), Random.FRandRange(-400.f, 400.f));
+		const float Distance = UEnemyPerceptionSubsystem::GetDistanceToCapsule(Location, CapsuleCenter, CapsuleRadius, CapsuleHalfHeight);
+		//Physics shapes carry a small contact offset, so samples right on the surface are skipped
+		if (FMath::Abs(Distance - SphereRadius) < 2.f) continue;
+		const bool bInRange = Distance <= SphereRadius;
+		const bool bOverlaps = World->OverlapAnyTestByChannel(Location, FQuat::Identity, ECollisionChannel::ECC_Pawn, FCollisionShape::MakeSphere(SphereRadius));
+		TestEqual(FString::Printf(TEXT("Sphere %.0f at %s"), SphereRadius, *Location.ToString()), bInRange, bOverlaps);
+		if (bInRange) NumInRange++;
+	}
+	//Centre to centre distance alone misses spheres that only reach the capsule surface
+	const FVector TouchingLocation = CapsuleCenter + FVector(CapsuleRadius + 90.f, 0.f, 0.f);
+	TestTrue(TEXT("Sphere reaching the capsule side is in range"), UEnemyPerceptionSubsystem::GetDistanceToCapsule(TouchingLocation, CapsuleCenter, CapsuleRadius, CapsuleHalfHeight) <= 100.f);
+	TestTrue(TEXT("Some samples were in range"), NumInRange > 0);
+	return true;
+}
+
+#endif
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ArcoroxTestWorld.h"
+#include "HUD/HUDDataComponent.h"
+#include "HUD/ArcoroxHUDWidget.h"
+#include "HAL/IConsoleManager.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHUDSnapshotPublishTest, "Arcorox.HUD.SnapshotPublish",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FHUDSnapshotPublishTest::RunTest(const FString& Parameters)
+{
+	IConsoleVariable* SpreadEpsilon = IConsoleManager::Get().FindConsoleVariable(TEXT("Arcorox.HUD.SpreadEpsilon"));
+	if (!TestNotNull(TEXT("Arcorox.HUD.SpreadEpsilon exists"), SpreadEpsilon)) return false;
+	const float PreviousSpreadEpsilon = SpreadEpsilon->GetFloat();
+	SpreadEpsilon->Set(0.01f, ECVF_SetByCode);
+
+	UHUDDataComponent* DataModel = NewObject<UHUDDataComponent>(GetTransientPackage());
+	int32 NumBroadcasts = 0;
+	DataModel->OnSnapshotPublished.AddLambda([&NumBroadcasts](const FHUDSnapshot&) { NumBroadcasts++; });
+	FHUDSnapshot Snapshot = DataModel->GetSnapshot();
+	TestFalse(TEXT("Unchanged snapshot is not published"), DataModel->Publish(Snapshot));
+	TestEqual(TEXT("Initial version"), DataModel->GetVersion(), 0);
+
+	Snapshot.MagazineAmmo = 30;
+	TestTrue(TEXT("Changed magazine is published"), DataModel->Publish(Snapshot));
+	TestEqual(TEXT("Version after a change"), DataModel->GetVersion(), 1);
+	TestTrue(TEXT("Magazine marked changed"), UHUDDataComponent::HasFieldChanged(DataModel->GetSnapshot(), EHUDField::EHF_MagazineAmmo));
+	TestFalse(TEXT("Carried ammo not marked changed"), UHUDDataComponent::HasFieldChanged(DataModel->GetSnapshot(), EHUDField::EHF_CarriedAmmo));
+
+	//Spread drifts below the epsilon are neither published nor allowed to add up
+	Snapshot.CrosshairSpread = 0.006f;
+	TestFalse(TEXT("Spread below epsilon is not published"), DataModel->Publish(Snapshot));
+	Snapshot.CrosshairSpread = 0.009f;
+	Snapshot.CombatState = ECombatState::ECS_Firing;
+	TestTrue(TEXT("Combat state change is published"), DataModel->Publish(Snapshot));
+	TestEqual(TEXT("Spread below epsilon keeps the published value"), DataModel->GetSnapshot().CrosshairSpread, 0.f);
+	TestFalse(TEXT("Spread not marked changed"), UHUDDataComponent::HasFieldChanged(DataModel->GetSnapshot(), EHUDField::EHF_CrosshairSpread));
+	Snapshot.CrosshairSpread = 0.02f;
+	TestTrue(TEXT("Spread past epsilon is published"), DataModel->Publish(Snapshot));
+	TestTrue(TEXT("Spread marked changed"), UHUDDataComponent::HasFieldChanged(DataModel->GetSnapshot(), EHUDField::EHF_CrosshairSpread));
+	TestEqual(TEXT("One broadcast per version"), NumBroadcasts, DataModel->GetVersion());
+	TestFalse(TEXT("EHF_MAX is never changed"), UHUDDataComponent::HasFieldChanged(DataModel->GetSnapshot(), EHUDField::EHF_MAX));
+
+	SpreadEpsilon->Set(PreviousSpreadEpsilon, ECVF_SetByCode);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHUDWidgetPullTest, "Arcorox.HUD.WidgetPull",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FHUDWidgetPullTest::RunTest(const FString& Parameters)
+{
+	FArcoroxTestWorld TestWorld;
+	UArcoroxHUDWidget* Widget = CreateWidget<UArcoroxHUDWidget>(TestWorld.Get(), UArcoroxHUDWidget::StaticClass());
+	if (!TestNotNull(TEXT("HUD widget"), Widget)) return false;
+	UHUDDataComponent* DataModel = NewObject<UHUDDataComponent>(GetTransientPackage());
+	Widget->SetDataSource(DataModel);
+
+	FHUDSnapshot Snapshot = DataModel->GetSnapshot();
+	Snapshot.MagazineAmmo = 12;
+	DataModel->Publish(Snapshot);
+	TestTrue(TEXT("New version is pulled"), Widget->PullSnapshot());
+	TestFalse(TEXT("Same version is not pulled again"), Widget->PullSnapshot());
+	TestTrue(TEXT("Forced pull"), Widget->PullSnapshot(true));
+	Snapshot.MagazineAmmo = 11;
+	DataModel->Publish(Snapshot);
+	TestTrue(TEXT("Next version is pulled"), Widget->PullSnapshot());
+	TestFalse(TEXT("Nothing new"), Widget->PullSnapshot());
+	return true;
+}
+
+#endif
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ArcoroxTestWorld.h"
+#include "Combat/HitscanSubsystem.h"
+#include "Components/BoxComponent.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	/* Spawns an actor with a box blocking the visibility channel */
+	AActor* SpawnBlocker(UWorld* World, const FVector& Location, const FVector& Extent)
+	{
+		AActor* Blocker = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Location));
+		UBoxComponent* Box = NewObject<UBoxComponent>(Blocker);
+		Box->SetBoxExtent(Extent);
+		Box->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		Box->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Block);
+		Blocker->SetRootComponent(Box);
+		Box->RegisterComponent();
+		Blocker->SetActorLocation(Location);
+		return Blocker;
+	}
+
+	FHitscanShot MakeShot(const FVector& BarrelLocation, const FVector& CrosshairStart, const FVector& CrosshairEnd)
+	{
+		FHitscanShot Shot;
+		Shot.BarrelTransform = FTransform((CrosshairEnd - BarrelLocation).Rotation(), BarrelLocation);
+		Shot.CrosshairStart = CrosshairStart;
+		Shot.CrosshairEnd = CrosshairEnd;
+		return Shot;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitscanModeParityTest, "Arcorox.Combat.Hitscan.ModeParity",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FHitscanModeParityTest::RunTest(const FString& Parameters)
+{
+	IConsoleVariable* HitscanMode = IConsoleManager::Get().FindConsoleVariable(TEXT("Arcorox.Hitscan.Mode"));
+	if (!TestNotNull(TEXT("Arcorox.Hitscan.Mode exists"), HitscanMode)) return false;
+	const int32 PreviousMode = HitscanMode->GetInt();
+
+	FArcoroxTestWorld TestWorld;
+	UWorld* World = TestWorld.Get();
+	UHitscanSubsystem* Hitscan = World->GetSubsystem<UHitscanSubsystem>();
+	if (!TestNotNull(TEXT("Hitscan subsystem"), Hitscan)) return false;
+
+	//A wall in front of the shooter, a post between barrel and wall, and nothing to the side
+	AActor* Wall = SpawnBlocker(World, FVector(2000.f, 0.f, 0.f), FVector(50.f, 1000.f, 1000.f));
+	AActor* Post = SpawnBlocker(World, FVector(1000.f, 300.f, 0.f), FVector(50.f, 50.f, 1000.f));
+	const FVector Barrel(0.f, 50.f, 0.f);
+	TArray<FHitscanShot> Shots;
+	Shots.Add(MakeShot(Barrel, FVector(0.f, 0.f, 0.f), FVector(50000.f, 0.f, 0.f)));
+	Shots.Add(MakeShot(Barrel, FVector(0.f, 0.f, 0.f), FVector(50000.f, 12000.f, 0.f)));
+	Shots.Add(MakeShot(Barrel, FVector(0.f, 0.f, 0.f), FVector(0.f, 50000.f, 0.f)));
+	Shots.Add(MakeShot(Barrel, FVector(0.f, 0.f, 0.f), FVector(50000.f, -20000.f, 500.f)));
+	FHitscanShot CachedCrosshairShot = MakeShot(Barrel, FVector(0.f, 0.f, 0.f), FVector(50000.f, 0.f, 0.f));
+	World->LineTraceSingleByChannel(CachedCrosshairShot.CrosshairHit, CachedCrosshairShot.CrosshairStart, CachedCrosshairShot.CrosshairEnd, ECollisionChannel::ECC_Visibility);
+	CachedCrosshairShot.bHasCrosshairHit = true;
+	Shots.Add(CachedCrosshairShot);
+
+	auto ResolveAll = [&](int32 Mode)
+	{
+		HitscanMode->Set(Mode, ECVF_SetByCode);
+		TArray<FHitscanResult> Results;
+		Results.SetNum(Shots.Num());
+		TArray<int32> DeliveryOrder;
+		for (int32 i = 0; i < Shots.Num(); i++)
+		{
+			Hitscan->QueueShot(Shots[i], FOnHitscanResolved::CreateLambda([&Results, &DeliveryOrder, i](const FHitscanResult& Result)
+			{
+				Results[i] = Result;
+				DeliveryOrder.Add(i);
+			}));
+		}
+		for (int32 Frame = 0; Frame < 16 && DeliveryOrder.Num() < Shots.Num(); Frame++) TestWorld.Tick();
+		TestEqual(FString::Printf(TEXT("Mode %d resolved every shot"), Mode), DeliveryOrder.Num(), Shots.Num());
+		for (int32 i = 0; i < DeliveryOrder.Num(); i++)
+		{
+			TestEqual(FString::Printf(TEXT("Mode %d delivered shots in firing order"), Mode), DeliveryOrder[i], i);
+		}
+		return Results;
+	};
+
+	const TArray<FHitscanResult> SyncResults = ResolveAll(0);
+	const TArray<FHitscanResult> AsyncResults = ResolveAll(1);
+	HitscanMode->Set(PreviousMode, ECVF_SetByCode);
+
+	TestEqual(TEXT("Straight shot hits the wall"), SyncResults[0].Hit.GetActor(), Wall);
+	TestEqual(TEXT("Angled shot hits the post"), SyncResults[1].Hit.GetActor(), Post);
+	TestFalse(TEXT("Side shot hits nothing"), SyncResults[2].bBlockingHit);
+	for (int32 i = 0; i < Shots.Num(); i++)
+	{
+		const FHitscanResult& Sync = SyncResults[i];
+		const FHitscanResult& Async = AsyncResults[i];
+		TestEqual(FString::Printf(TEXT("Shot %d blocking hit"), i), Async.bBlockingHit, Sync.bBlockingHit);
+		TestEqual(FString::Printf(TEXT("Shot %d hit actor"), i), Async.Hit.GetActor(), Sync.Hit.GetActor());
+		TestEqual(FString::Printf(TEXT("Shot %d hit bone"), i), Async.Hit.BoneName, Sync.Hit.BoneName);
+		TestTrue(FString::Printf(TEXT("Shot %d hit location"), i), Async.Hit.Location.Equals(Sync.Hit.Location, 0.1f));
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ArcoroxTestWorld.h"
+#include "Items/InventoryComponent.h"
+#include "Items/Item.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventorySlotsTest, "Arcorox.Inventory.Slots",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FInventorySlotsTest::RunTest(const FString& Parameters)
+{
+	FArcoroxTestWorld TestWorld;
+	AItem* Item = TestWorld.Get()->SpawnActor<AItem>();
+	if (!TestNotNull(TEXT("Item"), Item)) return false;
+
+	//A new component takes its size from Capacity when initialized
+	UInventoryComponent* Inventory = NewObject<UInventoryComponent>(Item);
+	Inventory->InitializeComponent();
+	TestEqual(TEXT("Default capacity"), Inventory->GetCapacity(), 6);
+	TestEqual(TEXT("Initialized inventory is empty"), Inventory->GetNumItems(), 0);
+
+	Inventory->SetCapacity(3);
+	TestEqual(TEXT("Capacity"), Inventory->GetCapacity(), 3);
+	TestEqual(TEXT("New inventory is empty"), Inventory->GetNumItems(), 0);
+	TestEqual(TEXT("First empty slot"), Inventory->GetEmptySlot(), 0);
+	TestEqual(TEXT("First item slot"), Inventory->AddItem(Item), 0);
+	TestEqual(TEXT("Second item slot"), Inventory->AddItem(Item), 1);
+	TestEqual(TEXT("Third item slot"), Inventory->AddItem(Item), 2);
+	TestTrue(TEXT("Inventory is full"), Inventory->IsFull());
+	TestEqual(TEXT("Full inventory has no empty slot"), Inventory->GetEmptySlot(), static_cast<int32>(INDEX_NONE));
+	TestEqual(TEXT("Adding to a full inventory fails"), Inventory->AddItem(Item), static_cast<int32>(INDEX_NONE));
+
+	TestTrue(TEXT("Removed item is returned"), Inventory->RemoveItemAt(1) == Item);
+	TestEqual(TEXT("Removed slot becomes the empty slot"), Inventory->GetEmptySlot(), 1);
+	TestNull(TEXT("Removed slot is cleared"), Inventory->GetItemAt(1));
+	TestEqual(TEXT("Items after removal"), Inventory->GetNumItems(), 2);
+	TestNull(TEXT("Setting an empty slot replaces nothing"), Inventory->SetItemAt(1, Item));
+	TestTrue(TEXT("Setting an empty slot fills it"), Inventory->IsFull());
+	TestNull(TEXT("Slot past the end"), Inventory->GetItemAt(3));
+	TestNull(TEXT("Negative slot"), Inventory->RemoveItemAt(-1));
+
+	Inventory->ClearItems();
+	TestEqual(TEXT("Cleared inventory is empty"), Inventory->GetNumItems(), 0);
+	TestEqual(TEXT("Cleared inventory starts at slot 0"), Inventory->GetEmptySlot(), 0);
+
+	Inventory->SetCapacity(UInventoryComponent::MaxCapacity);
+	for (int32 i = 0; i < UInventoryComponent::MaxCapacity; i++) Inventory->AddItem(Item);
+	TestTrue(TEXT("Inventory at MaxCapacity fills every bit"), Inventory->IsFull());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryAmmoTest, "Arcorox.Inventory.Ammo",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FInventoryAmmoTest::RunTest(const FString& Parameters)
+{
+	UInventoryComponent* Inventory = NewObject<UInventoryComponent>();
+	TestFalse(TEXT("New inventory carries no ammo"), Inventory->HasAmmo(EAmmoType::EAT_9mm));
+	Inventory->SetAmmo(EAmmoType::EAT_9mm, 10);
+	Inventory->AddAmmo(EAmmoType::EAT_9mm, 5);
+	TestEqual(TEXT("9mm ammo"), Inventory->GetAmmo(EAmmoType::EAT_9mm), 15);
+	TestEqual(TEXT("Ammo types are counted separately"), Inventory->GetAmmo(EAmmoType::EAT_556), 0);
+	TestEqual(TEXT("Taking more than carried takes what is left"), Inventory->TakeAmmo(EAmmoType::EAT_9mm, 20), 15);
+	TestFalse(TEXT("No ammo left"), Inventory->HasAmmo(EAmmoType::EAT_9mm));
+	Inventory->AddAmmo(EAmmoType::EAT_556, -5);
+	TestEqual(TEXT("Ammo does not go negative"), Inventory->GetAmmo(EAmmoType::EAT_556), 0);
+	Inventory->SetAmmo(EAmmoType::EAT_MAX, 10);
+	TestEqual(TEXT("EAT_MAX has no ammo"), Inventory->GetAmmo(EAmmoType::EAT_MAX), 0);
+	return true;
+}
+
+#endif
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ArcoroxTestWorld.h"
+#include "Items/ItemDataSubsystem.h"
+#include "Items/Item.h"
+#include "Items/Weapon.h"
+#include "Engine/DataTable.h"
+#include "HAL/IConsoleManager.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemDataRowCacheTest, "Arcorox.Items.DataCache.Rows",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FItemDataRowCacheTest::RunTest(const FString& Parameters)
+{
+	FArcoroxTestWorld TestWorld;
+	const UItemDataSubsystem* ItemData = UGameInstance::GetSubsystem<UItemDataSubsystem>(TestWorld.GetGameInstance());
+	if (!TestNotNull(TEXT("Item data subsystem"), ItemData)) return false;
+	UDataTable* ItemRarityDataTable = UItemDataSubsystem::LoadItemRarityDataTable();
+	UDataTable* WeaponTypeDataTable = UItemDataSubsystem::LoadWeaponTypeDataTable();
+	if (!TestNotNull(TEXT("Item Rarity Data Table"), ItemRarityDataTable) || !TestNotNull(TEXT("Weapon Type Data Table"), WeaponTypeDataTable)) return false;
+
+	for (int32 i = 0; i < static_cast<int32>(EItemRarity::EIR_MAX); i++)
+	{
+		const EItemRarity Rarity = static_cast<EItemRarity>(i);
+		const FItemRarityTable* Row = ItemRarityDataTable->FindRow<FItemRarityTable>(UItemDataSubsystem::GetItemRarityRowName(Rarity), TEXT(""));
+		TestNotNull(FString::Printf(TEXT("Item rarity row %d"), i), Row);
+		TestTrue(FString::Printf(TEXT("Cached item rarity row %d"), i), ItemData->GetItemRarityRow(Rarity) == Row);
+	}
+	for (int32 i = 0; i < static_cast<int32>(EWeaponType::EWT_MAX); i++)
+	{
+		const EWeaponType Type = static_cast<EWeaponType>(i);
+		const FWeaponTypeTable* Row = WeaponTypeDataTable->FindRow<FWeaponTypeTable>(UItemDataSubsystem::GetWeaponTypeRowName(Type), TEXT(""));
+		TestNotNull(FString::Printf(TEXT("Weapon type row %d"), i), Row);
+		TestTrue(FString::Printf(TEXT("Cached weapon type row %d"), i), ItemData->GetWeaponTypeRow(Type) == Row);
+	}
+	TestNull(TEXT("Out of range rarity"), ItemData->GetItemRarityRow(EItemRarity::EIR_MAX));
+	TestNull(TEXT("Out of range weapon type"), ItemData->GetWeaponTypeRow(EWeaponType::EWT_MAX));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemDataSpawnParityTest, "Arcorox.Items.DataCache.SpawnParity",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FItemDataSpawnParityTest::RunTest(const FString& Parameters)
+{
+	IConsoleVariable* UseDataCache = IConsoleManager::Get().FindConsoleVariable(TEXT("Arcorox.Items.UseDataCache"));
+	if (!TestNotNull(TEXT("Arcorox.Items.UseDataCache exists"), UseDataCache)) return false;
+	const bool bPreviousUseDataCache = UseDataCache->GetBool();
+
+	FArcoroxTestWorld TestWorld;
+	UWorld* World = TestWorld.Get();
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	auto SpawnWeapon = [World, &SpawnParams, UseDataCache](bool bUseCache)
+	{
+		UseDataCache->Set(bUseCache, ECVF_SetByCode);
+		return World->SpawnActor<AWeapon>(AWeapon::StaticClass(), FTransform::Identity, SpawnParams);
+	};
+	AWeapon* Direct = SpawnWeapon(false);
+	AWeapon* Cached = SpawnWeapon(true);
+	UseDataCache->Set(bPreviousUseDataCache, ECVF_SetByCode);
+	if (!TestNotNull(TEXT("Weapon spawned without cache"), Direct) || !TestNotNull(TEXT("Weapon spawned with cache"), Cached)) return false;
+
+	TestEqual(TEXT("Ammo"), Cached->GetAmmo(), Direct->GetAmmo());
+	TestEqual(TEXT("Magazine capacity"), Cached->GetMagazineCapacity(), Direct->GetMagazineCapacity());
+	TestTrue(TEXT("Ammo type"), Cached->GetAmmoType() == Direct->GetAmmoType());
+	TestEqual(TEXT("Fire rate"), Cached->GetFireRate(), Direct->GetFireRate());
+	TestEqual(TEXT("Damage"), Cached->GetDamage(), Direct->GetDamage());
+	TestEqual(TEXT("Reload montage section"), Cached->GetReloadMontageSection(), Direct->GetReloadMontageSection());
+	return true;
+}
+
+#endif
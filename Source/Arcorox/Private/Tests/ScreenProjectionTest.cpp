@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HUD/ScreenProjection.h"
+#include "SceneView.h"
+
+namespace
+{
+	FSceneViewProjectionData MakeProjectionData(const FVector& ViewLocation, const FRotator& ViewRotation, float FOV, const FIntRect& ViewRect)
+	{
+		FSceneViewProjectionData ProjectionData;
+		ProjectionData.ViewOrigin = ViewLocation;
+		//Swap axes from Unreal's X forward to the view's Z forward, as ULocalPlayer::GetProjectionData does
+		ProjectionData.ViewRotationMatrix = FInverseRotationMatrix(ViewRotation) * FMatrix(
+			FPlane(0, 0, 1, 0),
+			FPlane(1, 0, 0, 0),
+			FPlane(0, 1, 0, 0),
+			FPlane(0, 0, 0, 1));
+		ProjectionData.ProjectionMatrix = FReversedZPerspectiveMatrix(FMath::DegreesToRadians(FOV * 0.5f), ViewRect.Width(), ViewRect.Height(), 10.f);
+		ProjectionData.SetViewRectangle(ViewRect);
+		return ProjectionData;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FScreenProjectionTest, "Arcorox.HUD.ScreenProjection",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FScreenProjectionTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(1234);
+	const FSceneViewProjectionData Views[] = {
+		MakeProjectionData(FVector::ZeroVector, FRotator::ZeroRotator, 90.f, FIntRect(0, 0, 1920, 1080)),
+		MakeProjectionData(FVector(1200.f, -300.f, 250.f), FRotator(-15.f, 135.f, 0.f), 70.f, FIntRect(0, 0, 1280, 720)),
+		//Split screen style view rect offset from the viewport origin
+		MakeProjectionData(FVector(-500.f, 800.f, 90.f), FRotator(30.f, -60.f, 5.f), 100.f, FIntRect(640, 360, 1920, 1080))
+	};
+
+	for (int32 ViewIndex = 0; ViewIndex < UE_ARRAY_COUNT(Views); ViewIndex++)
+	{
+		const FSceneViewProjectionData& ProjectionData = Views[ViewIndex];
+		const FMatrix ViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix();
+		const FIntRect ViewRect = ProjectionData.GetConstrainedViewRect();
+
+		//Points all around the camera, so some are behind it
+		TArray<FVector> Points;
+		for (int32 i = 0; i < 10000; i++) Points.Add(ProjectionData.ViewOrigin + Random.GetUnitVector() * Random.FRandRange(50.f, 20000.f));
+		TArray<FVector2D> ScreenPositions;
+		ScreenPositions.SetNumZeroed(Points.Num());
+		TArray<bool> OnScreen;
+		OnScreen.SetNumZeroed(Points.Num());
+
+		FScreenProjection Projection;
+		Projection.Capture(ProjectionData);
+		Projection.ProjectPoints(Points, ScreenPositions, OnScreen);
+
+		int32 NumInFront = 0;
+		int32 NumMismatches = 0;
+		double MaxError = 0.0;
+		for (int32 i = 0; i < Points.Num(); i++)
+		{
+			FVector2D ReferencePosition;
+			const bool bReferenceOnScreen = FSceneView::ProjectWorldToScreen(Points[i], ViewRect, ViewProjectionMatrix, ReferencePosition);
+			if (bReferenceOnScreen != OnScreen[i]) NumMismatches++;
+			if (!bReferenceOnScreen) continue;
+			NumInFront++;
+			MaxError = FMath::Max(MaxError, FVector2D::Distance(ReferencePosition, ScreenPositions[i]));
+		}
+		TestEqual(FString::Printf(TEXT("View %d points in front of the camera agree"), ViewIndex), NumMismatches, 0);
+		TestTrue(FString::Printf(TEXT("View %d projected points in front of the camera"), ViewIndex), NumInFront > 0);
+		TestTrue(FString::Printf(TEXT("View %d largest difference %.5f px"), ViewIndex, MaxError), MaxError <= 0.01);
+
+		FVector2D SinglePosition;
+		const bool bSingleOnScreen = Projection.Project(Points[0], SinglePosition);
+		TestEqual(FString::Printf(TEXT("View %d single point matches the batch"), ViewIndex), bSingleOnScreen, OnScreen[0]);
+		if (bSingleOnScreen) TestTrue(FString::Printf(TEXT("View %d single point position"), ViewIndex), SinglePosition.Equals(ScreenPositions[0]));
+	}
+
+	FScreenProjection Uncaptured;
+	FVector2D Unused;
+	TestFalse(TEXT("Uncaptured projection reports nothing on screen"), Uncaptured.Project(FVector(100.f, 0.f, 0.f), Unused));
+	return true;
+}
+
+#endif
@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ArcoroxTestWorld.h"
+#include "Items/WeaponAssetSubsystem.h"
+#include "Items/ItemDataSubsystem.h"
+#include "Items/Weapon.h"
+#include "Pooling/ActorPoolSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Engine/DataTable.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectGlobals.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponAssetStreamingTest, "Arcorox.Items.WeaponAssets.Streaming",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FWeaponAssetStreamingTest::RunTest(const FString& Parameters)
+{
+	IConsoleVariable* StreamWeaponAssets = IConsoleManager::Get().FindConsoleVariable(TEXT("Arcorox.Items.StreamWeaponAssets"));
+	if (!TestNotNull(TEXT("Arcorox.Items.StreamWeaponAssets exists"), StreamWeaponAssets)) return false;
+	const bool bPreviousStreamWeaponAssets = StreamWeaponAssets->GetBool();
+	StreamWeaponAssets->Set(true, ECVF_SetByCode);
+
+	FArcoroxTestWorld TestWorld;
+	UWorld* World = TestWorld.Get();
+	UWeaponAssetSubsystem* WeaponAssets = UWeaponAssetSubsystem::Get(World);
+	UDataTable* WeaponTypeDataTable = UItemDataSubsystem::LoadWeaponTypeDataTable();
+	if (!TestNotNull(TEXT("Weapon asset subsystem"), WeaponAssets) || !TestNotNull(TEXT("Weapon Type Data Table"), WeaponTypeDataTable))
+	{
+		StreamWeaponAssets->Set(bPreviousStreamWeaponAssets, ECVF_SetByCode);
+		return false;
+	}
+	const EWeaponType Type = EWeaponType::EWT_SubmachineGun;
+	const FWeaponTypeTable* Row = WeaponTypeDataTable->FindRow<FWeaponTypeTable>(UItemDataSubsystem::GetWeaponTypeRowName(Type), TEXT(""));
+	if (!TestNotNull(TEXT("Weapon type row"), Row) || !TestFalse(TEXT("Row has a weapon mesh"), Row->WeaponMesh.IsNull()))
+	{
+		StreamWeaponAssets->Set(bPreviousStreamWeaponAssets, ECVF_SetByCode);
+		return false;
+	}
+
+	auto TestAssetsApplied = [this, Row](const AWeapon* Weapon, const TCHAR* Name)
+	{
+		TestTrue(FString::Printf(TEXT("%s mesh"), Name), Weapon->GetItemMesh()->GetSkeletalMeshAsset() == Row->WeaponMesh.Get());
+		TestTrue(FString::Printf(TEXT("%s fire sound"), Name), Weapon->GetFireSound() == Row->FireSound.Get());
+		TestTrue(FString::Printf(TEXT("%s muzzle flash"), Name), Weapon->GetMuzzleFlash() == Row->MuzzleFlash.Get());
+		if (!Row->MaterialInstance.IsNull())
+		{
+			const UMaterialInterface* Material = Weapon->GetItemMesh()->GetMaterial(Weapon->GetMaterialIndex());
+			TestTrue(FString::Printf(TEXT("%s glow material attached"), Name), Material && Material->IsA<UMaterialInstanceDynamic>());
+		}
+	};
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AWeapon* First = World->SpawnActor<AWeapon>(AWeapon::StaticClass(), FTransform::Identity, SpawnParams);
+	if (!TestNotNull(TEXT("First weapon spawned"), First))
+	{
+		StreamWeaponAssets->Set(bPreviousStreamWeaponAssets, ECVF_SetByCode);
+		return false;
+	}
+	TestEqual(TEXT("Requests after the first weapon"), WeaponAssets->GetNumRequests(Type), 1);
+
+	//The bundle streams in without blocking, the weapon cannot fire until it has been applied
+	TestEqual(TEXT("Fireable only with the bundle resident"), First->HasWeaponAssets(), WeaponAssets->IsResident(Type));
+	FlushAsyncLoading();
+	TestWorld.Tick();
+	TestTrue(TEXT("Bundle resident once streamed in"), WeaponAssets->IsResident(Type));
+	TestTrue(TEXT("Fireable once streamed in"), First->HasWeaponAssets());
+	TestAssetsApplied(First, TEXT("Streamed in weapon"));
+
+	//A resident bundle is applied while the second weapon is constructed
+	AWeapon* Second = World->SpawnActor<AWeapon>(AWeapon::StaticClass(), FTransform::Identity, SpawnParams);
+	if (TestNotNull(TEXT("Second weapon spawned"), Second))
+	{
+		TestEqual(TEXT("Requests after the second weapon"), WeaponAssets->GetNumRequests(Type), 2);
+		TestAssetsApplied(Second, TEXT("Second weapon"));
+
+		//Released weapons let go of their bundle and take it again, with the glow material, when re-acquired
+		UActorPoolSubsystem::ReleaseOrDestroy(Second);
+		TestEqual(TEXT("Requests after release"), WeaponAssets->GetNumRequests(Type), 1);
+		AWeapon* Reacquired = UActorPoolSubsystem::AcquireOrSpawn<AWeapon>(World, AWeapon::StaticClass());
+		if (TestNotNull(TEXT("Weapon re-acquired"), Reacquired))
+		{
+			TestEqual(TEXT("Requests after re-acquire"), WeaponAssets->GetNumRequests(Type), 2);
+			TestAssetsApplied(Reacquired, TEXT("Re-acquired weapon"));
+			Reacquired->Destroy();
+		}
+	}
+	First->Destroy();
+	TestEqual(TEXT("No requests once every weapon is gone"), WeaponAssets->GetNumRequests(Type), 0);
+	TestFalse(TEXT("Bundle released once every weapon is gone"), WeaponAssets->IsResident(Type));
+
+	StreamWeaponAssets->Set(bPreviousStreamWeaponAssets, ECVF_SetByCode);
+	return true;
+}
+
+#endif
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Combat/WeaponFireScheduler.h"
+
+namespace
+{
+	/* Rounds per minute measured by holding the trigger for Duration seconds at a fixed FrameRate */
+	float SimulateRoundsPerMinute(float Interval, float FrameRate, float Duration)
+	{
+		const double DeltaTime = 1.0 / FMath::Max(FrameRate, 1.f);
+		FWeaponFireScheduler Scheduler;
+		Scheduler.StartFiring(0.0, Interval);
+		int32 NumShots = 1;
+		double LastShotTime = 0.0;
+		for (double Time = DeltaTime; Time <= Duration; Time += DeltaTime)
+		{
+			double FirstShotTime = 0.0;
+			const int32 FrameShots = Scheduler.Advance(Time, Interval, true, MAX_int32, FirstShotTime);
+			if (FrameShots == 0) continue;
+			NumShots += FrameShots;
+			LastShotTime = FirstShotTime + (FrameShots - 1) * Interval;
+		}
+		return LastShotTime > 0.0 ? (NumShots - 1) * 60.0 / LastShotTime : 0.f;
+	}
+
+	/* The same measurement for a timer restarted after every shot, which only fires on frame boundaries */
+	float SimulateTimerRoundsPerMinute(float Interval, float FrameRate, float Duration)
+	{
+		const double DeltaTime = 1.0 / FMath::Max(FrameRate, 1.f);
+		double TimerStart = 0.0;
+		int32 NumShots = 1;
+		double LastShotTime = 0.0;
+		for (double Time = DeltaTime; Time <= Duration; Time += DeltaTime)
+		{
+			//The timer fires on the first frame past its rate and the next shot restarts it from that frame
+			if (Time - TimerStart < Interval) continue;
+			++NumShots;
+			LastShotTime = TimerStart = Time;
+		}
+		return LastShotTime > 0.0 ? (NumShots - 1) * 60.0 / LastShotTime : 0.f;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponFireRateTest, "Arcorox.Combat.FireRate",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FWeaponFireRateTest::RunTest(const FString& Parameters)
+{
+	//Holding the trigger for 10 simulated seconds must hold the weapon's rate within 1% at low, normal and high frame rates
+	const int32 RoundsPerMinutes[] = { 300, 600, 900, 1200 };
+	const float FrameRates[] = { 20.f, 60.f, 240.f };
+	for (const int32 RoundsPerMinute : RoundsPerMinutes)
+	{
+		const float Interval = 60.f / RoundsPerMinute;
+		for (const float FrameRate : FrameRates)
+		{
+			const float SchedulerRPM = SimulateRoundsPerMinute(Interval, FrameRate, 10.f);
+			TestEqual(FString::Printf(TEXT("%d RPM at %.0f fps"), RoundsPerMinute, FrameRate), SchedulerRPM, static_cast<float>(RoundsPerMinute), RoundsPerMinute * 0.01f);
+			AddInfo(FString::Printf(TEXT("%d RPM at %.0f fps: scheduler %.1f RPM, per-shot timer %.1f RPM"), RoundsPerMinute, FrameRate, SchedulerRPM,
+				SimulateTimerRoundsPerMinute(Interval, FrameRate, 10.f)));
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponFireSchedulerTest, "Arcorox.Combat.FireScheduler",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FWeaponFireSchedulerTest::RunTest(const FString& Parameters)
+{
+	const float Interval = 0.1f;
+	FWeaponFireScheduler Scheduler;
+	TestTrue(TEXT("First round fires"), Scheduler.StartFiring(1.0, Interval));
+	TestFalse(TEXT("No new burst while cycling"), Scheduler.StartFiring(1.05, Interval));
+
+	//A long frame makes every elapsed interval due, each with its own timestamp
+	double FirstShotTime = 0.0;
+	TestEqual(TEXT("Nothing due before the interval"), Scheduler.Advance(1.09, Interval, true, MAX_int32, FirstShotTime), 0);
+	TestEqual(TEXT("Rounds due after a long frame"), Scheduler.Advance(1.35, Interval, true, MAX_int32, FirstShotTime), 3);
+	TestEqual(TEXT("First due round time"), FirstShotTime, 1.1, 1e-6);
+	TestEqual(TEXT("Next round time"), Scheduler.GetNextShotTime(), 1.4, 1e-6);
+
+	//Rounds are capped, for example by the ammo left
+	TestEqual(TEXT("Capped rounds"), Scheduler.Advance(1.75, Interval, true, 2, FirstShotTime), 2);
+	TestEqual(TEXT("Next round after the cap"), Scheduler.GetNextShotTime(), 1.6, 1e-6);
+
+	//Releasing the trigger ends the burst but the last round still cycles
+	TestEqual(TEXT("Released trigger"), Scheduler.Advance(1.8, Interval, false, MAX_int32, FirstShotTime), 0);
+	TestFalse(TEXT("Not firing after release"), Scheduler.IsFiring());
+	TestTrue(TEXT("Fires again once cycled"), Scheduler.StartFiring(1.8, Interval));
+
+	Scheduler.Reset();
+	TestFalse(TEXT("Reset stops firing"), Scheduler.IsFiring());
+	TestFalse(TEXT("Reset clears cycling"), Scheduler.IsCycling(0.0));
+	return true;
+}
+
+#endif
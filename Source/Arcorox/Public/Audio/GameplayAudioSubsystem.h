@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "GameplayAudioSubsystem.generated.h"
+
+class USoundBase;
+class USoundConcurrency;
+class UAudioComponent;
+
+/* Gameplay sound categories, each with its own voice cap, retrigger interval and deduplication */
+enum class EGameplaySoundCategory : uint8
+{
+	WeaponFire,
+	Impact,
+	Explosion,
+	Pickup,
+	Equip,
+
+	MAX
+};
+
+/**
+ * Plays every gameplay sound in the world.
+ * Voices are capped per category through runtime Sound Concurrency settings, identical sounds requested in the same frame by the same owner
+ * or close together are played once, categories can enforce a minimum time between plays per owner, and automatic fire can be stitched
+ * into a looping sound kept alive by each shot.
+ */
+UCLASS(Config = Game)
+class ARCOROX_API UGameplayAudioSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Plays Sound in 2D for Owner, returns false if it was deduplicated or throttled.
+	 * 2D sounds are deduplicated and throttled per Owner, bIgnoreRetriggerInterval plays even if the category played recently for Owner.
+	 */
+	bool Play2D(USoundBase* Sound, EGameplaySoundCategory Category, const UObject* Owner, bool bIgnoreRetriggerInterval = false);
+
+	/* Plays Sound at Location, returns false if it was deduplicated or throttled */
+	bool PlayAtLocation(USoundBase* Sound, const FVector& Location, EGameplaySoundCategory Category);
+
+	/**
+	 * Starts LoopSound for Owner or keeps it playing for another KeepAliveTime seconds.
+	 * Once no shot has kept the loop alive in time it is stopped and TailSound is played.
+	 */
+	void KeepFireLoopAlive(const UObject* Owner, USoundBase* LoopSound, USoundBase* TailSound, float KeepAliveTime);
+
+	/* Stops the fire loop of Owner right away and plays its tail */
+	void StopFireLoop(const UObject* Owner);
+
+	/* Plays through the audio subsystem of WorldContextObject's world */
+	static bool PlaySound2D(const UObject* WorldContextObject, USoundBase* Sound, EGameplaySoundCategory Category, const UObject* Owner, bool bIgnoreRetriggerInterval = false);
+	static bool PlaySoundAtLocation(const UObject* WorldContextObject, USoundBase* Sound, const FVector& Location, EGameplaySoundCategory Category);
+
+private:
+	/* Looping fire sound of one shooter, the component is kept between bursts */
+	struct FFireLoop
+	{
+		TWeakObjectPtr<const UObject> Owner;
+		TWeakObjectPtr<UAudioComponent> Component;
+		TWeakObjectPtr<USoundBase> TailSound;
+		double StopTime;
+		bool bPlaying;
+	};
+
+	/* Sound played this frame, for deduplication */
+	struct FFrameSound
+	{
+		const USoundBase* Sound;
+		FVector Location;
+		FObjectKey Owner;
+	};
+
+	/* Checks deduplication and the retrigger interval of Owner, and records the play if it is allowed */
+	bool ShouldPlay(USoundBase* Sound, const FVector& Location, EGameplaySoundCategory Category, const UObject* Owner, bool bIgnoreRetriggerInterval);
+
+	/* Minimum time between two sounds of Category from one owner, 0 for no limit */
+	float GetRetriggerInterval(EGameplaySoundCategory Category) const;
+
+	/* Remembers that Sound is playing for the active voice estimate */
+	void TrackVoice(USoundBase* Sound, EGameplaySoundCategory Category);
+
+	/* Stops the loop at LoopIndex and plays its tail */
+	void StopFireLoopAt(int32 LoopIndex);
+
+	/* Drops voices that have finished and publishes the active voice counts */
+	void UpdateVoiceStats(double Now);
+
+	/* Minimum time between pickup sounds of one owner, replaces the character's PickupSoundTime */
+	UPROPERTY(Config, EditAnywhere, Category = Audio)
+	float PickupSoundInterval = 0.2f;
+
+	/* Minimum time between equip sounds of one owner, replaces the character's EquipSoundTime */
+	UPROPERTY(Config, EditAnywhere, Category = Audio)
+	float EquipSoundInterval = 0.2f;
+
+	/* Runtime concurrency settings per category */
+	UPROPERTY()
+	TArray<USoundConcurrency*> CategoryConcurrency;
+
+	/* Components of the fire loops, referenced for GC */
+	UPROPERTY()
+	TArray<UAudioComponent*> FireLoopComponents;
+
+	TArray<FFireLoop> FireLoops;
+
+	/* Sounds played this frame per category, for deduplication */
+	TArray<FFrameSound> FrameSounds[static_cast<int32>(EGameplaySoundCategory::MAX)];
+
+	/* End times of the sounds started per category, for the active voice estimate */
+	TArray<double> VoiceEndTimes[static_cast<int32>(EGameplaySoundCategory::MAX)];
+
+	/* Last time each category played a sound per owner, only for categories with a retrigger interval */
+	TMap<FObjectKey, double> LastPlayTimes[static_cast<int32>(EGameplaySoundCategory::MAX)];
+
+	/* Frame FrameSounds was recorded on */
+	uint64 SoundFrame = 0;
+};
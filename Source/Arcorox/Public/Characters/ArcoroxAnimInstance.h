@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
 #include "Items/WeaponType.h"
+#include "Characters/SmoothedValueComponent.h"
 #include "ArcoroxAnimInstance.generated.h"
 
 UENUM(BlueprintType)
@@ -18,6 +19,27 @@ enum class EOffsetState : uint8
 	EOS_MAX UMETA(DisplayName = "DefaultMAX")
 };
 
+/* Character state gathered on the game thread for the thread safe animation update */
+struct FArcoroxAnimSnapshot
+{
+	bool bValid = false;
+	FVector Velocity = FVector::ZeroVector;
+	FRotator AimRotation = FRotator::ZeroRotator;
+	FRotator ActorRotation = FRotator::ZeroRotator;
+	bool bIsFalling = false;
+	bool bIsAccelerating = false;
+	bool bCrouching = false;
+	bool bAiming = false;
+	bool bReloading = false;
+	bool bEquipping = false;
+	bool bShouldUseFABRIK = true;
+	bool bHasEquippedWeapon = false;
+	EWeaponType EquippedWeaponType = EWeaponType::EWT_SubmachineGun;
+	/* Curve values of the last evaluated pose */
+	float TurningCurve = 0.f;
+	float RotationCurve = 0.f;
+};
+
 UCLASS()
 class ARCOROX_API UArcoroxAnimInstance : public UAnimInstance
 {
@@ -27,8 +49,21 @@ public:
 	UArcoroxAnimInstance();
 	virtual void NativeInitializeAnimation() override;
 	virtual void NativeUpdateAnimation(float DeltaTime) override;
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaTime) override;
+
+	/* Spawns NumCharacters copies of the player character and logs the game thread tick time over NumFrames with the thread safe update off and then on */
+	static void BenchmarkUpdate(UWorld* World, int32 NumCharacters, int32 NumFrames);
+
+	friend class FArcoroxAnimThreadSafeUpdateTest;
+	friend class FArcoroxAnimKnownValuesTest;
 
 protected:
+	/* Copies the character state needed by the animation update, game thread only */
+	void GatherSnapshot();
+
+	/* Updates the animation properties from Snapshot, safe to run on a worker thread */
+	void UpdateFromSnapshot(float DeltaTime);
+
 	/* Handle turning in place calculations and properties */
 	void TurnInPlace();
 
@@ -124,4 +159,11 @@ private:
 	/* Character rotation last frame */
 	FRotator CharacterRotationLastFrame;
 
+	/* Eases DeltaYaw toward the character's yaw rate */
+	FSmoothedFloat LeanSmoothing;
+	FFixedStepClock LeanClock;
+
+	/* Character state of this frame, written by GatherSnapshot and read by UpdateFromSnapshot */
+	FArcoroxAnimSnapshot Snapshot;
+
 };
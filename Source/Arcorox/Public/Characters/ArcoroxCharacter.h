@@ -7,6 +7,7 @@
 #include "InputActionValue.h"
 #include "Items/AmmoType.h"
 #include "Interfaces/HitInterface.h"
+#include "Combat/WeaponFireScheduler.h"
 #include "ArcoroxCharacter.generated.h"
 
 //Forward declarations to avoid including unnecessary header files
@@ -19,6 +20,11 @@ class UAnimMontage;
 class AItem;
 class AWeapon;
 class AAmmo;
+class USmoothedValueComponent;
+class UInventoryComponent;
+class UInventoryViewModel;
+struct FHitscanResult;
+struct FBakedCrosshairSpread;
 
 UENUM(BlueprintType)
 enum class ECombatState : uint8
@@ -45,6 +51,22 @@ struct FInterpLocation
 	int32 ItemCount;
 };
 
+/* Crosshair ray and trace of the current frame, shared by every aim query */
+struct FCrosshairQueryCache
+{
+	/* Frame the ray was computed on */
+	uint64 Frame = 0;
+
+	/* Did the crosshairs deproject into the world */
+	bool bRayValid = false;
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+
+	/* Has the ray been traced this frame */
+	bool bTraced = false;
+	FHitResult Hit;
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FEquipItemDelegate, int32, CurrentSlotIndex, int32, NewSlotIndex);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHighlightIconDelegate, int32, InventorySlotIndex, bool, bStartAnimation);
 
@@ -61,7 +83,9 @@ public:
 	virtual void Hit_Implementation(FHitResult HitResult) override;
 	virtual float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, AActor* DamageCauser) override;
 
-	void IncrementOverlappedItemCount(int8 Amount);
+	/* Called by items when the character enters or leaves their overlap sphere */
+	void AddOverlappingItem(AItem* Item);
+	void RemoveOverlappingItem(AItem* Item);
 
 	void GetPickupItem(AItem* Item);
 
@@ -76,10 +100,6 @@ public:
 	/* Decrement item count of specified element of interp locations array */
 	void DecrementInterpLocationItemCount(int32 Index);
 
-	/* Start sound timers */
-	void StartPickupSoundTimer();
-	void StartEquipSoundTimer();
-
 	/* Broadcasts inventory slot info using delegate to play the highlight icon animation */
 	void HighlightInventorySlot();
 
@@ -89,21 +109,25 @@ public:
 	UFUNCTION(BlueprintCallable)
 	float GetCrosshairSpreadMultiplier() const;
 
+	/* Crosshair spread profile of the equipped weapon, or the default one when unarmed */
+	const FBakedCrosshairSpread& GetCrosshairSpreadProfile() const;
+
 	void PlayMeleeImpactSound();
 	void SpawnBloodParticles(const FTransform& SocketTransform);
 
 	FORCEINLINE USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	FORCEINLINE UCameraComponent* GetCamera() const { return Camera; }
 	FORCEINLINE bool IsAiming() const { return bAiming; }
-	FORCEINLINE int8 GetOverlappedItemCount() const { return OverlappedItemCount; }
+	FORCEINLINE int32 GetOverlappedItemCount() const { return OverlappingItems.Num(); }
 	FORCEINLINE ECombatState GetCombatState() const { return CombatState; }
 	FORCEINLINE bool IsCrouching() const { return bCrouching; }
-	FORCEINLINE bool ShouldPlayPickupSound() const { return bShouldPlayPickupSound; }
-	FORCEINLINE bool ShouldPlayEquipSound() const { return bShouldPlayEquipSound; }
 	FORCEINLINE AWeapon* GetEquippedWeapon() const { return EquippedWeapon; }
+	FORCEINLINE UInventoryComponent* GetInventoryComponent() const { return InventoryComponent; }
+	FORCEINLINE UInventoryViewModel* GetInventoryViewModel() const { return InventoryViewModel; }
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	/* Input callback functions */
 	void Move(const FInputActionValue& Value);
@@ -126,27 +150,43 @@ protected:
 	void FireWeapon();
 	void ReloadWeapon();
 
-	bool GetBeamEndLocation(const FVector& BarrelSocketLocation, FHitResult& OutHit);
 	void SendBullet();
 
+	/* Applies hit effects and damage once the hitscan subsystem has resolved a bullet */
+	void BulletResolved(const FHitscanResult& Result, float Damage, float HeadshotMultiplier);
+
 	void ExchangeInventoryItems(int32 CurrentSlotIndex, int32 TargetSlotIndex);
 
-	/* Line trace for items behind the crosshairs*/
+	/* World space start and end of a trace outward from the crosshairs, deprojected once per frame */
+	bool GetCrosshairTraceSegment(FVector& OutStart, FVector& OutEnd);
+
+	/* Line trace for items behind the crosshairs, traced once per frame */
 	bool CrosshairLineTrace(FHitResult& OutHit, FVector& OutHitLocation);
-	void CalculateCrosshairSpread(float DeltaTime);
 
-	/* Trace for Items if OverlappedItemCount > 0 */
+	/* Invalidates the crosshair query cache when a new frame has started */
+	void RefreshCrosshairQueryCache();
+
+	/* Sets the eased crosshair spread factors toward the current movement, aim and fire state */
+	void SetCrosshairSpreadTargets();
+	void CalculateCrosshairSpread();
+
+	/* Highlights the overlapping item under the crosshairs */
 	void ItemTrace();
 
-	/* Weapon fire timers */
-	void StartCrosshairShootTimer();
-	void StartAutoFireTimer();
+	/* Returns the overlapping item closest in angle to the crosshairs, tracing only to break ties and to check the item is not behind a wall */
+	AItem* FindAimedItem();
+
+	/* Fires one round whose scheduled world time is ShotTime */
+	void FireShot(double ShotTime);
+
+	/* Fires the rounds that fell due this frame for held automatic fire and frees the character once the weapon has cycled */
+	void UpdateAutoFire();
 
 	/* Spawn default weapon for character in BeginPlay */
 	AWeapon* SpawnDefaultWeapon();
 
 	/* Attach weapon to character's weapon socket */
-	void EquipWeapon(AWeapon* Weapon, bool bSwapping = false);
+	void EquipWeapon(AWeapon* Weapon);
 
 	/* Detach weapon and have it fall to ground */
 	void DropWeapon();
@@ -160,6 +200,13 @@ protected:
 	/* Initialize Ammo Map with default ammo values */
 	void InitializeAmmoMap();
 
+	/* Copy the inventory component's slots and ammo into the Blueprint-facing Inventory and AmmoMap and mark them in the view model */
+	void UpdateInventoryMirror(int32 ChangedSlot);
+	void UpdateAmmoMirror(EAmmoType AmmoType);
+
+	/* Publishes this frame's inventory changes, at most once per frame */
+	void PublishInventoryView();
+
 	/* Checks if the player's equipped weapon has ammo */
 	bool WeaponHasAmmo();
 
@@ -167,7 +214,13 @@ protected:
 	bool CarryingAmmo();
 
 	/* Interpolates Capsule half height when going between standing and crouching */
-	void InterpolateCapsuleHalfHeight(float DeltaTime);
+	void InterpolateCapsuleHalfHeight();
+
+	/* Resizes the capsule and offsets the mesh to keep it on the ground */
+	void ApplyCapsuleHalfHeight(float HalfHeight);
+
+	/* Registers the camera, capsule and crosshair values with SmoothedValues */
+	void InitializeSmoothedValues();
 
 	void Aim();
 	void StopAiming();
@@ -177,12 +230,6 @@ protected:
 
 	void InitializeInterpLocations();
 
-	UFUNCTION()
-	void AutoFireReset();
-
-	UFUNCTION()
-	void FinishedCrosshairShootTimer();
-
 	UFUNCTION(BlueprintCallable)
 	void FinishReloading();
 
@@ -257,11 +304,9 @@ private:
 	void PlayGunfireMontage();
 	void PlayReloadMontage();
 	void PlayEquipMontage();
-	void CameraZoomInterpolation(float DeltaTime);
+	void CameraZoomInterpolation();
 	void SetupEnhancedInput();
 	void SetLookScale();
-	void ResetPickupSoundTimer();
-	void ResetEquipSoundTimer();
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	USpringArmComponent* CameraBoom;
@@ -332,6 +377,16 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 	AItem* TraceHitItem;
 
+	/* Items whose overlap sphere the character is inside */
+	UPROPERTY(VisibleAnywhere, Transient, Category = Items, meta = (AllowPrivateAccess = "true"))
+	TArray<AItem*> OverlappingItems;
+
+	/* Item the last occlusion trace was made for, and whether something blocked the view of it */
+	UPROPERTY(Transient)
+	AItem* OcclusionCheckedItem;
+	bool bAimedItemOccluded;
+	double NextOcclusionCheckTime;
+
 	/* Distance outward from camera for item to interpolate to */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 	float CameraInterpDistance;
@@ -340,7 +395,7 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 	float CameraInterpElevation;
 
-	/* Map for ammo types */
+	/* Carried ammo per type, mirrored from InventoryComponent for Blueprint whenever it changes */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 	TMap<EAmmoType, int32> AmmoMap;
 
@@ -364,6 +419,17 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	USceneComponent* HandSceneComponent;
 
+	/* Eases the camera field of view, capsule half height and crosshair spread, writing components only when they change */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
+	USmoothedValueComponent* SmoothedValues;
+
+	//Handles of the values in SmoothedValues
+	int32 CameraFOVHandle = INDEX_NONE;
+	int32 CapsuleHalfHeightHandle = INDEX_NONE;
+	int32 CrosshairInAirHandle = INDEX_NONE;
+	int32 CrosshairAimHandle = INDEX_NONE;
+	int32 CrosshairShootingHandle = INDEX_NONE;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Interpolation, meta = (AllowPrivateAccess = "true"))
 	USceneComponent* WeaponInterpComp;
 
@@ -425,19 +491,19 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	float CameraZoomedFOV;
 
-	/* Time to wait between playing pickup sounds */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
-	float PickupSoundTime;
+	/* Item slots and carried ammo of the character */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
+	UInventoryComponent* InventoryComponent;
 
-	/* Time to wait between playing equip sounds */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
-	float EquipSoundTime;
+	/* Inventory changes coalesced for the HUD, pulled by UInventoryBarWidget */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
+	UInventoryViewModel* InventoryViewModel;
 
-	/* TArray of items for character inventory */
+	/* Items in the character inventory, mirrored from InventoryComponent for Blueprint whenever a slot changes */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
 	TArray<AItem*> Inventory;
 
-	/* Delegate for sending inventory slot info to Inventory Bar Widget */
+	/* Delegate for sending inventory slot info to Inventory Bar Widget, broadcast once per frame by PublishInventoryView */
 	UPROPERTY(BlueprintAssignable, Category = Delegates, meta = (AllowPrivateAccess = "true"))
 	FEquipItemDelegate EquipItemDelegate;
 
@@ -465,9 +531,6 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	UParticleSystem* BloodParticles;
 
-	/* Capacity of inventory */
-	const int32 InventoryCapacity = 6;
-
 	/* Current camera field of view this frame */
 	float CameraCurrentFOV;
 
@@ -476,20 +539,14 @@ private:
 
 	//Crosshair spread
 	float ShootTimeDuration;
-	bool bFiringWeapon;
-	FTimerHandle CrosshairShootTimer;
+	/* World time the last round stops widening the crosshair */
+	double CrosshairShootEndTime;
 
 	//Automatic Weapon Fire
 	bool bFireButtonPressed;
 	bool bShouldFire;
-	FTimerHandle AutoFireTimer;
-
-	bool bShouldTraceForItems;
-	int8 OverlappedItemCount;
+	FWeaponFireScheduler FireScheduler;
 
-	/* Sound timer properties */
-	FTimerHandle PickupSoundTimer;
-	FTimerHandle EquipSoundTimer;
-	bool bShouldPlayPickupSound;
-	bool bShouldPlayEquipSound;
+	/* Crosshair ray and trace shared by item tracing and firing within a frame */
+	FCrosshairQueryCache CrosshairQueryCache;
 };
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SmoothedValueComponent.generated.h"
+
+/**
+ * Value that eases toward a target with FInterpTo in fixed steps, so it behaves the same at any frame rate.
+ * Previous and Current are the last two steps, sampling between them hides the step boundaries.
+ */
+struct ARCOROX_API FSmoothedFloat
+{
+public:
+	/* Jumps straight to Value and settles there */
+	void Reset(float Value);
+
+	void SetTarget(float InTarget, float InSpeed);
+
+	/* Moves one fixed step toward Target, snapping once within Epsilon */
+	void Step(float FixedStep);
+
+	/* Value between the last two steps, Alpha is the fraction of a step left in the clock */
+	FORCEINLINE float Sample(float Alpha) const { return FMath::Lerp(Previous, Current, Alpha); }
+	FORCEINLINE bool IsSettled() const { return Current == Target && Previous == Target; }
+	FORCEINLINE float GetTarget() const { return Target; }
+
+	/* Difference from Target that counts as arrived */
+	float Epsilon = KINDA_SMALL_NUMBER;
+
+private:
+	float Current = 0.f;
+	float Previous = 0.f;
+	float Target = 0.f;
+	float Speed = 0.f;
+};
+
+/* Turns frame time into whole fixed steps for FSmoothedFloat */
+struct ARCOROX_API FFixedStepClock
+{
+public:
+	/* Adds DeltaTime and returns how many fixed steps to run, dropping any backlog past the step limit */
+	int32 Advance(float DeltaTime);
+
+	/* Fraction of a step left over after the last Advance */
+	float GetAlpha() const;
+
+	/* Step length from Arcorox.Smoothing.StepRate */
+	static float GetFixedStep();
+
+private:
+	float Accumulator = 0.f;
+};
+
+/**
+ * Holds the character's eased values and integrates them in one pass per frame.
+ * Each value has a writer that pushes it to its components, called only when the value moved past its epsilon,
+ * so settled values cost no component updates or transform propagation.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class ARCOROX_API USmoothedValueComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	USmoothedValueComponent();
+
+	/* Adds a value settled at InitialValue, which the owner has already applied. Writer receives it whenever it moves more than WriteEpsilon from the last written value. Returns its handle */
+	int32 AddValue(float InitialValue, float WriteEpsilon, TFunction<void(float)>&& Writer);
+
+	/* Sets the value's target and speed, waking it if it had settled */
+	void SetTarget(int32 Handle, float Target, float Speed);
+
+	/* Steps every moving value and calls the writers of those that moved */
+	void Integrate(float DeltaTime);
+
+	/* Last value handed to the writer */
+	float GetValue(int32 Handle) const;
+
+	FORCEINLINE int32 GetNumMoving() const { return NumMoving; }
+
+private:
+	struct FSmoothedEntry
+	{
+		FSmoothedFloat Value;
+		TFunction<void(float)> Writer;
+		float WrittenValue;
+		float WriteEpsilon;
+		bool bMoving;
+	};
+
+	TArray<FSmoothedEntry> Entries;
+
+	FFixedStepClock Clock;
+
+	/* Number of entries that have not settled, Integrate is free while this is zero */
+	int32 NumMoving;
+};
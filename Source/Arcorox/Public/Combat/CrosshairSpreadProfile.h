@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPtr.h"
+#include "CrosshairSpreadProfile.generated.h"
+
+class UCurveFloat;
+
+/* Per weapon tuning of the crosshair spread, the defaults are the original hard-coded values */
+USTRUCT(BlueprintType)
+struct FCrosshairSpreadProfile
+{
+	GENERATED_BODY()
+
+	/* Spread while standing still on the ground */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float BaseSpread = 0.5f;
+
+	/* Ground speed at which the velocity factor reaches VelocitySpread */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MaxVelocity = 600.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float VelocitySpread = 1.f;
+
+	/* Optional shape of the velocity factor over speed / MaxVelocity in [0, 1], linear when not set. Only loaded while baking */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSoftObjectPtr<UCurveFloat> VelocityCurve;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float InAirSpread = 2.25f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float InAirInterpSpeed = 2.25f;
+
+	/* Interp speed back to no in-air spread after landing */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float LandedInterpSpeed = 30.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AimSpread = -0.6f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AimInterpSpeed = 30.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ShootSpread = 0.4f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ShootInterpSpeed = 60.f;
+
+	/* Velocity factor computed directly from the profile, the reference for the baked table. Curve is VelocityCurve resolved once by the caller */
+	float EvaluateVelocityFactor(float Speed, const UCurveFloat* Curve) const;
+};
+
+/**
+ * FCrosshairSpreadProfile baked when the Weapon Type Data Table is loaded.
+ * The velocity factor becomes a small table sampled with one lerp, so the per-frame spread is lookups plus one sum.
+ */
+struct ARCOROX_API FBakedCrosshairSpread
+{
+public:
+	static constexpr int32 NumVelocitySamples = 17;
+
+	void Bake(const FCrosshairSpreadProfile& Profile);
+
+	/* Velocity factor for a ground speed, interpolated from the table */
+	float SampleVelocityFactor(float Speed) const;
+
+	/* Largest difference between the table and Profile over speeds up to 1.25 * MaxVelocity */
+	float MeasureMaxError(const FCrosshairSpreadProfile& Profile, int32 NumTestSpeeds = 1001) const;
+
+	/* Baked default profile, used without an equipped weapon */
+	static const FBakedCrosshairSpread& GetDefault();
+
+	float BaseSpread = 0.5f;
+	float InAirSpread = 2.25f;
+	float InAirInterpSpeed = 2.25f;
+	float LandedInterpSpeed = 30.f;
+	float AimSpread = -0.6f;
+	float AimInterpSpeed = 30.f;
+	float ShootSpread = 0.4f;
+	float ShootInterpSpeed = 60.f;
+
+private:
+	float VelocityFactors[NumVelocitySamples] = {};
+
+	/* Converts a speed to a position in VelocityFactors */
+	float SpeedToSample = 0.f;
+};
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "DamageQueueSubsystem.generated.h"
+
+class AController;
+class UDamageQueueSubsystem;
+
+/* One hit recorded during the frame */
+struct FQueuedDamage
+{
+	TWeakObjectPtr<AActor> Target;
+	TWeakObjectPtr<AController> Instigator;
+	TWeakObjectPtr<AActor> Causer;
+	FVector Location;
+	float Amount;
+	bool bHeadshot;
+	/* Should the hit show a damage number on an enemy */
+	bool bShowHitNumber;
+};
+
+/* Resolves the damage queue once per frame in TG_PostUpdateWork */
+USTRUCT()
+struct FDamageQueueTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	UDamageQueueSubsystem* Subsystem = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FDamageQueueTickFunction> : public TStructOpsTypeTraitsBase2<FDamageQueueTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Collects the hits of a frame and applies them in one batch at a fixed point of the frame.
+ * Hits on the same target from the same instigator are summed into a single TakeDamage call and a single damage number.
+ * Targets are resolved in the order they were first hit, so the outcome only depends on the order hits were queued.
+ * Arcorox.Combat.DamageQueue.Enabled 0 applies every hit immediately instead.
+ */
+UCLASS()
+class ARCOROX_API UDamageQueueSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/* Records a hit, or applies it right away when the queue is disabled */
+	void QueueDamage(const FQueuedDamage& Damage);
+
+	/* Applies and clears every queued hit */
+	void ResolveQueue();
+
+	FORCEINLINE int32 GetNumQueued() const { return Queue.Num(); }
+
+	/* Queues through the damage queue of WorldContextObject's world */
+	static void QueueDamage(const UObject* WorldContextObject, AActor* Target, float Amount, AController* Instigator, AActor* Causer, const FVector& Location, bool bHeadshot = false, bool bShowHitNumber = false);
+
+private:
+	/* Hits of one target from one instigator summed together */
+	struct FDamageGroup
+	{
+		AActor* Target;
+		AController* Instigator;
+		AActor* Causer;
+		FVector Location;
+		float Amount;
+		bool bHeadshot;
+		bool bShowHitNumber;
+	};
+
+	/* Applies the damage of a hit or group and shows its damage number */
+	static void ApplyDamage(AActor* Target, float Amount, AController* Instigator, AActor* Causer, const FVector& Location, bool bHeadshot, bool bShowHitNumber);
+
+	/* Hits of the current frame in the order they were queued */
+	TArray<FQueuedDamage> Queue;
+
+	/* Queue being resolved, hits caused by the resolution go to the next frame */
+	TArray<FQueuedDamage> ResolvingQueue;
+
+	TArray<FDamageGroup> Groups;
+	TMap<TPair<const AActor*, const AController*>, int32> GroupIndices;
+
+	FDamageQueueTickFunction TickFunction;
+};
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "HitscanSubsystem.generated.h"
+
+/* Everything needed to resolve a single hitscan shot */
+struct FHitscanShot
+{
+	/* Transform of the weapon barrel socket when the shot was fired */
+	FTransform BarrelTransform;
+
+	/* Start and end of the trace outward from the crosshairs */
+	FVector CrosshairStart = FVector::ZeroVector;
+	FVector CrosshairEnd = FVector::ZeroVector;
+
+	/* Result of the crosshair trace if the shooter already traced this frame, skips the crosshair trace stage */
+	FHitResult CrosshairHit;
+	bool bHasCrosshairHit = false;
+};
+
+/* Outcome of a hitscan shot, matches what the barrel trace of the shooter reported */
+struct FHitscanResult
+{
+	/* Barrel trace hit, Location is the beam end point even when nothing was hit */
+	FHitResult Hit;
+
+	/* Did the barrel trace hit something */
+	bool bBlockingHit = false;
+
+	/* Transform of the weapon barrel socket when the shot was fired */
+	FTransform BarrelTransform;
+};
+
+DECLARE_DELEGATE_OneParam(FOnHitscanResolved, const FHitscanResult&);
+
+/**
+ * Resolves hitscan shots for every shooter in the world.
+ * Arcorox.Hitscan.Mode 0 (default) resolves shots immediately on the game thread,
+ * 1 queues them and resolves them in batches of async traces (results arrive one to two frames later).
+ * Both modes are compared by the Arcorox.Combat.Hitscan automation test.
+ */
+UCLASS()
+class ARCOROX_API UHitscanSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/* Queues a shot, OnResolved is executed once the shot has been resolved */
+	void QueueShot(const FHitscanShot& Shot, FOnHitscanResolved OnResolved);
+
+	/* Resolves a shot synchronously: crosshair trace followed by the barrel trace toward the crosshair hit */
+	static bool ResolveShot(UWorld* World, const FHitscanShot& Shot, FHitResult& OutHit);
+
+private:
+	enum class EShotStage : uint8
+	{
+		Queued,
+		CrosshairTrace,
+		CrosshairTraceDone,
+		BarrelTrace,
+		BarrelTraceDone
+	};
+
+	struct FPendingShot
+	{
+		uint32 Id;
+		EShotStage Stage;
+		FHitscanShot Shot;
+		FOnHitscanResolved OnResolved;
+		FVector BeamEnd;
+		FHitResult BarrelHit;
+	};
+
+	/* Beam end point of a shot given the result of its crosshair trace */
+	static FVector GetBeamEndLocation(const FHitscanShot& Shot, const FHitResult& CrosshairHit);
+
+	/* End of the barrel trace, extends a bit past the beam end point */
+	static FVector GetBarrelTraceEnd(const FHitscanShot& Shot, const FVector& BeamEnd);
+
+	void RequestCrosshairTrace(FPendingShot& Pending);
+	void RequestBarrelTrace(FPendingShot& Pending);
+	void DeliverShot(FPendingShot& Pending);
+
+	void OnCrosshairTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+	void OnBarrelTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/* Shots waiting on their traces keyed by the id passed as trace user data, ids increase in the order shots were fired */
+	TMap<uint32, FPendingShot> PendingShots;
+
+	FTraceDelegate CrosshairTraceDelegate;
+	FTraceDelegate BarrelTraceDelegate;
+
+	uint32 NextShotId = 1;
+};
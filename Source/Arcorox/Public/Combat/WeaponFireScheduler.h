@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Schedules weapon rounds against world time instead of a timer per shot.
+ * Held fire accumulates whole intervals, so several rounds can fall due in one frame
+ * and each keeps its exact timestamp, holding the fire rate at any frame rate.
+ */
+struct ARCOROX_API FWeaponFireScheduler
+{
+public:
+	/* Fires the first round at Time, false while the previous round is still cycling */
+	bool StartFiring(double Time, float Interval);
+
+	/* Returns how many rounds are due by Time while the trigger is held, capped at MaxShots; OutFirstShotTime is the first of them and the rest follow every Interval */
+	int32 Advance(double Time, float Interval, bool bTriggerHeld, int32 MaxShots, double& OutFirstShotTime);
+
+	/* Ends held fire, the weapon still finishes cycling the last round */
+	void StopFiring();
+
+	/* Clears all state, used when the weapon changes */
+	void Reset();
+
+	FORCEINLINE bool IsCycling(double Time) const { return Time < NextShotTime; }
+	FORCEINLINE bool IsFiring() const { return bFiring; }
+	FORCEINLINE double GetNextShotTime() const { return NextShotTime; }
+
+private:
+	static float ClampInterval(float Interval);
+
+	/* World time the next round may fire */
+	double NextShotTime = 0.0;
+
+	/* Is the trigger holding an automatic burst */
+	bool bFiring = false;
+};
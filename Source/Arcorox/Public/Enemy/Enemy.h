@@ -14,6 +14,10 @@ class UBoxComponent;
 class AEnemyController;
 class UBehaviorTree;
 class AArcoroxCharacter;
+struct FEnemySignificanceSettings;
+enum class EEnemySignificance : uint8;
+class UEnemySignificanceSubsystem;
+class UEnemyCombatSubsystem;
 
 UCLASS()
 class ARCOROX_API AEnemy : public ACharacter, public IHitInterface
@@ -21,9 +25,8 @@ class ARCOROX_API AEnemy : public ACharacter, public IHitInterface
 	GENERATED_BODY()
 
 public:
-	AEnemy();
+	AEnemy(const FObjectInitializer& ObjectInitializer);
 
-	virtual void Tick(float DeltaTime) override;
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	virtual void Hit_Implementation(FHitResult HitResult) override;
 	virtual float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, AActor* DamageCauser) override;
@@ -31,11 +34,41 @@ public:
 	UFUNCTION(BlueprintImplementableEvent)
 	void ShowHitDamage(int32 Damage, FVector HitLocation, bool bHeadshot);
 
+	/* Shows a hit damage number through the pooled widgets of the player controller, falls back to ShowHitDamage */
+	void DisplayHitDamage(AController* InstigatorController, int32 Damage, const FVector& HitLocation, bool bHeadshot);
+
+	/* Moves the enemy into a significance bucket and applies its behavior tree and overlap rates */
+	void ApplySignificanceSettings(EEnemySignificance InSignificance, const FEnemySignificanceSettings& Settings);
+
+	/* Largest radius of the aggro and attack range spheres */
+	float GetOverlapRadius() const;
+
+	/* Adds or removes the aggro and attack range spheres from the physics scene, perception is answered by UEnemyPerceptionSubsystem while they are removed */
+	void SetPerceptionSpheresEnabled(bool bEnabled);
+
+	/* Sets the blackboard Target key */
+	void SetAggroTarget(AArcoroxCharacter* Target);
+
+	UFUNCTION(BlueprintCallable)
+	void SetInAttackRange(bool InRange);
+
+	float GetAggroRadius() const;
+	float GetAttackRadius() const;
+
+	/* Called by UEnemyCombatSubsystem when the health bar display time has run out */
+	void OnHealthBarExpired();
+
 	FORCEINLINE FString GetHeadBone() const { return HeadBone; }
 	FORCEINLINE UBehaviorTree* GetBehaviorTree() const { return BehaviorTree; }
+	FORCEINLINE UEnemySignificanceSubsystem* GetSignificanceSubsystem() const { return SignificanceSubsystem; }
+	FORCEINLINE EEnemySignificance GetSignificance() const { return Significance; }
+	FORCEINLINE AArcoroxCharacter* GetAggroTarget() const { return AggroTarget; }
+	bool IsInAttackRange() const;
+	float GetHealth() const;
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UFUNCTION(BlueprintNativeEvent)
 	void ShowHealthBar();
@@ -43,6 +76,7 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent)
 	void HideHealthBar();
 
+	/* Hands a Hit Damage widget created in Blueprint to the player controller, which positions and removes it */
 	UFUNCTION(BlueprintCallable)
 	void StoreHitDamage(UUserWidget* Widget, FVector Location);
 
@@ -64,9 +98,6 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	void DeactivateRightWeapon();
 
-	UFUNCTION()
-	void DestroyHitDamage(UUserWidget* HitDamage);
-
 	/* Called when an actor overlaps with AggroSphere */
 	UFUNCTION()
 	void AggroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
@@ -89,15 +120,9 @@ protected:
 
 	void ShowHealthBar_Implementation();
 
-	void SetInAttackRange(bool InRange);
-
 	/* Called when Health reaches 0 */
 	void Die();
 
-	void ResetHitReactTimer();
-
-	void UpdateHitDamages();
-
 private:	
 	void PlayImpactSound();
 	void SpawnImpactParticles(FHitResult& HitResult);
@@ -106,7 +131,7 @@ private:
 	void PlayHitMontage(FHitResult& HitResult, float PlayRate = 1.f);
 	void InflictDamage(AArcoroxCharacter* ArcoroxCharacter, const FName& WeaponSocket);
 
-	/* Current health of enemy */
+	/* Current health of enemy, mirrors the combat record for Blueprint */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float Health;
 
@@ -150,14 +175,6 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float MaxHitReactTime;
 
-	/* Map of Hit Damage widgets and their locations */
-	UPROPERTY(VisibleAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	TMap<UUserWidget*, FVector> HitDamages;
-
-	/* How long Hit Damage widgets will persist on screen */
-	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	float HitDamageDestroyTime;
-
 	/* Overlap sphere for Enemy to become hostile toward player */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	USphereComponent* AggroSphere;
@@ -166,16 +183,16 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	USphereComponent* AttackRangeSphere;
 
-	/* Is Enemy playing hit react animation */
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	/* Is Enemy playing hit react animation, mirrors the combat record for Blueprint, written through SetStunned */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	bool bStunned;
 
 	/* Chance of Enemy being stunned when hit (0-1) */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float StunChance;
 
-	/* Is player in attack range of Enemy */
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	/* Is player in attack range of Enemy, mirrors the combat record for Blueprint, written through SetInAttackRange */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	bool bInAttackRange;
 
 	/* Collision volume for left weapon */
@@ -213,12 +230,24 @@ private:
 	/* Pointer to Enemy AI Controller instance */
 	AEnemyController* EnemyController;
 
-	/* FTimerHandle for displaying the Health Bar */
-	FTimerHandle HealthBarDisplayTimer;
+	/* Character written to the blackboard Target key */
+	UPROPERTY(VisibleAnywhere, Transient, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	AArcoroxCharacter* AggroTarget;
+
+	/* Collision of the aggro and attack range spheres while they are used for perception */
+	TEnumAsByte<ECollisionEnabled::Type> PerceptionSphereCollision;
+
+	/* Store holding the combat record of the enemy */
+	UPROPERTY(Transient)
+	UEnemyCombatSubsystem* CombatSubsystem;
+
+	/* Slot of the combat record in CombatSubsystem, INDEX_NONE before BeginPlay */
+	int32 CombatSlot;
 
-	/* FTimerHandle for hit react delay */
-	FTimerHandle HitReactTimer;
+	/* Subsystem that buckets the enemy by significance and measures the cost of each bucket */
+	UPROPERTY(Transient)
+	UEnemySignificanceSubsystem* SignificanceSubsystem;
 
-	/* Can the Hit React montage be played */
-	bool bCanHitReact;
+	/* Significance bucket the enemy is currently in */
+	EEnemySignificance Significance;
 };
@@ -4,11 +4,31 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
 #include "EnemyAnimInstance.generated.h"
 
 class AEnemy;
 class UCharacterMovementComponent;
 
+/* Runs the enemy animation update on a worker thread, only the velocity is copied on the game thread. Speed is written before the graph updates */
+USTRUCT()
+struct FEnemyAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FEnemyAnimInstanceProxy() {}
+	FEnemyAnimInstanceProxy(UAnimInstance* InAnimInstance) : FAnimInstanceProxy(InAnimInstance) {}
+
+protected:
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+
+private:
+	/* Velocity of the enemy copied on the game thread */
+	FVector Velocity = FVector::ZeroVector;
+	bool bHasMovement = false;
+};
+
 UCLASS()
 class ARCOROX_API UEnemyAnimInstance : public UAnimInstance
 {
@@ -18,12 +38,14 @@ public:
 	UEnemyAnimInstance();
 
 	virtual void NativeInitializeAnimation() override;
-	virtual void NativeUpdateAnimation(float DeltaTime) override;
 
 protected:
-
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override;
 
 private:
+	friend struct FEnemyAnimInstanceProxy;
+
 	/* Enemy instance reference */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	AEnemy* Enemy;
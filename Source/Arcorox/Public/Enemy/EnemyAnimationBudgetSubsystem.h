@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyAnimationBudgetSubsystem.generated.h"
+
+/**
+ * Applies the enemy animation budget cvars to the Animation Budget Allocator of the world once when play begins,
+ * and again whenever one of the cvars changes.
+ */
+UCLASS()
+class ARCOROX_API UEnemyAnimationBudgetSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/* Applies Arcorox.Enemy.AnimBudgetEnabled and Arcorox.Enemy.AnimBudgetMs to the budget allocator of the world */
+	void ConfigureAnimationBudget();
+
+	void OnBudgetVariableChanged(IConsoleVariable* Variable);
+
+	FDelegateHandle EnabledChangedHandle;
+	FDelegateHandle BudgetMsChangedHandle;
+};
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "EnemyBehaviorTreeComponent.generated.h"
+
+/**
+ * Enemy behavior tree that runs at most once per throttle interval, set from the significance bucket of the possessed enemy.
+ * The base component sets its own tick interval from what the tree needs next, so the throttle defers those ticks instead of
+ * replacing the interval. Reports its tick time to the bucket of the enemy while a cost capture runs.
+ */
+UCLASS()
+class ARCOROX_API UEnemyBehaviorTreeComponent : public UBehaviorTreeComponent
+{
+	GENERATED_BODY()
+
+public:
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/* Runs the tree at most every Interval seconds, 0 runs it whenever it asks to */
+	void SetThrottleInterval(float Interval);
+
+	FORCEINLINE float GetThrottleInterval() const { return ThrottleInterval; }
+
+private:
+	/* Moves the next tick out to Delay seconds from now if the tree scheduled it sooner */
+	void DeferTick(float Delay);
+
+	float ThrottleInterval = 0.f;
+
+	/* World time the tree last ran */
+	double LastTreeTickTime = 0.0;
+
+	/* Time of the ticks skipped since the tree last ran, handed to the tree when it runs */
+	float PendingDeltaTime = 0.f;
+};
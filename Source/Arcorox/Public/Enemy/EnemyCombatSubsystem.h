@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyCombatSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+ * Combat state of every enemy in the world, stored as one contiguous array per value.
+ * Enemies hold a slot in the store and read and write their health, stun, attack range and hit react state through it.
+ * Hit react cooldowns and health bar display times are deadlines instead of a pair of timers per enemy. Cooldowns are compared when a hit
+ * arrives, and expired health bars are found in one serial pass per frame over the hide times.
+ */
+UCLASS()
+class ARCOROX_API UEnemyCombatSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/* Adds a record for Enemy with its authored health and returns its slot */
+	int32 RegisterEnemy(AEnemy* Enemy, float Health, float MaxHealth);
+	void UnregisterEnemy(int32 Slot);
+
+	/* Subtracts DamageAmount from the health of Slot, clamped at 0, and returns the new health */
+	float ApplyDamage(int32 Slot, float DamageAmount);
+
+	/* Starts the hit react cooldown of Slot if it is not cooling down, returns false while it is */
+	bool TryStartHitReact(int32 Slot, float Cooldown);
+
+	/* Keeps the health bar of Slot on screen for Duration seconds from now */
+	void ShowHealthBar(int32 Slot, float Duration);
+	void ClearHealthBar(int32 Slot);
+
+	void SetStunned(int32 Slot, bool bStunned);
+	void SetInAttackRange(int32 Slot, bool bInAttackRange);
+
+	FORCEINLINE float GetHealth(int32 Slot) const { return Health[Slot]; }
+	FORCEINLINE float GetMaxHealth(int32 Slot) const { return MaxHealth[Slot]; }
+	FORCEINLINE bool IsStunned(int32 Slot) const { return Stunned[Slot] != 0; }
+	FORCEINLINE bool IsInAttackRange(int32 Slot) const { return InAttackRange[Slot] != 0; }
+	bool CanHitReact(int32 Slot) const;
+
+private:
+	/* Owner of each slot, nullptr for free slots */
+	UPROPERTY()
+	TArray<AEnemy*> Owners;
+
+	TArray<float> Health;
+	TArray<float> MaxHealth;
+	TArray<uint8> Stunned;
+	TArray<uint8> InAttackRange;
+
+	/* World time the hit react cooldown of each slot ends */
+	TArray<double> HitReactReadyTime;
+
+	/* World time the health bar of each slot hides, 0 when not shown */
+	TArray<double> HealthBarHideTime;
+
+	/* Slots released by unregistered enemies */
+	TArray<int32> FreeSlots;
+
+	int32 NumRecords = 0;
+	int32 NumHealthBarsShown = 0;
+};
@@ -4,11 +4,22 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
 #include "EnemyController.generated.h"
 
 class UBlackboardComponent;
 class UBehaviorTreeComponent;
 
+/* Blackboard key IDs used by enemies, resolved once when the blackboard is initialized */
+struct FEnemyBlackboardKeys
+{
+	FBlackboard::FKey Target = FBlackboard::InvalidKey;
+	FBlackboard::FKey InAttackRange = FBlackboard::InvalidKey;
+	FBlackboard::FKey Stunned = FBlackboard::InvalidKey;
+	FBlackboard::FKey PatrolPoint = FBlackboard::InvalidKey;
+	FBlackboard::FKey PatrolPoint2 = FBlackboard::InvalidKey;
+};
+
 UCLASS()
 class ARCOROX_API AEnemyController : public AAIController
 {
@@ -19,13 +30,27 @@ public:
 
 	virtual void OnPossess(APawn* InPawn) override;
 
+	/* Typed blackboard setters, writes are skipped when the key is missing or already holds the value */
+	void SetTargetKey(UObject* Target);
+	void SetInAttackRangeKey(bool bInAttackRange);
+	void SetStunnedKey(bool bStunned);
+	void SetPatrolPointKeys(const FVector& PatrolPoint, const FVector& PatrolPoint2);
+
+	/* Resolves the key IDs of the blackboard asset in use */
+	void ResolveBlackboardKeys();
+
 	FORCEINLINE UBlackboardComponent* GetBlackboardComponent() const { return BlackboardComponent; }
 	FORCEINLINE UBehaviorTreeComponent* GetBehaviorTreeComponent() const { return BehaviorTreeComponent; }
+	FORCEINLINE const FEnemyBlackboardKeys& GetBlackboardKeys() const { return BlackboardKeys; }
 
 protected:
 
 
 private:
+	/* Writes Value to Key if it differs from the current value, returns whether it was written */
+	template<typename TDataClass>
+	bool SetBlackboardValue(FBlackboard::FKey Key, typename TDataClass::FDataType Value);
+
 	/* Enemy AI Blackboard component */
 	UPROPERTY(BlueprintReadWrite, Category = "AI Behavior", meta = (AllowPrivateAccess = "true"))
 	UBlackboardComponent* BlackboardComponent;
@@ -34,4 +59,6 @@ private:
 	UPROPERTY(BlueprintReadWrite, Category = "AI Behavior", meta = (AllowPrivateAccess = "true"))
 	UBehaviorTreeComponent* BehaviorTreeComponent;
 
+	FEnemyBlackboardKeys BlackboardKeys;
+
 };
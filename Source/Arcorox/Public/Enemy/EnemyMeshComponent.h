@@ -0,0 +1,17 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "EnemyMeshComponent.generated.h"
+
+/* Budgeted enemy mesh that reports its tick time to the significance bucket of its enemy while a cost capture runs */
+UCLASS()
+class ARCOROX_API UEnemyMeshComponent : public USkeletalMeshComponentBudgeted
+{
+	GENERATED_BODY()
+
+public:
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+};
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyPerceptionSubsystem.generated.h"
+
+class AEnemy;
+class AArcoroxCharacter;
+
+/**
+ * Answers which player characters are within the aggro and attack range of every enemy in one batch per frame.
+ * Player capsules are put into a uniform spatial hash once per frame, and the Target and InAttackRange
+ * blackboard keys of an enemy are only written when they change. Enemies then keep their aggro and attack spheres
+ * out of the physics scene. Arcorox.Enemy.Perception.UseSpatialHash 0 switches back to the overlap spheres.
+ */
+UCLASS()
+class ARCOROX_API UEnemyPerceptionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	/* Is perception answered by the spatial hash rather than the overlap spheres */
+	bool IsUsingSpatialHash() const { return bUsingSpatialHash; }
+
+	/* Distance from Location to the surface of a capsule, 0 inside it. Matches when a sphere at Location starts overlapping the capsule */
+	static float GetDistanceToCapsule(const FVector& Location, const FVector& CapsuleCenter, float CapsuleRadius, float CapsuleHalfHeight);
+
+private:
+	/* Target capsule in the spatial hash, Index points into Targets */
+	struct FHashEntry
+	{
+		FVector Location;
+		float Radius;
+		float HalfHeight;
+		int32 Index;
+	};
+
+	/* Rebuilds the spatial hash from the current player capsules */
+	void BuildHash();
+
+	/* Updates the blackboard keys of every enemy from the spatial hash */
+	void UpdatePerception();
+
+	/* Switches every enemy between the spatial hash and its overlap spheres */
+	void SetUsingSpatialHash(bool bUseSpatialHash);
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/* Registered enemies */
+	UPROPERTY()
+	TArray<AEnemy*> Enemies;
+
+	/* Player characters this frame */
+	UPROPERTY()
+	TArray<AArcoroxCharacter*> Targets;
+
+	/* Entries of each occupied cell */
+	TMap<FIntPoint, TArray<FHashEntry, TInlineAllocator<4>>> Cells;
+
+	/* Cell size the hash was built with */
+	float CellSize = 1000.f;
+
+	/* Largest capsule radius in the hash, widens the cells searched around an enemy */
+	float MaxTargetRadius = 0.f;
+
+	bool bUsingSpatialHash = false;
+};
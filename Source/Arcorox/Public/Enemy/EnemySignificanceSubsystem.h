@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemySignificanceSubsystem.generated.h"
+
+class AEnemy;
+
+/* How much an enemy matters to the player right now, from most to least significant */
+enum class EEnemySignificance : uint8
+{
+	/* Close enough to fight the player, whether in view or not */
+	Near,
+	/* In front of the camera */
+	Visible,
+	/* In front of the camera but far away */
+	Distant,
+	/* Behind the camera and not near */
+	Hidden,
+
+	MAX
+};
+
+/* Per-enemy work whose rate is scaled by significance, timed separately during a cost capture */
+enum class EEnemyWork : uint8
+{
+	/* Skeletal mesh tick on the game thread, its rate is set by the animation budget allocator */
+	Animation,
+	/* Behavior tree component tick */
+	BehaviorTree,
+
+	MAX
+};
+
+/* Update rates used for the enemies of one significance bucket */
+struct FEnemySignificanceSettings
+{
+	/* Shortest time between two behavior tree updates, 0 updates whenever the tree asks to */
+	float BehaviorTreeTickInterval;
+	/* Should the aggro and attack range spheres generate overlap events */
+	bool bOverlapsEnabled;
+};
+
+/**
+ * Buckets every enemy in the world by distance and direction to the player camera, and scales the enemy's behavior tree
+ * and overlap activity to its bucket. Enemies only have their settings changed when their bucket changes.
+ * Mesh tick rates belong to the animation budget allocator, the bucket only reports their measured cost.
+ */
+UCLASS()
+class ARCOROX_API UEnemySignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	/* Times the work of every bucket for Seconds of play, then logs it with DumpBuckets */
+	void BeginCostCapture(float Seconds);
+
+	/* Logs the number of enemies of each bucket and the update rate and game thread cost measured by the last cost capture */
+	void DumpBuckets() const;
+
+	FORCEINLINE bool IsCapturingCost() const { return bCapturingCost; }
+
+	/* Adds the time of one update of Work to the cost of a bucket, called through FScopedEnemyWorkTimer */
+	void AddWorkTime(EEnemySignificance Significance, EEnemyWork Work, double Seconds);
+
+	static const FEnemySignificanceSettings& GetSettings(EEnemySignificance Significance);
+	static const TCHAR* GetSignificanceName(EEnemySignificance Significance);
+
+private:
+	/* Buckets Enemy from the camera location and direction */
+	EEnemySignificance CalculateSignificance(const AEnemy* Enemy, const FVector& CameraLocation, const FVector& CameraDirection) const;
+
+	/* Registered enemies */
+	UPROPERTY()
+	TArray<AEnemy*> Enemies;
+
+	/* Bucket of each enemy, parallel to Enemies */
+	TArray<EEnemySignificance> Significances;
+
+	/* Time spent bucketing in the last tick */
+	double LastBucketingSeconds = 0.0;
+
+	/* Cost capture */
+	bool bCapturingCost = false;
+	double CaptureStartTime = 0.0;
+	double CaptureEndTime = 0.0;
+	double CaptureSeconds = 0.0;
+	int32 CaptureFrames = 0;
+
+	/* Measured time and number of updates of each work per bucket over the last capture */
+	double WorkSeconds[static_cast<int32>(EEnemySignificance::MAX)][static_cast<int32>(EEnemyWork::MAX)] = {};
+	int32 WorkUpdates[static_cast<int32>(EEnemySignificance::MAX)][static_cast<int32>(EEnemyWork::MAX)] = {};
+};
+
+/* Adds the time of its scope to the significance bucket of an enemy while its significance subsystem captures cost */
+class ARCOROX_API FScopedEnemyWorkTimer
+{
+public:
+	FScopedEnemyWorkTimer(const AEnemy* Enemy, EEnemyWork InWork);
+	~FScopedEnemyWorkTimer();
+
+private:
+	UEnemySignificanceSubsystem* Subsystem;
+	EEnemySignificance Significance;
+	EEnemyWork Work;
+	double StartTime;
+};
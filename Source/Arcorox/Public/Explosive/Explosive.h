@@ -5,12 +5,13 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Interfaces/HitInterface.h"
+#include "Interfaces/PoolableInterface.h"
 #include "Explosive.generated.h"
 
 class UParticleSystem;
 
 UCLASS()
-class ARCOROX_API AExplosive : public AActor, public IHitInterface
+class ARCOROX_API AExplosive : public AActor, public IHitInterface, public IPoolableInterface
 {
 	GENERATED_BODY()
 	
@@ -19,6 +20,8 @@ public:
 
 	virtual void Tick(float DeltaTime) override;
 	virtual void Hit_Implementation(FHitResult HitResult) override;
+	virtual void OnAcquiredFromPool() override;
+	virtual void OnReleasedToPool() override;
 
 protected:
 	virtual void BeginPlay() override;
@@ -27,6 +30,9 @@ private:
 	void SpawnExplosionParticles(FHitResult& HitResult);
 	void PlayExplosionSound();
 
+	/* Has the explosive gone off, further hits are ignored until it is acquired from the pool again */
+	bool bExploded;
+
 	/* Particles for explosion */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	UParticleSystem* ExplosionParticles;
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FXSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+/* How an effect is treated by the spawn budget */
+enum class EFXPriority : uint8
+{
+	/* Always spawned (muzzle flashes, explosions) */
+	Critical,
+	/* Subject to the per-frame and distance budgets and coalesced with nearby spawns of the same template (impacts, blood, beams) */
+	Budgeted
+};
+
+/**
+ * Spawns every gameplay particle effect in the world.
+ * Components come from the engine's world particle pool (EPSCPoolMethod::AutoRelease), budgeted effects are limited per frame
+ * and by distance from the camera, and budgeted spawns of the same template close to each other within a frame share one emitter.
+ */
+UCLASS()
+class ARCOROX_API UFXSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/* Spawns Template at Transform, returns nullptr if the effect was culled, or the emitter it was coalesced into. The component goes back to the pool when it finishes, do not keep it past this frame */
+	UParticleSystemComponent* SpawnEmitter(UParticleSystem* Template, const FTransform& Transform, EFXPriority Priority, bool bAllowCoalesce = true);
+
+	/* Spawns through the FX subsystem of WorldContextObject's world */
+	static UParticleSystemComponent* SpawnEmitterAtLocation(const UObject* WorldContextObject, UParticleSystem* Template, const FTransform& Transform, EFXPriority Priority, bool bAllowCoalesce = true);
+	static UParticleSystemComponent* SpawnEmitterAtLocation(const UObject* WorldContextObject, UParticleSystem* Template, const FVector& Location, EFXPriority Priority, bool bAllowCoalesce = true);
+
+private:
+	/* Budgeted spawn this frame, for coalescing */
+	struct FFrameSpawn
+	{
+		const UParticleSystem* Template;
+		FVector Location;
+		UParticleSystemComponent* Component;
+	};
+
+	/* Resets the per-frame budget and camera location when a new frame has started */
+	void BeginFrameIfNeeded();
+
+	/* Budgeted spawns of the current frame */
+	TArray<FFrameSpawn> FrameSpawns;
+
+	/* Frame the budget was last reset on */
+	uint64 BudgetFrame = 0;
+
+	/* Number of budgeted effects spawned this frame */
+	int32 NumBudgetedSpawns = 0;
+
+	/* Camera location of the first local player this frame */
+	FVector CameraLocation = FVector::ZeroVector;
+	bool bHasCameraLocation = false;
+};
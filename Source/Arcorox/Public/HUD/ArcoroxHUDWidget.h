@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "HUD/HUDDataComponent.h"
+#include "ArcoroxHUDWidget.generated.h"
+
+/**
+ * Base class for the HUD overlay. Pulls the owning controller's HUD data model each tick and calls
+ * OnHUDSnapshotChanged only when a new version was published, so the Blueprint sets its text and
+ * crosshair once per change instead of polling property bindings every frame.
+ */
+UCLASS()
+class ARCOROX_API UArcoroxHUDWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/* Called with each new snapshot version, ChangedFields says which values to refresh */
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnHUDSnapshotChanged(const FHUDSnapshot& Snapshot);
+
+	/* Data model to pull from, defaults to the owning player's */
+	void SetDataSource(UHUDDataComponent* InDataSource);
+
+	/* Hands the current snapshot to OnHUDSnapshotChanged if its version is new or bForce is set, returns true if it did */
+	bool PullSnapshot(bool bForce = false);
+
+	/**
+	 * Adds NumWidgets widgets of WidgetClass to the viewport and times NumFrames Slate ticks, which tick, prepass and paint them.
+	 * A UArcoroxHUDWidget class is run twice, refreshed every frame and refreshed on change, any other class runs once with its own bindings.
+	 */
+	static void BenchmarkUpdates(UWorld* World, TSubclassOf<UUserWidget> WidgetClass, int32 NumWidgets, int32 NumFrames);
+
+protected:
+	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+
+private:
+	UPROPERTY(Transient)
+	UHUDDataComponent* DataSource;
+
+	/* Version last handed to OnHUDSnapshotChanged */
+	int32 SeenVersion = 0;
+};
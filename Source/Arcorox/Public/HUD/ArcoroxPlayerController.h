@@ -6,6 +6,9 @@
 #include "GameFramework/PlayerController.h"
 #include "ArcoroxPlayerController.generated.h"
 
+class UHitDamageComponent;
+class UHUDDataComponent;
+
 UCLASS()
 class ARCOROX_API AArcoroxPlayerController : public APlayerController
 {
@@ -14,10 +17,19 @@ class ARCOROX_API AArcoroxPlayerController : public APlayerController
 public:
 	AArcoroxPlayerController();
 
+	FORCEINLINE UHitDamageComponent* GetHitDamageComponent() const { return HitDamageComponent; }
+	FORCEINLINE UHUDDataComponent* GetHUDDataComponent() const { return HUDDataComponent; }
+	FORCEINLINE TSubclassOf<UUserWidget> GetHUDOverlayClass() const { return HUDOverlayClass; }
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
+	/* Forwards HUD snapshots to an overlay that is not a UArcoroxHUDWidget through its own OnHUDSnapshotChanged function, if it has one */
+	void BindOverlaySnapshotFallback();
+	void ForwardSnapshotToOverlay(const FHUDSnapshot& Snapshot);
+
 	/* HUD Overlay Widget Blueprint class */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Widgets, meta = (AllowPrivateAccess = "true"))
 	TSubclassOf<UUserWidget> HUDOverlayClass;
@@ -25,4 +37,18 @@ private:
 	/* HUD Overlay Widget object pointer */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Widgets, meta = (AllowPrivateAccess = "true"))
 	UUserWidget* HUDOverlay;
+
+	/* Pooled floating hit damage numbers */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Widgets, meta = (AllowPrivateAccess = "true"))
+	UHitDamageComponent* HitDamageComponent;
+
+	/* Versioned snapshots of the values shown by the HUD Overlay */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Widgets, meta = (AllowPrivateAccess = "true"))
+	UHUDDataComponent* HUDDataComponent;
+
+	/* OnHUDSnapshotChanged of an overlay that was not reparented to UArcoroxHUDWidget */
+	UPROPERTY(Transient)
+	UFunction* OverlaySnapshotFunction;
+
+	FDelegateHandle OverlaySnapshotHandle;
 };
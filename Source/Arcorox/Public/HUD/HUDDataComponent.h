@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Characters/ArcoroxCharacter.h"
+#include "HUDDataComponent.generated.h"
+
+/* Bits of FHUDSnapshot::ChangedFields */
+UENUM(BlueprintType)
+enum class EHUDField : uint8
+{
+	EHF_MagazineAmmo UMETA(DisplayName = "Magazine Ammo"),
+	EHF_CarriedAmmo UMETA(DisplayName = "Carried Ammo"),
+	EHF_CrosshairSpread UMETA(DisplayName = "Crosshair Spread"),
+	EHF_CombatState UMETA(DisplayName = "Combat State"),
+
+	EHF_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/* Values the HUD overlay displays, published as a new version only when one of them changes */
+USTRUCT(BlueprintType)
+struct FHUDSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = HUD)
+	int32 Version = 0;
+
+	/* Bit per EHUDField that changed since the previous version */
+	UPROPERTY(BlueprintReadOnly, Category = HUD)
+	int32 ChangedFields = 0;
+
+	/* Ammo in the equipped weapon's magazine */
+	UPROPERTY(BlueprintReadOnly, Category = HUD)
+	int32 MagazineAmmo = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = HUD)
+	EAmmoType EquippedAmmoType = EAmmoType::EAT_MAX;
+
+	/* Carried ammo indexed by EAmmoType */
+	UPROPERTY(BlueprintReadOnly, Category = HUD)
+	TArray<int32> CarriedAmmo;
+
+	UPROPERTY(BlueprintReadOnly, Category = HUD)
+	float CrosshairSpread = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = HUD)
+	ECombatState CombatState = ECombatState::ECS_Unoccupied;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnHUDSnapshotPublished, const FHUDSnapshot&);
+
+/**
+ * HUD data model of a player controller. Samples the controlled character once per frame after it has ticked
+ * and publishes a versioned FHUDSnapshot only when a displayed value changed, so HUD widgets can drop their
+ * per-frame property bindings and stay invalidated until the next version.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class ARCOROX_API UHUDDataComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UHUDDataComponent();
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/* Compares Character against the published snapshot and publishes a new version if anything changed, returns true if it did */
+	bool UpdateFromCharacter(const AArcoroxCharacter* Character);
+
+	/* Publishes Snapshot as the next version if it differs from the current one, used by the benchmark and by UpdateFromCharacter */
+	bool Publish(const FHUDSnapshot& Snapshot);
+
+	UFUNCTION(BlueprintPure, Category = HUD)
+	FHUDSnapshot GetHUDSnapshot() const { return Snapshot; }
+
+	UFUNCTION(BlueprintPure, Category = HUD)
+	static bool HasFieldChanged(const FHUDSnapshot& InSnapshot, EHUDField Field);
+
+	FORCEINLINE const FHUDSnapshot& GetSnapshot() const { return Snapshot; }
+	FORCEINLINE int32 GetVersion() const { return Snapshot.Version; }
+
+	/* Broadcast with every new version, for HUD overlays that are not a UArcoroxHUDWidget */
+	FOnHUDSnapshotPublished OnSnapshotPublished;
+
+private:
+	/* Last published snapshot */
+	FHUDSnapshot Snapshot;
+
+	/* Scratch snapshot filled each frame, kept to reuse its CarriedAmmo allocation */
+	FHUDSnapshot Sampled;
+};
@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "HUD/ScreenProjection.h"
+#include "HitDamageComponent.generated.h"
+
+class UUserWidget;
+class UHitDamageWidget;
+class APlayerController;
+
+/**
+ * Displays floating hit damage numbers for the owning player controller.
+ * Widgets are recycled from a pool and live numbers are kept in a ring buffer with expiry times, so hits do not allocate widgets or timers.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class ARCOROX_API UHitDamageComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UHitDamageComponent();
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/* Shows a pooled hit damage number at HitLocation, returns false if there is no HitDamageWidgetClass */
+	bool ShowHitDamage(int32 Damage, const FVector& HitLocation, bool bHeadshot);
+
+	/* Positions an externally created widget at Location until it expires, then removes it from its parent */
+	void TrackHitDamageWidget(UUserWidget* Widget, const FVector& Location);
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	/* Live hit damage number */
+	struct FActiveHitDamage
+	{
+		UUserWidget* Widget;
+		double ExpireTime;
+		bool bPooled;
+	};
+
+	/* Adds a live number to the ring buffer, retiring the oldest number if the buffer is full */
+	void AddActiveHitDamage(UUserWidget* Widget, const FVector& Location, bool bPooled);
+
+	/* Returns the widget to the pool or removes it from its parent */
+	void RetireHitDamage(const FActiveHitDamage& HitDamage);
+
+	/* Takes a widget from the pool, creating one if the pool is empty */
+	UUserWidget* AcquireWidget();
+
+	/* Passes the hit to the widget, through SetHitDamage or the variables of widgets not reparented to UHitDamageWidget */
+	void SetWidgetHitDamage(UUserWidget* Widget, int32 Damage, bool bHeadshot);
+
+	/* Finds the HitDamage, Headshot and HitDamageAnimation variables of WidgetClass */
+	void CacheWidgetVariables(UClass* WidgetClass);
+
+	/* Moves live numbers to their projected screen positions */
+	void UpdateScreenPositions();
+
+	APlayerController* GetOwningPlayerController() const;
+
+	/* Widget Blueprint class for hit damage numbers, defaults to WBP_HitDamage */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Widgets, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<UUserWidget> HitDamageWidgetClass;
+
+	/* How long hit damage numbers persist on screen */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Widgets, meta = (AllowPrivateAccess = "true"))
+	float HitDamageLifetime;
+
+	/* Maximum number of hit damage numbers on screen at once */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Widgets, meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxActiveHitDamages;
+
+	/* Every widget created by the pool, keeps them referenced while free */
+	UPROPERTY(Transient)
+	TArray<UUserWidget*> PooledWidgets;
+
+	/* Widgets ready for reuse */
+	UPROPERTY(Transient)
+	TArray<UUserWidget*> FreeWidgets;
+
+	/* Externally created widgets currently tracked in the ring buffer */
+	UPROPERTY(Transient)
+	TArray<UUserWidget*> TrackedWidgets;
+
+	/* Ring buffer of live numbers, ordered by expiry time since every number has the same lifetime */
+	TArray<FActiveHitDamage> ActiveHitDamages;
+
+	/* World locations of the live numbers, parallel to ActiveHitDamages so they can be projected in contiguous runs */
+	TArray<FVector> ActiveLocations;
+
+	/* Projected screen positions of ActiveLocations */
+	TArray<FVector2D> ScreenPositions;
+	TArray<bool> OnScreen;
+
+	/* View-projection of the owning player, captured once per frame */
+	FScreenProjection ScreenProjection;
+
+	/* Class the widget variables below were found on */
+	TWeakObjectPtr<UClass> WidgetVariablesClass;
+	FNumericProperty* HitDamageProperty;
+	FBoolProperty* HeadshotProperty;
+	FObjectProperty* HitDamageAnimationProperty;
+
+	/* Index of the oldest live number in ActiveHitDamages */
+	int32 ActiveHead;
+
+	/* Number of live numbers in ActiveHitDamages */
+	int32 NumActive;
+};
@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "HitDamageWidget.generated.h"
+
+/**
+ * Base class for floating hit damage numbers. Instances are pooled by UHitDamageComponent and reused for every hit.
+ */
+UCLASS()
+class ARCOROX_API UHitDamageWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/* Called each time the widget is taken from the pool to display a new hit */
+	UFUNCTION(BlueprintImplementableEvent)
+	void SetHitDamage(int32 Damage, bool bHeadshot);
+};
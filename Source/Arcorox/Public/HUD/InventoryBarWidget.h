@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "HUD/InventoryViewModel.h"
+#include "InventoryBarWidget.generated.h"
+
+/**
+ * Base class for the inventory bar. Pulls the owning character's inventory view model each tick
+ * and calls OnInventoryUpdated only when a new version has been published.
+ */
+UCLASS()
+class ARCOROX_API UInventoryBarWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/* Called at most once per frame with the state of the new version */
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnInventoryUpdated(const FInventoryViewState& State);
+
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	static bool IsSlotChanged(const FInventoryViewState& State, int32 Slot);
+
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	static bool IsAmmoChanged(const FInventoryViewState& State, EAmmoType AmmoType);
+
+protected:
+	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+
+private:
+	/* Finds the view model of the owning player's character */
+	UInventoryViewModel* FindViewModel() const;
+
+	UPROPERTY(Transient)
+	UInventoryViewModel* ViewModel;
+
+	/* Version last handed to OnInventoryUpdated */
+	int32 SeenVersion = 0;
+};
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Items/AmmoType.h"
+#include "InventoryViewModel.generated.h"
+
+class AArcoroxCharacter;
+
+/* Inventory state the HUD shows, published at most once per frame */
+USTRUCT(BlueprintType)
+struct FInventoryViewState
+{
+	GENERATED_BODY()
+
+	/* Incremented every time a changed state is published */
+	UPROPERTY(BlueprintReadOnly, Category = Inventory)
+	int32 Version = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = Inventory)
+	int32 EquippedSlot = INDEX_NONE;
+
+	/* Equipped slot of the previous version, for the equip animation */
+	UPROPERTY(BlueprintReadOnly, Category = Inventory)
+	int32 PreviousEquippedSlot = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category = Inventory)
+	int32 HighlightedSlot = INDEX_NONE;
+
+	/* Highlighted slot of the previous version, whose animation should stop */
+	UPROPERTY(BlueprintReadOnly, Category = Inventory)
+	int32 PreviousHighlightedSlot = INDEX_NONE;
+
+	/* Bit i is set if the item in slot i changed since the previous version */
+	UPROPERTY(BlueprintReadOnly, Category = Inventory)
+	int32 ChangedSlotMask = 0;
+
+	/* Bit i is set if the carried ammo of EAmmoType i changed since the previous version */
+	UPROPERTY(BlueprintReadOnly, Category = Inventory)
+	int32 ChangedAmmoMask = 0;
+};
+
+/**
+ * Collects inventory slot, equip, highlight and ammo changes as dirty flags and publishes them once per frame.
+ * Widgets pull the published state by version instead of receiving a broadcast per event, so a crosshair sweeping
+ * over loot that toggles the highlight many times in a frame costs one update, or none if it ends where it started.
+ */
+UCLASS(BlueprintType)
+class ARCOROX_API UInventoryViewModel : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	void MarkSlotChanged(int32 Slot);
+	void MarkAmmoChanged(EAmmoType AmmoType);
+	void SetEquippedSlot(int32 Slot);
+	void SetHighlightedSlot(int32 Slot);
+
+	/* Publishes the pending changes as a new version, returns false if nothing changed since the last one */
+	bool Flush();
+
+	/* Last published state */
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	FInventoryViewState GetInventoryState() const { return State; }
+
+	FORCEINLINE const FInventoryViewState& GetState() const { return State; }
+
+	FORCEINLINE int32 GetVersion() const { return State.Version; }
+	FORCEINLINE int32 GetPendingHighlightedSlot() const { return PendingHighlightedSlot; }
+
+private:
+	/* Counts an event as coalesced if it lands in a frame that already has one pending */
+	void NoteEvent();
+
+	FInventoryViewState State;
+
+	int32 PendingEquippedSlot = INDEX_NONE;
+	int32 PendingHighlightedSlot = INDEX_NONE;
+	int32 PendingSlotMask = 0;
+	int32 PendingAmmoMask = 0;
+
+	/* Events recorded since the last Flush */
+	int32 NumPendingEvents = 0;
+};
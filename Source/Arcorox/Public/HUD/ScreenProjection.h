@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class APlayerController;
+struct FSceneViewProjectionData;
+
+/**
+ * View-projection of a local player captured once, for projecting many world locations to the screen in one pass.
+ * Gives the same results as UGameplayStatics::ProjectWorldToScreen without rebuilding the view-projection matrix per point.
+ */
+struct ARCOROX_API FScreenProjection
+{
+public:
+	/* Captures the view-projection of PlayerController's local player, returns false if it has no viewport */
+	bool Capture(const APlayerController* PlayerController);
+
+	/* Captures the view-projection and view rect of ProjectionData */
+	void Capture(const FSceneViewProjectionData& ProjectionData);
+
+	/* Captures again only if the projection was not captured this frame */
+	bool CaptureForFrame(const APlayerController* PlayerController);
+
+	/* Projects one world location to viewport space, returns false if it is behind the camera */
+	bool Project(const FVector& WorldLocation, FVector2D& OutScreenPosition) const;
+
+	/* Projects WorldLocations to viewport space, OutScreenPositions and OutOnScreen must be the same size as WorldLocations */
+	void ProjectPoints(TArrayView<const FVector> WorldLocations, TArrayView<FVector2D> OutScreenPositions, TArrayView<bool> OutOnScreen) const;
+
+	FORCEINLINE bool IsValid() const { return bValid; }
+
+private:
+	/* Columns of the view-projection matrix producing clip space X, Y and W, the only ones needed for screen positions */
+	FVector4 ClipX;
+	FVector4 ClipY;
+	FVector4 ClipW;
+
+	/* Constrained view rect of the player */
+	FVector2D ViewMin;
+	FVector2D ViewSize;
+
+	uint64 CaptureFrame = 0;
+	bool bValid = false;
+};
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "PoolableInterface.generated.h"
+
+UINTERFACE(MinimalAPI)
+class UPoolableInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Actors implementing this interface are recycled by UActorPoolSubsystem instead of being destroyed.
+ */
+class ARCOROX_API IPoolableInterface
+{
+	GENERATED_BODY()
+
+public:
+	/* Called after the actor has been taken from the pool, shown and moved to its spawn transform */
+	virtual void OnAcquiredFromPool() {}
+
+	/* Called before the actor is hidden, has its collision disabled and goes back into the pool */
+	virtual void OnReleasedToPool() {}
+};
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Items/AmmoType.h"
+#include "InventoryComponent.generated.h"
+
+class AItem;
+
+/**
+ * Item slots and carried ammo for any character, player or AI.
+ * Slots are a fixed array sized by Capacity with a bitmask of the free ones, and ammo counts are a flat array indexed by EAmmoType.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class ARCOROX_API UInventoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UInventoryComponent();
+	virtual void InitializeComponent() override;
+
+	/* Most slots an inventory can have, one bit each in FreeSlotMask */
+	static constexpr int32 MaxCapacity = 32;
+
+	/* Resizes the inventory to NewCapacity empty slots */
+	void SetCapacity(int32 NewCapacity);
+
+	/* Puts Item in the lowest free slot and returns it, INDEX_NONE if the inventory is full */
+	int32 AddItem(AItem* Item);
+
+	/* Puts Item in Slot, replacing whatever was there, and returns the replaced item */
+	AItem* SetItemAt(int32 Slot, AItem* Item);
+
+	/* Empties Slot and returns the item that was in it */
+	AItem* RemoveItemAt(int32 Slot);
+
+	/* Empties every slot */
+	void ClearItems();
+
+	/* Adds Amount to the carried ammo of AmmoType */
+	void AddAmmo(EAmmoType AmmoType, int32 Amount);
+
+	/* Sets the carried ammo of AmmoType */
+	void SetAmmo(EAmmoType AmmoType, int32 Amount);
+
+	/* Removes up to Amount of AmmoType and returns how much was removed */
+	int32 TakeAmmo(EAmmoType AmmoType, int32 Amount);
+
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	AItem* GetItemAt(int32 Slot) const;
+
+	/* Lowest empty slot or INDEX_NONE if full */
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	int32 GetEmptySlot() const;
+
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	int32 GetAmmo(EAmmoType AmmoType) const;
+
+	FORCEINLINE bool IsFull() const { return FreeSlotMask == 0; }
+	FORCEINLINE bool IsValidSlot(int32 Slot) const { return Slots.IsValidIndex(Slot); }
+	FORCEINLINE bool HasAmmo(EAmmoType AmmoType) const { return GetAmmo(AmmoType) > 0; }
+	FORCEINLINE int32 GetCapacity() const { return Slots.Num(); }
+	FORCEINLINE int32 GetNumItems() const { return Slots.Num() - FMath::CountBits(FreeSlotMask); }
+	FORCEINLINE const TArray<AItem*>& GetSlots() const { return Slots; }
+
+private:
+	static int32 GetAmmoIndex(EAmmoType AmmoType);
+
+	void MarkSlot(int32 Slot, bool bOccupied);
+
+	/* Number of item slots, the only place an inventory's size is configured */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true", ClampMin = "1", ClampMax = "32"))
+	int32 Capacity;
+
+	/* Items by slot, nullptr where the slot is empty */
+	UPROPERTY(VisibleInstanceOnly, Transient, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
+	TArray<AItem*> Slots;
+
+	/* Bit i is set while slot i is empty */
+	uint32 FreeSlotMask;
+
+	/* Carried ammo indexed by EAmmoType */
+	int32 AmmoCounts[static_cast<int32>(EAmmoType::EAT_MAX)];
+};
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Engine/DataTable.h"
+#include "Interfaces/PoolableInterface.h"
 #include "Item.generated.h"
 
 class UBoxComponent;
@@ -73,13 +74,15 @@ struct FItemRarityTable : public FTableRowBase
 };
 
 UCLASS()
-class ARCOROX_API AItem : public AActor
+class ARCOROX_API AItem : public AActor, public IPoolableInterface
 {
 	GENERATED_BODY()
 	
 public:	
 	AItem();
 	virtual void Tick(float DeltaTime) override;
+	virtual void OnAcquiredFromPool() override;
+	virtual void OnReleasedToPool() override;
 
 	virtual void EnableCustomDepth();
 	virtual void DisableCustomDepth();
@@ -100,6 +103,9 @@ public:
 	void EnableGlowMaterial();
 	void DisableGlowMaterial();
 
+	/* Scales the pulse curve value by the glow and fresnel amounts and writes it to the dynamic material instance */
+	void ApplyMaterialPulse(const FVector& CurveValue);
+
 	FORCEINLINE EItemState GetItemState() const { return ItemState; }
 	FORCEINLINE USkeletalMeshComponent* GetItemMesh() const { return ItemMesh; }
 	FORCEINLINE UBoxComponent* GetCollisionBox() const { return CollisionBox; }
@@ -112,6 +118,8 @@ public:
 	FORCEINLINE int32 GetInventorySlotIndex() const { return InventorySlotIndex; }
 	FORCEINLINE UMaterialInstance* GetMaterialInstance() const { return MaterialInstance; }
 	FORCEINLINE int32 GetMaterialIndex() const { return MaterialIndex; }
+	FORCEINLINE UCurveVector* GetMaterialPulseCurve() const { return MaterialPulseCurve; }
+	FORCEINLINE float GetMaterialPulseCurveTime() const { return MaterialPulseCurveTime; }
 	FORCEINLINE void SetItemType(EItemType Type) { ItemType = Type; }
 	FORCEINLINE void SetInventorySlotIndex(int32 Index) { InventorySlotIndex = Index; }
 	FORCEINLINE void SetArcoroxCharacter(AArcoroxCharacter* Character) { ArcoroxCharacter = Character; }
@@ -126,6 +134,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	virtual void OnConstruction(const FTransform& Transform) override;
 
@@ -146,14 +155,17 @@ protected:
 	/* Get interpolation location based on item type and interp location index */
 	FVector GetInterpLocation();
 
-	/* Updates dynamic material instance parameters based on pulse vector curve */
+	/* Updates dynamic material instance parameters based on the interp pulse curve while interpolating */
 	void UpdateMaterialPulse();
 
-	/* Starts the Material Pulse Timer */
-	void StartMaterialPulseTimer();
+	/* Does the item currently need to tick (items are dormant by default) */
+	virtual bool ShouldTick() const;
+
+	/* Enables or disables ticking based on ShouldTick() */
+	void RefreshTickEnabled();
 
-	/* Callback for Material Pulse Timer */
-	void ResetMaterialPulseTimer();
+	/* Registers the item with the loot subsystem while it is in the Pickup state */
+	void UpdateLootRegistration();
 
 	/* Callback for Sphere Component OnComponentBeginOverlap */
 	UFUNCTION()
@@ -260,7 +272,7 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	UCurveVector* MaterialPulseInterpCurve;
 
-	/* Duration of material pulse timer */
+	/* Period of the material pulse curve while in the Pickup state */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	float MaterialPulseCurveTime;
 
@@ -316,9 +328,6 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Rarity", meta = (AllowPrivateAccess = "true"))
 	UTexture2D* BackgroundIcon;
 
-	/* Timer for dynamic material pulse curve */
-	FTimerHandle MaterialPulseTimer;
-
 	/* For interpolating item in X and Y directions */
 	float ItemInterpX;
 	float ItemInterpY;
@@ -332,4 +341,15 @@ private:
 	/* To enable and disable outline effect while interpolating */
 	bool bCanChangeCustomDepth;
 
+	/* Is the item registered with the loot subsystem */
+	bool bRegisteredAsPickup;
+
+	/* Is the item counted in the ticking items stat */
+	bool bCountedAsTicking;
+
+	/* Cached indices of the pulse parameters in the dynamic material instance, INDEX_NONE if the material lacks them */
+	int32 GlowAmountParameterIndex;
+	int32 FresnelExponentParameterIndex;
+	int32 FresnelReflectFractionParameterIndex;
+
 };
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Items/WeaponType.h"
+#include "Combat/CrosshairSpreadProfile.h"
+#include "ItemDataSubsystem.generated.h"
+
+class UDataTable;
+struct FItemRarityTable;
+struct FWeaponTypeTable;
+enum class EItemRarity : uint8;
+
+/**
+ * Loads the Item Rarity and Weapon Type Data Tables once per game instance and
+ * keeps their rows in flat arrays indexed by EItemRarity / EWeaponType.
+ */
+UCLASS()
+class ARCOROX_API UItemDataSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/* Returns the row cache for the game instance of WorldContextObject, nullptr in editor worlds or when Arcorox.Items.UseDataCache is 0 */
+	static const UItemDataSubsystem* GetRowCache(const UObject* WorldContextObject);
+
+	/* Loads the Data Tables directly, for when there is no row cache */
+	static UDataTable* LoadItemRarityDataTable();
+	static UDataTable* LoadWeaponTypeDataTable();
+
+	/* Data Table row names for each enum value */
+	static FName GetItemRarityRowName(EItemRarity Rarity);
+	static FName GetWeaponTypeRowName(EWeaponType Type);
+
+	const FItemRarityTable* GetItemRarityRow(EItemRarity Rarity) const;
+	const FWeaponTypeTable* GetWeaponTypeRow(EWeaponType Type) const;
+
+	/* Crosshair spread profile of a weapon type, baked at load */
+	const FBakedCrosshairSpread* GetCrosshairSpread(EWeaponType Type) const;
+
+private:
+	/* Item Rarity Data Table */
+	UPROPERTY()
+	UDataTable* ItemRarityDataTable;
+
+	/* Weapon Type Data Table */
+	UPROPERTY()
+	UDataTable* WeaponTypeDataTable;
+
+	/* Item Rarity rows indexed by EItemRarity */
+	TArray<const FItemRarityTable*> ItemRarityRows;
+
+	/* Weapon Type rows indexed by EWeaponType */
+	TArray<const FWeaponTypeTable*> WeaponTypeRows;
+
+	/* Baked crosshair spread profiles indexed by EWeaponType */
+	TArray<FBakedCrosshairSpread> CrosshairSpreads;
+};
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LootSubsystem.generated.h"
+
+class AItem;
+class UCurveVector;
+
+/**
+ * Central updater for items lying in the world in the Pickup state.
+ * Items do not tick while waiting to be picked up, their material pulse is updated from here only while they are on screen.
+ * All pickup items share one pulse clock, so each pulse curve is evaluated once per frame no matter how much loot is lying around.
+ */
+UCLASS()
+class ARCOROX_API ULootSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterPickupItem(AItem* Item);
+	void UnregisterPickupItem(AItem* Item);
+
+private:
+	/* Pulse curve value for one curve and period, evaluated once per frame */
+	struct FEvaluatedPulse
+	{
+		const UCurveVector* Curve;
+		float Period;
+		FVector Value;
+	};
+
+	/* Returns the value of Curve at the shared pulse clock wrapped to Period, evaluating it at most once per frame */
+	const FVector& EvaluatePulse(const UCurveVector* Curve, float Period);
+
+	/* Items currently in the Pickup state */
+	UPROPERTY()
+	TArray<AItem*> PickupItems;
+
+	/* How recently an item must have been rendered for its material pulse to be updated */
+	float PulseVisibilityTolerance = 0.2f;
+
+	/* Shared clock driving the material pulse of every pickup item */
+	double PulseClock = 0.0;
+
+	/* Pulse curves evaluated this frame, there are only a handful of unique curves so a linear search is fine */
+	TArray<FEvaluatedPulse, TInlineAllocator<8>> EvaluatedPulses;
+};
@@ -7,6 +7,7 @@
 #include "Items/AmmoType.h"
 #include "Items/WeaponType.h"
 #include "Engine/DataTable.h"
+#include "Combat/CrosshairSpreadProfile.h"
 #include "Weapon.generated.h"
 
 class UParticleSystem;
@@ -26,25 +27,25 @@ struct FWeaponTypeTable : public FTableRowBase
 	int32 MagazineCapacity;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USoundBase* PickupSound;
+	TSoftObjectPtr<USoundBase> PickupSound;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USoundBase* EquipSound;
+	TSoftObjectPtr<USoundBase> EquipSound;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USkeletalMesh* WeaponMesh;
+	TSoftObjectPtr<USkeletalMesh> WeaponMesh;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FString WeaponName;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* InventoryIcon;
+	TSoftObjectPtr<UTexture2D> InventoryIcon;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* AmmoIcon;
+	TSoftObjectPtr<UTexture2D> AmmoIcon;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UMaterialInstance* MaterialInstance;
+	TSoftObjectPtr<UMaterialInstance> MaterialInstance;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int32 MaterialIndex;
@@ -56,31 +57,39 @@ struct FWeaponTypeTable : public FTableRowBase
 	FName ReloadMontageSection;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	TSubclassOf<UAnimInstance> AnimationBlueprint;
+	TSoftClassPtr<UAnimInstance> AnimationBlueprint;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* TopCrosshair;
+	TSoftObjectPtr<UTexture2D> TopCrosshair;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* BottomCrosshair;
+	TSoftObjectPtr<UTexture2D> BottomCrosshair;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* MidCrosshair;
+	TSoftObjectPtr<UTexture2D> MidCrosshair;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* LeftCrosshair;
+	TSoftObjectPtr<UTexture2D> LeftCrosshair;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* RightCrosshair;
+	TSoftObjectPtr<UTexture2D> RightCrosshair;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float FireRate;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UParticleSystem* MuzzleFlash;
+	TSoftObjectPtr<UParticleSystem> MuzzleFlash;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USoundBase* FireSound;
+	TSoftObjectPtr<USoundBase> FireSound;
+
+	/* Optional looping sound for automatic fire, FireSound is played per shot when not set */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSoftObjectPtr<USoundBase> FireLoopSound;
+
+	/* Optional sound played when the fire loop stops */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSoftObjectPtr<USoundBase> FireLoopTailSound;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FName BoneToHide;
@@ -93,6 +102,13 @@ struct FWeaponTypeTable : public FTableRowBase
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float HeadshotMultiplier;
+
+	/* Crosshair spread tuning, baked into a lookup table when the table is loaded */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FCrosshairSpreadProfile CrosshairSpreadProfile;
+
+	/* Appends the paths of every asset the row references, the bundle streamed in for weapons of this type */
+	void GetAssetPaths(TArray<FSoftObjectPath>& OutPaths) const;
 };
 
 UCLASS()
@@ -103,6 +119,12 @@ class ARCOROX_API AWeapon : public AItem
 public:
 	AWeapon();
 	virtual void Tick(float DeltaTime) override;
+	virtual void OnAcquiredFromPool() override;
+	virtual void OnReleasedToPool() override;
+
+	/* Sets the meshes, sounds, icons and effects from the Weapon Type Data Table row, bStreamedIn when they finished loading after construction */
+	void ApplyWeaponAssets(bool bStreamedIn);
+
 
 	/* Adds impulse force to weapon */
 	void ThrowWeapon();
@@ -116,8 +138,8 @@ public:
 	/* Is the gun magazine full */
 	bool FullMagazine();
 
-	/* Starts the timer for displacing the pistol slide */
-	void StartPistolSlideTimer();
+	/* Starts displacing the pistol slide from the world time the round was fired */
+	void StartPistolSlide(double StartTime);
 
 	FORCEINLINE int32 GetAmmo() const { return Ammo; }
 	FORCEINLINE int32 GetMagazineCapacity() const { return MagazineCapacity; }
@@ -128,19 +150,39 @@ public:
 	FORCEINLINE float GetFireRate() const { return FireRate; }
 	FORCEINLINE UParticleSystem* GetMuzzleFlash() const { return MuzzleFlash; }
 	FORCEINLINE USoundBase* GetFireSound() const { return FireSound; }
+	FORCEINLINE USoundBase* GetFireLoopSound() const { return FireLoopSound; }
+	FORCEINLINE USoundBase* GetFireLoopTailSound() const { return FireLoopTailSound; }
 	FORCEINLINE bool IsWeaponAutomatic() const { return bAutomaticWeapon; }
 	FORCEINLINE float GetDamage() const { return Damage; }
 	FORCEINLINE float GetHeadshotMultiplier() const { return HeadshotMultiplier; }
+	FORCEINLINE const FBakedCrosshairSpread& GetCrosshairSpread() const { return CrosshairSpread; }
+	/* False while the asset bundle is still streaming, the weapon can be equipped but not fired until then */
+	FORCEINLINE bool HasWeaponAssets() const { return bWeaponAssetsApplied; }
 	FORCEINLINE void SetMovingClip(bool Moving) { bMovingClip = Moving; }
 
 protected:
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void OnConstruction(const FTransform& Transform) override;
 
 	void GetWeaponTypeDataTableInfo();
 
-	void SetDataTableProperties(FWeaponTypeTable* WeaponTypeRow);
+	void SetDataTableProperties(const FWeaponTypeTable* WeaponTypeRow);
+
+	const FWeaponTypeTable* FindWeaponTypeRow() const;
+
+	/* Holds the asset bundle of WeaponType, or loads the assets synchronously when weapon assets are not streamed */
+	void RequestWeaponAssets();
+
+	void ReleaseWeaponAssets();
+
+	/* Clears the material slot in use and moves the glow material to NewMaterialIndex */
+	void SwapMaterialSlot(int32 NewMaterialIndex);
+
+	/* Weapons also tick while falling and while the pistol slide is being displaced */
+	virtual bool ShouldTick() const override;
 
 	void StopFalling();
 
@@ -210,6 +252,9 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
 	UTexture2D* RightCrosshair;
 
+	/* Crosshair spread profile of the weapon type, baked from the Weapon Type Data Table */
+	FBakedCrosshairSpread CrosshairSpread;
+
 	/* Automatic fire rate for weapon */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
 	float FireRate;
@@ -222,6 +267,14 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
 	USoundBase* FireSound;
 
+	/* Looping sound for automatic fire */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
+	USoundBase* FireLoopSound;
+
+	/* Sound played when the automatic fire loop stops */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
+	USoundBase* FireLoopTailSound;
+
 	/* Bone to hide on SMG weapon skeletal mesh (for SMG & pistol) */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
 	FName BoneToHide;
@@ -254,11 +307,19 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Pistol, meta = (AllowPrivateAccess = "true"))
 	float PistolRecoilRotation;
 
-	/* Timer for displacing pistol slide */
-	FTimerHandle PistolSlideTimer;
+	/* World time the current pistol slide displacement started */
+	double PistolSlideStartTime;
 
 	int32 PreviousMaterialIndex;
 
+	/* Weapon type whose asset bundle this weapon holds in UWeaponAssetSubsystem */
+	EWeaponType HeldAssetType;
+	bool bHoldingWeaponAssets;
+	bool bWeaponAssetsApplied;
+
+	/* Assets streamed in while the weapon was held, the glow material is rebuilt once it is dropped */
+	bool bMaterialRebuildPending;
+
 	FTimerHandle ThrowWeaponTimer;
 	float ThrowWeaponTime;
 	bool bIsFalling;
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "Items/WeaponType.h"
+#include "WeaponAssetSubsystem.generated.h"
+
+class AWeapon;
+
+/**
+ * Streams the meshes, sounds, icons and effects of each weapon type in on demand.
+ * The Weapon Type Data Table only holds soft references, so nothing is loaded with it. A weapon type's bundle
+ * is loaded asynchronously when the first weapon of that type requests it and released when the last one lets go.
+ */
+UCLASS()
+class ARCOROX_API UWeaponAssetSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/* Returns the streaming manager for the game instance of WorldContextObject, nullptr in editor worlds or when Arcorox.Items.StreamWeaponAssets is 0 */
+	static UWeaponAssetSubsystem* Get(const UObject* WorldContextObject);
+
+	/* Holds Weapon's bundle, calling Weapon->ApplyWeaponAssets now if it is loaded or once it finishes loading */
+	void RequestAssets(AWeapon* Weapon);
+
+	/* Lets go of Weapon's request for Type's bundle, unloading it once no weapons of that type remain */
+	void ReleaseAssets(AWeapon* Weapon, EWeaponType Type);
+
+	int32 GetNumRequests(EWeaponType Type) const;
+	bool IsResident(EWeaponType Type) const;
+
+	/* Logs the state of every bundle and the resident memory of the process */
+	void LogReport() const;
+
+private:
+	struct FWeaponAssetBundle
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		/* Weapons waiting for the bundle to finish loading */
+		TArray<TWeakObjectPtr<AWeapon>> Waiting;
+		int32 NumRequests = 0;
+		int32 NumAssets = 0;
+		double RequestTime = 0.0;
+		/* Seconds from the request until the bundle was resident */
+		double LoadTime = 0.0;
+		bool bLoaded = false;
+	};
+
+	void OnBundleLoaded(EWeaponType Type);
+
+	FStreamableManager StreamableManager;
+
+	/* Bundles indexed by EWeaponType */
+	TArray<FWeaponAssetBundle> Bundles;
+};
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ActorPoolSubsystem.generated.h"
+
+/* Free actors of one class */
+USTRUCT()
+struct FActorPoolList
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AActor*> Actors;
+};
+
+/**
+ * Recycles actors implementing IPoolableInterface instead of spawning and destroying them.
+ * Released actors are hidden, have collision and ticking disabled and wait in a free list per class.
+ * Only classes that something acquires from the pool are kept, released actors of any other class are destroyed
+ * so free lists never fill up with actors nothing will reuse.
+ */
+UCLASS()
+class ARCOROX_API UActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/* Takes a free actor of exactly Class from the pool, spawning a new one if there is none */
+	AActor* AcquireActor(UClass* Class, const FTransform& Transform);
+
+	/* Puts a poolable actor back into the pool, actors that are not poolable, never acquired from the pool or do not fit are destroyed */
+	void ReleaseActor(AActor* Actor);
+
+	/* Acquires from the pool of World, or spawns directly if pooling is unavailable */
+	static AActor* AcquireOrSpawn(UWorld* World, UClass* Class, const FTransform& Transform);
+
+	template<class T>
+	static T* AcquireOrSpawn(UWorld* World, TSubclassOf<T> Class, const FTransform& Transform = FTransform::Identity)
+	{
+		return Cast<T>(AcquireOrSpawn(World, *Class, Transform));
+	}
+
+	/* Releases Actor to the pool of its world, or destroys it if pooling is unavailable */
+	static void ReleaseOrDestroy(AActor* Actor);
+
+	/* AcquireOrSpawn for Blueprint spawners, use in place of Spawn Actor for poolable classes */
+	UFUNCTION(BlueprintCallable, Category = Pooling, meta = (WorldContext = "WorldContextObject", DeterminesOutputType = "Class"))
+	static AActor* AcquirePooledActor(const UObject* WorldContextObject, TSubclassOf<AActor> Class, const FTransform& Transform);
+
+	/* ReleaseOrDestroy for Blueprints, use in place of Destroy Actor for actors from AcquirePooledActor */
+	UFUNCTION(BlueprintCallable, Category = Pooling)
+	static void ReleasePooledActor(AActor* Actor);
+
+	/* Number of free actors across all classes */
+	int32 GetNumFreeActors() const;
+
+private:
+	/* Free actors per class */
+	UPROPERTY()
+	TMap<UClass*, FActorPoolList> FreeActors;
+
+	/* Classes acquired from the pool at least once */
+	UPROPERTY()
+	TSet<UClass*> AcquiredClasses;
+};
@@ -0,0 +1,17 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using System.IO;
+using UnrealBuildTool;
+
+public class ArcoroxTests : ModuleRules
+{
+	public ArcoroxTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "AIModule", "GameplayTasks", "Arcorox" });
+
+		// Shares the test world helper of the game module's own tests
+		PrivateIncludePaths.Add(Path.Combine(ModuleDirectory, "..", "Arcorox", "Private"));
+	}
+}
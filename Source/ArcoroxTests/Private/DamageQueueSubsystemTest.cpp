@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ArcoroxTestWorld.h"
+#include "DamageRecorderActor.h"
+#include "Combat/DamageQueueSubsystem.h"
+#include "AIController.h"
+#include "HAL/IConsoleManager.h"
+#include "Algo/Reverse.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDamageQueueResolveTest, "Arcorox.Combat.DamageQueue.Resolve",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FDamageQueueResolveTest::RunTest(const FString& Parameters)
+{
+	IConsoleVariable* QueueEnabled = IConsoleManager::Get().FindConsoleVariable(TEXT("Arcorox.Combat.DamageQueue.Enabled"));
+	if (!TestNotNull(TEXT("Arcorox.Combat.DamageQueue.Enabled exists"), QueueEnabled)) return false;
+	const int32 PreviousEnabled = QueueEnabled->GetInt();
+	QueueEnabled->Set(1, ECVF_SetByCode);
+
+	FArcoroxTestWorld TestWorld;
+	UWorld* World = TestWorld.Get();
+	UDamageQueueSubsystem* DamageQueue = World->GetSubsystem<UDamageQueueSubsystem>();
+	if (!TestNotNull(TEXT("Damage queue subsystem"), DamageQueue)) return false;
+	TArray<FRecordedDamage> Log;
+	auto SpawnRecorder = [World, &Log]()
+	{
+		ADamageRecorderActor* Recorder = World->SpawnActor<ADamageRecorderActor>();
+		Recorder->Log = &Log;
+		return Recorder;
+	};
+	AController* FirstInstigator = World->SpawnActor<AAIController>();
+	AController* SecondInstigator = World->SpawnActor<AAIController>();
+
+	//Runs the same hits in queue order against targets spawned in the given order, so only their addresses differ between runs
+	auto ResolveHits = [&](bool bReverseSpawnOrder)
+	{
+		TArray<ADamageRecorderActor*> Targets;
+		for (int32 i = 0; i < 3; i++) Targets.Add(SpawnRecorder());
+		if (bReverseSpawnOrder) Algo::Reverse(Targets);
+		Log.Reset();
+		UDamageQueueSubsystem::QueueDamage(World, Targets[0], 5.f, FirstInstigator, nullptr, FVector::ZeroVector);
+		UDamageQueueSubsystem::QueueDamage(World, Targets[1], 3.f, FirstInstigator, nullptr, FVector::ZeroVector);
+		UDamageQueueSubsystem::QueueDamage(World, Targets[0], 2.f, FirstInstigator, nullptr, FVector::ZeroVector);
+		UDamageQueueSubsystem::QueueDamage(World, Targets[2], 1.f, FirstInstigator, nullptr, FVector::ZeroVector);
+		UDamageQueueSubsystem::QueueDamage(World, Targets[1], 4.f, FirstInstigator, nullptr, FVector::ZeroVector);
+		UDamageQueueSubsystem::QueueDamage(World, Targets[0], 7.f, SecondInstigator, nullptr, FVector::ZeroVector);
+		TestEqual(TEXT("Hits wait for the resolve"), Log.Num(), 0);
+		DamageQueue->ResolveQueue();
+
+		//One TakeDamage per target and instigator, in the order of their first hit
+		const FRecordedDamage Expected[] =
+		{
+			{ Targets[0], FirstInstigator, 7.f },
+			{ Targets[1], FirstInstigator, 7.f },
+			{ Targets[2], FirstInstigator, 1.f },
+			{ Targets[0], SecondInstigator, 7.f },
+		};
+		if (TestEqual(TEXT("Damage groups"), Log.Num(), static_cast<int32>(UE_ARRAY_COUNT(Expected))))
+		{
+			for (int32 i = 0; i < Log.Num(); i++)
+			{
+				TestTrue(FString::Printf(TEXT("Group %d target"), i), Log[i].Target == Expected[i].Target);
+				TestTrue(FString::Printf(TEXT("Group %d instigator"), i), Log[i].Instigator == Expected[i].Instigator);
+				TestEqual(FString::Printf(TEXT("Group %d amount"), i), Log[i].Amount, Expected[i].Amount);
+			}
+		}
+		for (ADamageRecorderActor* Target : Targets) Target->Destroy();
+	};
+	ResolveHits(false);
+	ResolveHits(true);
+
+	//Destroyed targets are skipped
+	ADamageRecorderActor* DestroyedTarget = SpawnRecorder();
+	ADamageRecorderActor* LiveTarget = SpawnRecorder();
+	Log.Reset();
+	UDamageQueueSubsystem::QueueDamage(World, DestroyedTarget, 1.f, nullptr, nullptr, FVector::ZeroVector);
+	UDamageQueueSubsystem::QueueDamage(World, LiveTarget, 1.f, nullptr, nullptr, FVector::ZeroVector);
+	DestroyedTarget->Destroy();
+	DamageQueue->ResolveQueue();
+	TestEqual(TEXT("Only the live target is damaged"), Log.Num(), 1);
+
+	//Hits caused while resolving wait for the next resolve
+	LiveTarget->DamageToQueueOnHit = 1.f;
+	Log.Reset();
+	UDamageQueueSubsystem::QueueDamage(World, LiveTarget, 2.f, nullptr, nullptr, FVector::ZeroVector);
+	DamageQueue->ResolveQueue();
+	TestEqual(TEXT("Resolve applies the queued hit"), Log.Num(), 1);
+	TestEqual(TEXT("Hit caused while resolving is queued"), DamageQueue->GetNumQueued(), 1);
+	LiveTarget->DamageToQueueOnHit = 0.f;
+	DamageQueue->ResolveQueue();
+	TestEqual(TEXT("Next resolve applies it"), Log.Num(), 2);
+
+	//Disabled, hits are applied right away
+	QueueEnabled->Set(0, ECVF_SetByCode);
+	Log.Reset();
+	UDamageQueueSubsystem::QueueDamage(World, LiveTarget, 3.f, nullptr, nullptr, FVector::ZeroVector);
+	TestEqual(TEXT("Immediate hit"), Log.Num(), 1);
+	TestEqual(TEXT("Nothing queued when disabled"), DamageQueue->GetNumQueued(), 0);
+
+	QueueEnabled->Set(PreviousEnabled, ECVF_SetByCode);
+	return true;
+}
+
+#endif
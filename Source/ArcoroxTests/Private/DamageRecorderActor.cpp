@@ -0,0 +1,12 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DamageRecorderActor.h"
+#include "Combat/DamageQueueSubsystem.h"
+
+float ADamageRecorderActor::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
+{
+	if (Log) Log->Add(FRecordedDamage{ this, EventInstigator, DamageAmount });
+	if (DamageToQueueOnHit > 0.f) UDamageQueueSubsystem::QueueDamage(this, this, DamageToQueueOnHit, nullptr, nullptr, GetActorLocation());
+	return DamageAmount;
+}
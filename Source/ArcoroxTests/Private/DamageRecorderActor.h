@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "DamageRecorderActor.generated.h"
+
+class ADamageRecorderActor;
+
+/* One TakeDamage call seen by a damage recorder */
+struct FRecordedDamage
+{
+	const ADamageRecorderActor* Target;
+	const AController* Instigator;
+	float Amount;
+};
+
+/* Actor used by the damage automation tests, appends every TakeDamage call to a shared log */
+UCLASS(NotPlaceable, Transient, HideDropdown)
+class ADamageRecorderActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	virtual float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, AActor* DamageCauser) override;
+
+	/* Log shared by the recorders of a test */
+	TArray<FRecordedDamage>* Log = nullptr;
+
+	/* Damage this recorder queues on itself while being damaged, 0 for none */
+	float DamageToQueueOnHit = 0.f;
+};
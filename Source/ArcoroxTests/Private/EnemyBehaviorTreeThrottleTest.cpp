@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ArcoroxTestWorld.h"
+#include "TickCountingTask.h"
+#include "Enemy/EnemyController.h"
+#include "Enemy/EnemyBehaviorTreeComponent.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/Composites/BTComposite_Sequence.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnemyBehaviorTreeThrottleTest, "Arcorox.Enemy.BehaviorTreeThrottle",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FEnemyBehaviorTreeThrottleTest::RunTest(const FString& Parameters)
+{
+	//A sequence running one task that asks for a tick every frame, so the throttle is the only thing slowing the tree down
+	UBehaviorTree* BehaviorTree = NewObject<UBehaviorTree>(GetTransientPackage());
+	UBTComposite_Sequence* Root = NewObject<UBTComposite_Sequence>(BehaviorTree);
+	UTickCountingTask* Task = NewObject<UTickCountingTask>(BehaviorTree);
+	FBTCompositeChild Child;
+	Child.ChildTask = Task;
+	Root->Children.Add(Child);
+	BehaviorTree->RootNode = Root;
+
+	FArcoroxTestWorld TestWorld;
+	AEnemyController* EnemyController = TestWorld.Get()->SpawnActor<AEnemyController>();
+	if (!TestNotNull(TEXT("Enemy controller"), EnemyController)) return false;
+	UEnemyBehaviorTreeComponent* BehaviorTreeComponent = Cast<UEnemyBehaviorTreeComponent>(EnemyController->GetBehaviorTreeComponent());
+	if (!TestNotNull(TEXT("Throttled behavior tree component"), BehaviorTreeComponent)) return false;
+	if (!TestTrue(TEXT("Behavior tree started"), EnemyController->RunBehaviorTree(BehaviorTree))) return false;
+	TestTrue(TEXT("Tree runs on the throttled component"), EnemyController->GetBrainComponent() == BehaviorTreeComponent);
+
+	//Intervals of the significance buckets, each held for two seconds at 60 fps
+	const float FrameTime = 1.f / 60.f;
+	const int32 Frames = 120;
+	const float Intervals[] = { 0.f, 0.1f, 0.25f, 0.5f, 0.f };
+	for (const float Interval : Intervals)
+	{
+		BehaviorTreeComponent->SetThrottleInterval(Interval);
+		TestWorld.Tick(FrameTime);
+		Task->ResetCount();
+		for (int32 Frame = 0; Frame < Frames; Frame++) TestWorld.Tick(FrameTime);
+
+		const float Seconds = Frames * FrameTime;
+		const int32 ExpectedTicks = Interval > 0.f ? FMath::RoundToInt32(Seconds / Interval) : Frames;
+		TestTrue(FString::Printf(TEXT("%.2fs interval: %d tree ticks, expected %d"), Interval, Task->NumTicks, ExpectedTicks), FMath::Abs(Task->NumTicks - ExpectedTicks) <= 1);
+		//Skipped frames are handed to the tree, so its tasks still see all of the elapsed time
+		TestEqual(FString::Printf(TEXT("%.2fs interval: time seen by the task"), Interval), Task->TickedSeconds, Seconds, FMath::Max(Interval, FrameTime) + KINDA_SMALL_NUMBER);
+	}
+
+	BehaviorTreeComponent->StopTree();
+	return true;
+}
+
+#endif
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TickCountingTask.h"
+
+UTickCountingTask::UTickCountingTask()
+{
+	NodeName = TEXT("Count Ticks");
+	bNotifyTick = true;
+}
+
+EBTNodeResult::Type UTickCountingTask::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	return EBTNodeResult::InProgress;
+}
+
+void UTickCountingTask::ResetCount()
+{
+	NumTicks = 0;
+	TickedSeconds = 0.f;
+}
+
+void UTickCountingTask::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	NumTicks++;
+	TickedSeconds += DeltaSeconds;
+}
@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "TickCountingTask.generated.h"
+
+/* Task used by the behavior tree automation tests, never finishes and counts every tick the tree gives it */
+UCLASS(NotBlueprintable, HideDropdown)
+class UTickCountingTask : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UTickCountingTask();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+
+	void ResetCount();
+
+	int32 NumTicks = 0;
+
+	/* Sum of the delta times of the counted ticks */
+	float TickedSeconds = 0.f;
+
+protected:
+	virtual void TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+};